@@ -0,0 +1,148 @@
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <random>
+
+#include <wx/init.h>
+#include <draw/bitmap.h>
+#include <draw/png.h>
+#include <draw/integral_image.h>
+
+
+using namespace draw;
+
+
+static tau::RgbPixels<uint8_t> MakeRgbPixels(
+    Eigen::Index rows,
+    Eigen::Index columns)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> value(0, 255);
+
+    std::vector<uint8_t> data(static_cast<size_t>(rows * columns * 3));
+
+    for (auto &byte: data)
+    {
+        byte = static_cast<uint8_t>(value(generator));
+    }
+
+    tau::Size<Eigen::Index> size{};
+    size.width = columns;
+    size.height = rows;
+
+    return tau::RgbPixels<uint8_t>::Create(size, data.data());
+}
+
+
+static std::string GetPngFileName(benchmark::State &state)
+{
+    auto path = std::filesystem::temp_directory_path()
+        / ("draw_benchmark_" + std::to_string(state.range(1)) + ".png");
+
+    return path.string();
+}
+
+
+// Arguments are the rows and columns of the image.
+static void WriteRgbPng(benchmark::State &state)
+{
+    auto pixels = MakeRgbPixels(state.range(0), state.range(1));
+    auto fileName = GetPngFileName(state);
+
+    for (auto _: state)
+    {
+        WritePng(fileName, pixels);
+    }
+
+    std::filesystem::remove(fileName);
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+static void ReadRgbPng(benchmark::State &state)
+{
+    auto fileName = GetPngFileName(state);
+    WritePng(fileName, MakeRgbPixels(state.range(0), state.range(1)));
+
+    for (auto _: state)
+    {
+        auto planarRgb = ReadPng(fileName);
+        benchmark::DoNotOptimize(planarRgb);
+    }
+
+    std::filesystem::remove(fileName);
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+static void GetMonoImageFromBitmap(benchmark::State &state)
+{
+    // wxBitmap needs an initialized toolkit, but not a running application.
+    wxInitializer initializer;
+
+    if (!initializer.IsOk())
+    {
+        state.SkipWithError("Unable to initialize wxWidgets");
+
+        return;
+    }
+
+    auto bitmap = GetBitmap(MakeRgbPixels(state.range(0), state.range(1)));
+
+    for (auto _: state)
+    {
+        auto mono = GetMonoImage(bitmap, 1023);
+        benchmark::DoNotOptimize(mono.data());
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+// Arguments are the rows and columns of the image.
+static void BuildIntegralImage(benchmark::State &state)
+{
+    auto pixels = MakeRgbPixels(state.range(0), state.range(1));
+
+    for (auto _: state)
+    {
+        IntegralImage integral(pixels);
+        benchmark::DoNotOptimize(integral);
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+// Arguments are the rows and columns of the image. Measures an ellipse that
+// covers a quarter of the image.
+static void MeasureEllipse(benchmark::State &state)
+{
+    IntegralImage integral(MakeRgbPixels(state.range(0), state.range(1)));
+
+    auto rows = static_cast<double>(state.range(0));
+    auto columns = static_cast<double>(state.range(1));
+
+    EllipseRegion ellipse{
+        {columns / 2.0, rows / 2.0},
+        columns / 4.0,
+        rows / 4.0,
+        30.0};
+
+    for (auto _: state)
+    {
+        auto statistics = integral.GetEllipse(ellipse);
+        benchmark::DoNotOptimize(statistics.sums.data());
+    }
+}
+
+
+BENCHMARK(WriteRgbPng)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(ReadRgbPng)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(GetMonoImageFromBitmap)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(BuildIntegralImage)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(MeasureEllipse)->Args({1080, 1920})->Args({2160, 3840});
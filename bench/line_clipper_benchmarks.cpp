@@ -0,0 +1,84 @@
+#include <benchmark/benchmark.h>
+
+#include <draw/line_clipper.h>
+
+
+using namespace draw;
+
+
+using Line = LineClipper::Line;
+
+
+// A grid of rows and columns, with half of its lines outside of the region.
+static std::vector<Line> MakeGrid(int64_t lineCount)
+{
+    std::vector<Line> result;
+    result.reserve(static_cast<size_t>(lineCount));
+
+    auto spacing = 4000.0 / static_cast<double>(lineCount);
+
+    for (int64_t i = 0; i < lineCount / 2; ++i)
+    {
+        auto position = spacing * static_cast<double>(i);
+
+        result.emplace_back(
+            tau::Point2d<double>(0.0, position),
+            tau::Vector2d<double>(1.0, 0.0));
+
+        result.emplace_back(
+            tau::Point2d<double>(position, 0.0),
+            tau::Vector2d<double>(0.0, 1.0));
+    }
+
+    return result;
+}
+
+
+static const auto region = tau::Region<double>{
+    {tau::Point2d<double>(0.0, 0.0), tau::Size<double>(1920.0, 1080.0)}};
+
+
+// The argument is the number of lines.
+static void IntersectEachLine(benchmark::State &state)
+{
+    auto lines = MakeGrid(state.range(0));
+
+    for (auto _: state)
+    {
+        size_t visible = 0;
+
+        for (auto &line: lines)
+        {
+            auto endPoints = line.Intersect(region);
+
+            if (endPoints)
+            {
+                ++visible;
+                benchmark::DoNotOptimize(endPoints->first);
+            }
+        }
+
+        benchmark::DoNotOptimize(visible);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+static void ClipLines(benchmark::State &state)
+{
+    LineClipper clipper(MakeGrid(state.range(0)));
+    ClippedLines clipped;
+
+    for (auto _: state)
+    {
+        clipper.Clip(region, &clipped);
+        benchmark::DoNotOptimize(clipped.startX.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+BENCHMARK(IntersectEachLine)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(ClipLines)->Arg(1'000)->Arg(10'000)->Arg(100'000);
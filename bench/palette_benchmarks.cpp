@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <tau/color_map.h>
+#include <draw/palette.h>
+
+
+using namespace draw;
+
+
+class PaletteInput
+{
+public:
+    PaletteInput(Eigen::Index rows, Eigen::Index columns)
+        :
+        colors(128, 3),
+        indices(rows, columns)
+    {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<int> color(0, 255);
+        std::uniform_int_distribution<int> index(0, 127);
+
+        for (Eigen::Index i = 0; i < this->colors.size(); ++i)
+        {
+            this->colors.data()[i] = static_cast<uint8_t>(color(generator));
+        }
+
+        for (Eigen::Index i = 0; i < this->indices.size(); ++i)
+        {
+            this->indices.data()[i] = static_cast<uint16_t>(index(generator));
+        }
+    }
+
+    PixelMatrix colors;
+    Waveform indices;
+};
+
+
+static void MapBasicColorMap(benchmark::State &state)
+{
+    PaletteInput input(state.range(0), state.range(1));
+    tau::BasicColorMap<PixelMatrix> colorMap(input.colors);
+    PixelMatrix output;
+
+    for (auto _: state)
+    {
+        colorMap(input.indices, &output);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.indices.size());
+}
+
+
+static void MapPalette(benchmark::State &state, bool useSimd)
+{
+    PaletteInput input(state.range(0), state.range(1));
+    Palette palette(input.colors);
+    palette.SetUseSimd(useSimd);
+    PixelMatrix output;
+
+    for (auto _: state)
+    {
+        palette.Apply(input.indices, &output);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.indices.size());
+}
+
+
+BENCHMARK(MapBasicColorMap)->Args({480, 640})->Args({1080, 1920});
+
+BENCHMARK_CAPTURE(MapPalette, scalar, false)
+    ->Args({480, 640})->Args({1080, 1920});
+
+BENCHMARK_CAPTURE(MapPalette, simd, true)
+    ->Args({480, 640})->Args({1080, 1920});
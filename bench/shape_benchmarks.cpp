@@ -0,0 +1,202 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <set>
+#include <vector>
+
+#include <draw/ellipse.h>
+#include <draw/oddeven.h>
+#include <draw/polygon.h>
+#include <draw/spline_tessellator.h>
+#include <draw/detail/unique_id.h>
+
+
+using namespace draw;
+
+
+// A star-shaped outline, so that half of the test points fall outside.
+static PointsDouble MakeOutline(size_t pointCount)
+{
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> radius(50.0, 100.0);
+
+    PointsDouble result;
+    result.reserve(pointCount);
+
+    auto step = 2.0 * std::numbers::pi / static_cast<double>(pointCount);
+
+    for (size_t i = 0; i < pointCount; ++i)
+    {
+        auto angle = step * static_cast<double>(i);
+        auto r = radius(generator);
+
+        result.emplace_back(r * std::cos(angle), r * std::sin(angle));
+    }
+
+    return result;
+}
+
+
+static PointsDouble MakeTestPoints(size_t count, double extent)
+{
+    std::mt19937 generator(43);
+    std::uniform_real_distribution<double> coordinate(-extent, extent);
+
+    PointsDouble result;
+    result.reserve(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        result.emplace_back(coordinate(generator), coordinate(generator));
+    }
+
+    return result;
+}
+
+
+static constexpr size_t testPointCount = 64;
+
+
+// The argument is the number of points in the outline.
+static void OddEvenContains(benchmark::State &state)
+{
+    auto outline = MakeOutline(static_cast<size_t>(state.range(0)));
+    auto testPoints = MakeTestPoints(testPointCount, 100.0);
+
+    for (auto _: state)
+    {
+        for (auto &point: testPoints)
+        {
+            benchmark::DoNotOptimize(oddeven::Contains(outline, point));
+        }
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * int64_t(testPointCount));
+}
+
+
+static void PolygonContains(benchmark::State &state)
+{
+    Polygon polygon(MakeOutline(static_cast<size_t>(state.range(0))));
+    auto testPoints = MakeTestPoints(testPointCount, 100.0);
+
+    for (auto _: state)
+    {
+        for (auto &point: testPoints)
+        {
+            benchmark::DoNotOptimize(polygon.Contains(point));
+        }
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * int64_t(testPointCount));
+}
+
+
+// The argument is the number of shapes to hit test, as SelectionBrain does
+// for each click.
+static void EllipseContains(benchmark::State &state)
+{
+    auto count = static_cast<size_t>(state.range(0));
+    auto centers = MakeTestPoints(count, 1000.0);
+
+    std::vector<Ellipse> ellipses(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        ellipses[i].center = centers[i];
+        ellipses[i].major = 40.0;
+        ellipses[i].minor = 20.0;
+        ellipses[i].rotation = static_cast<double>(i % 360) - 180.0;
+    }
+
+    auto clicks = MakeTestPoints(testPointCount, 1000.0);
+
+    for (auto _: state)
+    {
+        for (auto &click: clicks)
+        {
+            // Search from the top, like a click on the canvas.
+            auto found = std::find_if(
+                ellipses.rbegin(),
+                ellipses.rend(),
+                [&click](const Ellipse &ellipse)
+                {
+                    return ellipse.Contains(click);
+                });
+
+            benchmark::DoNotOptimize(found);
+        }
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * int64_t(testPointCount));
+}
+
+
+// The argument is the number of ids already in use. They have no gaps, so
+// each call walks the whole store before it finds a free id.
+static void CreateId(benchmark::State &state)
+{
+    std::set<int64_t> ids;
+
+    for (int64_t i = 0; i < state.range(0); ++i)
+    {
+        ids.insert(i);
+    }
+
+    for (auto _: state)
+    {
+        auto id = detail::CreateUniqueId(ids);
+        benchmark::DoNotOptimize(id);
+
+        state.PauseTiming();
+        ids.erase(id);
+        state.ResumeTiming();
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+// The argument is the number of points in the spline.
+static void GetSplineDerivatives(benchmark::State &state)
+{
+    auto points = MakeOutline(static_cast<size_t>(state.range(0)));
+
+    for (auto _: state)
+    {
+        auto derivatives = GetDerivatives(points);
+        benchmark::DoNotOptimize(derivatives.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+// The argument is the number of points in the spline.
+static void TessellateSpline(benchmark::State &state)
+{
+    auto points = MakeOutline(static_cast<size_t>(state.range(0)));
+    auto derivatives = GetDerivatives(points);
+
+    for (auto _: state)
+    {
+        auto tessellation = TessellateTangentSpline(points, derivatives, 0.25);
+        benchmark::DoNotOptimize(tessellation.points.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+
+BENCHMARK(OddEvenContains)->Arg(10'000)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK(PolygonContains)->Arg(10'000)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK(EllipseContains)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(CreateId)->Arg(1'000)->Arg(10'000)->Arg(100'000);
+BENCHMARK(GetSplineDerivatives)->Arg(10'000)->Arg(100'000)->Arg(1'000'000);
+BENCHMARK(TessellateSpline)->Arg(10'000)->Arg(100'000)->Arg(1'000'000);
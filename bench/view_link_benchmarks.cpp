@@ -0,0 +1,86 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+
+#include <draw/views/view_link.h>
+
+
+using namespace draw;
+
+
+class LinkedViews
+{
+public:
+    LinkedViews(size_t count)
+        :
+        models_(),
+        controls_()
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            this->models_.push_back(std::make_unique<ViewSettingsModel>());
+            this->controls_.emplace_back(*this->models_.back());
+        }
+    }
+
+    const std::vector<ViewSettingsControl> & GetControls() const
+    {
+        return this->controls_;
+    }
+
+    ViewSettingsControl & GetFirst()
+    {
+        return this->controls_.front();
+    }
+
+private:
+    std::vector<std::unique_ptr<ViewSettingsModel>> models_;
+    std::vector<ViewSettingsControl> controls_;
+};
+
+
+static void PanGroup(benchmark::State &state)
+{
+    LinkedViews views(static_cast<size_t>(state.range(0)));
+    ViewLinkGroup group(views.GetControls());
+
+    int x = 0;
+
+    for (auto _: state)
+    {
+        views.GetFirst().viewPosition.x.Set(++x);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+static void PanChain(benchmark::State &state)
+{
+    LinkedViews views(static_cast<size_t>(state.range(0)));
+    auto &controls = views.GetControls();
+
+    // Each view is linked to the next, as views were linked before
+    // ViewLinkGroup.
+    std::vector<std::unique_ptr<ViewLink>> links;
+
+    for (size_t i = 1; i < controls.size(); ++i)
+    {
+        links.push_back(
+            std::make_unique<ViewLink>(controls[i - 1], controls[i]));
+    }
+
+    int x = 0;
+
+    for (auto _: state)
+    {
+        views.GetFirst().viewPosition.x.Set(++x);
+    }
+
+    state.SetItemsProcessed(state.iterations());
+}
+
+
+BENCHMARK(PanGroup)->Arg(2)->Arg(4)->Arg(8)->Arg(12)->Arg(16)->Arg(32);
+BENCHMARK(PanChain)->Arg(2)->Arg(4)->Arg(8)->Arg(12)->Arg(16)->Arg(32);
@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <draw/warp.h>
+
+
+using namespace draw;
+
+
+static std::shared_ptr<Pixels> MakePixels(int width, int height)
+{
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> value(0, 255);
+
+    auto result = Pixels::CreateShared(Size(width, height));
+
+    for (Eigen::Index i = 0; i < result->data.size(); ++i)
+    {
+        result->data.data()[i] = static_cast<uint8_t>(value(generator));
+    }
+
+    return result;
+}
+
+
+// Arguments are the rows and columns of both the frame and the output.
+static void RectifyPixels(
+    benchmark::State &state,
+    Interpolation interpolation)
+{
+    auto width = static_cast<SizeType>(state.range(1));
+    auto height = static_cast<SizeType>(state.range(0));
+    auto frame = MakePixels(width, height);
+
+    // A quad in perspective that covers most of the frame.
+    Quad quad;
+    quad.center.x = width / 2;
+    quad.center.y = height / 2;
+    quad.size = Size(width * 3 / 4, height * 3 / 4);
+    quad.rotation = 10.0;
+    quad.perspective.x = 20.0;
+    quad.perspective.y = -15.0;
+
+    auto homography = MakeRectifyingHomography(quad, Size(width, height));
+
+    for (auto _: state)
+    {
+        auto rectified =
+            Warp(*frame, homography, Size(width, height), interpolation);
+
+        benchmark::DoNotOptimize(rectified->data.data());
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+BENCHMARK_CAPTURE(RectifyPixels, nearest, Interpolation::nearest)
+    ->Args({1080, 1920})->Args({2160, 3840});
+
+BENCHMARK_CAPTURE(RectifyPixels, bilinear, Interpolation::bilinear)
+    ->Args({1080, 1920})->Args({2160, 3840});
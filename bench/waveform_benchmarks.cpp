@@ -0,0 +1,235 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+
+#include <draw/waveform.h>
+#include <draw/waveform_engine.h>
+#include <draw/streaming_waveform.h>
+#include <draw/waveform_persistence.h>
+#include <draw/parade.h>
+#include <draw/density.h>
+
+
+using namespace draw;
+
+
+class RandomWaveformData
+{
+public:
+    RandomWaveformData(Eigen::Index rows, Eigen::Index columns)
+        :
+        data(rows, columns)
+    {
+        std::mt19937 generator(42);
+        std::uniform_int_distribution<int32_t> value(0, 255);
+
+        for (Eigen::Index i = 0; i < this->data.size(); ++i)
+        {
+            this->data.data()[i] = value(generator);
+        }
+    }
+
+    DataMatrix data;
+};
+
+
+// Arguments are the rows and columns of the frame.
+static void GenerateWaveform(benchmark::State &state)
+{
+    RandomWaveformData input(state.range(0), state.range(1));
+    WaveformSettings settings;
+
+    for (auto _: state)
+    {
+        auto waveform = DoGenerateWaveform(
+            input.data,
+            settings.maximumValue,
+            settings.levelCount,
+            settings.columnCount);
+
+        benchmark::DoNotOptimize(waveform.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.data.size());
+}
+
+
+// Arguments are the rows and columns of the frame, which is also the size
+// of the display.
+static void ResizeWaveform(benchmark::State &state)
+{
+    RandomWaveformData input(state.range(0), state.range(1));
+    WaveformSettings settings;
+
+    auto waveform = DoGenerateWaveform(
+        input.data,
+        settings.maximumValue,
+        settings.levelCount,
+        settings.columnCount);
+
+    auto displaySize = Size(
+        static_cast<SizeType>(state.range(1)),
+        static_cast<SizeType>(state.range(0)));
+
+    for (auto _: state)
+    {
+        auto resized = Resize(waveform, displaySize, 1.0);
+        benchmark::DoNotOptimize(resized.data());
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+// The whole pipeline, from data to colored pixels.
+static void FilterWaveform(benchmark::State &state)
+{
+    RandomWaveformData input(state.range(0), state.range(1));
+    WaveformSettings settings;
+    WaveformColormap colormap(settings.color);
+    PixelMatrix output;
+
+    auto displaySize = Size(
+        static_cast<SizeType>(state.range(1)),
+        static_cast<SizeType>(state.range(0)));
+
+    for (auto _: state)
+    {
+        colormap.Filter(settings, displaySize, input.data, nullptr, &output);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.data.size());
+}
+
+
+// Arguments are the rows of each column, and the columns appended at once.
+// The 1920 pixel window has one column of pixels for each column of data.
+static void StreamWaveform(benchmark::State &state)
+{
+    RandomWaveformData input(state.range(0), state.range(1));
+    WaveformSettings settings;
+    settings.columnCount = 1920;
+
+    StreamingWaveform streaming(settings, Size(1920, 1080));
+
+    for (auto _: state)
+    {
+        streaming.Append(input.data);
+        benchmark::DoNotOptimize(streaming.GetPixels().data.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * input.data.size());
+}
+
+
+// Arguments are the rows and columns of the display. Decays the previous
+// frames, adds a histogram, and maps the result to colors.
+static void PersistWaveform(benchmark::State &state)
+{
+    RandomWaveformData input(state.range(0), state.range(1));
+    WaveformSettings settings;
+
+    auto displaySize = Size(
+        static_cast<SizeType>(state.range(1)),
+        static_cast<SizeType>(state.range(0)));
+
+    auto displayed = Resize(
+        DoGenerateWaveform(
+            input.data,
+            settings.maximumValue,
+            settings.levelCount,
+            settings.columnCount),
+        displaySize,
+        1.0);
+
+    WaveformPersistence persistence;
+    PixelMatrix output;
+
+    for (auto _: state)
+    {
+        persistence.Accumulate(displayed);
+        persistence.Render(settings.color, &output);
+        benchmark::DoNotOptimize(output.data());
+    }
+
+    state.SetItemsProcessed(state.iterations() * displayed.size());
+}
+
+
+// Arguments are the rows and columns of an RGB frame. Builds the red, green,
+// blue and luma histograms in one pass.
+static void BuildParade(benchmark::State &state)
+{
+    auto pixels = Pixels::CreateShared(
+        Size(
+            static_cast<SizeType>(state.range(1)),
+            static_cast<SizeType>(state.range(0))));
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> value(0, 255);
+
+    for (Eigen::Index i = 0; i < pixels->data.size(); ++i)
+    {
+        pixels->data.data()[i] = static_cast<uint8_t>(value(generator));
+    }
+
+    ParadeSettings settings;
+
+    for (auto _: state)
+    {
+        auto histograms = draw::GenerateParade(
+            *pixels,
+            settings.levelCount,
+            settings.columnCount,
+            true);
+
+        benchmark::DoNotOptimize(histograms[0].data());
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+// Arguments are the rows and columns of an RGB frame.
+static void Vectorscope(benchmark::State &state)
+{
+    auto pixels = Pixels::CreateShared(
+        Size(
+            static_cast<SizeType>(state.range(1)),
+            static_cast<SizeType>(state.range(0))));
+
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> value(0, 255);
+
+    for (Eigen::Index i = 0; i < pixels->data.size(); ++i)
+    {
+        pixels->data.data()[i] = static_cast<uint8_t>(value(generator));
+    }
+
+    DensitySettings settings;
+
+    for (auto _: state)
+    {
+        auto counts = GenerateVectorscope(
+            *pixels,
+            VectorscopeMode::cbCr,
+            settings.binCount);
+
+        benchmark::DoNotOptimize(counts.data());
+    }
+
+    state.SetItemsProcessed(
+        state.iterations() * state.range(0) * state.range(1));
+}
+
+
+BENCHMARK(GenerateWaveform)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(ResizeWaveform)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(FilterWaveform)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(StreamWaveform)->Args({1080, 4})->Args({1080, 64});
+BENCHMARK(PersistWaveform)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(BuildParade)->Args({1080, 1920})->Args({2160, 3840});
+BENCHMARK(Vectorscope)->Args({1080, 1920})->Args({2160, 3840});
@@ -15,10 +15,20 @@ class DrawConan(ConanFile):
     description = "Drawing tools"
     topics = ("Vector Drawing", "Graphics", "C++")
 
+    # Matches the DRAW_ENABLE_BENCHMARKS CMake option.
+    options = {"enable_benchmarks": [True, False]}
+    default_options = {"enable_benchmarks": False}
+
+    def init(self):
+        base = self.python_requires["boiler"].module.LibraryConanFile
+        self.options.update(base.options, base.default_options)
 
     def build_requirements(self):
         self.test_requires("catch2/2.13.8")
 
+        if self.options.enable_benchmarks:
+            self.test_requires("benchmark/[~1.8]")
+
     def requirements(self):
         self.requires("jive/[>=1.4 <2]", transitive_headers=False)
         self.requires("fields/[>=1.5 <2]", transitive_headers=False)
@@ -1,7 +1,10 @@
 #include "draw/bitmap.h"
 
+#include <cstring>
+
 WXSHIM_PUSH_IGNORES
 #include <wx/image.h>
+#include <wx/rawbmp.h>
 WXSHIM_POP_IGNORES
 
 #include <wxpex/size.h>
@@ -54,4 +57,41 @@ wxBitmap GetBitmap(const tau::RgbPixels<uint8_t> &pixels)
 }
 
 
+static_assert(PackedLayout::red == wxAlphaPixelFormat::RED);
+static_assert(PackedLayout::green == wxAlphaPixelFormat::GREEN);
+static_assert(PackedLayout::blue == wxAlphaPixelFormat::BLUE);
+static_assert(PackedLayout::alpha == wxAlphaPixelFormat::ALPHA);
+
+
+wxBitmap GetBitmap(const PackedPixels &pixels)
+{
+    wxBitmap bitmap(pixels.size.width, pixels.size.height, 32);
+
+    if (!bitmap.IsOk())
+    {
+        return bitmap;
+    }
+
+    wxAlphaPixelData bitmapData(bitmap);
+
+    if (!bitmapData)
+    {
+        return wxBitmap();
+    }
+
+    wxAlphaPixelData::Iterator rowStart(bitmapData);
+    auto rowBytes = static_cast<size_t>(pixels.size.width) * 4;
+
+    // The rows of the bitmap may be padded, or stored from the bottom up, so
+    // each row is copied separately.
+    for (int row = 0; row < pixels.size.height; ++row)
+    {
+        std::memcpy(rowStart.m_ptr, pixels.data.row(row).data(), rowBytes);
+        rowStart.OffsetY(bitmapData, 1);
+    }
+
+    return bitmap;
+}
+
+
 } // end namespace draw
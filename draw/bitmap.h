@@ -4,6 +4,7 @@
 #include <wxpex/wxshim.h>
 #include <tau/color.h>
 #include <tau/mono_image.h>
+#include "draw/packed_pixels.h"
 
 
 WXSHIM_PUSH_IGNORES
@@ -23,5 +24,8 @@ tau::MonoImage<int32_t> GetMonoImage(
 
 wxBitmap GetBitmap(const tau::RgbPixels<uint8_t> &pixels);
 
+// Copies each row into a 32-bit bitmap, without converting the pixels.
+wxBitmap GetBitmap(const PackedPixels &pixels);
+
 
 } // end namespace draw
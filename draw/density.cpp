@@ -0,0 +1,191 @@
+#include "draw/density.h"
+
+#include <algorithm>
+
+#include "draw/palette.h"
+#include "draw/trace.h"
+#include "draw/waveform_engine.h"
+
+
+namespace draw
+{
+
+
+DensityMatrix GenerateVectorscope(
+    const Pixels &pixels,
+    VectorscopeMode mode,
+    size_t binCount)
+{
+    DRAW_TRACE_SCOPE("density.vectorscope");
+
+    const uint8_t *data = pixels.data.data();
+    auto pixelCount = static_cast<Eigen::Index>(pixels.data.rows());
+
+    if (mode == VectorscopeMode::cbCr)
+    {
+        return detail::BinDensity(
+            pixelCount,
+            binCount,
+            [data](Eigen::Index i, float *x, float *y)
+            {
+                auto pixel = data + 3 * i;
+                auto red = static_cast<float>(pixel[0]) / 255.0f;
+                auto green = static_cast<float>(pixel[1]) / 255.0f;
+                auto blue = static_cast<float>(pixel[2]) / 255.0f;
+
+                auto luma =
+                    0.2126f * red + 0.7152f * green + 0.0722f * blue;
+
+                // Cb and Cr are in the range -0.5 to 0.5.
+                *x = (blue - luma) / 1.8556f + 0.5f;
+                *y = (red - luma) / 1.5748f + 0.5f;
+
+                return true;
+            });
+    }
+
+    return detail::BinDensity(
+        pixelCount,
+        binCount,
+        [data](Eigen::Index i, float *x, float *y)
+        {
+            auto pixel = data + 3 * i;
+            auto [low, high] = std::minmax({pixel[0], pixel[1], pixel[2]});
+
+            if (high == 0)
+            {
+                // Black has no hue, and no saturation.
+                *x = 0.0f;
+                *y = 0.0f;
+
+                return true;
+            }
+
+            auto range = static_cast<float>(high - low);
+            float hue = 0.0f;
+
+            if (range > 0.0f)
+            {
+                auto red = static_cast<float>(pixel[0]);
+                auto green = static_cast<float>(pixel[1]);
+                auto blue = static_cast<float>(pixel[2]);
+
+                if (high == pixel[0])
+                {
+                    hue = (green - blue) / range;
+                }
+                else if (high == pixel[1])
+                {
+                    hue = 2.0f + (blue - red) / range;
+                }
+                else
+                {
+                    hue = 4.0f + (red - green) / range;
+                }
+
+                if (hue < 0.0f)
+                {
+                    hue += 6.0f;
+                }
+            }
+
+            *x = hue / 6.0f;
+            *y = range / static_cast<float>(high);
+
+            return true;
+        });
+}
+
+
+void RenderDensity(
+    const DensityMatrix &counts,
+    const DensitySettings &densitySettings,
+    const Size &imageSize,
+    PixelMatrix *output)
+{
+    DRAW_TRACE_SCOPE("density.render");
+
+    auto width = static_cast<Eigen::Index>(imageSize.width);
+    auto height = static_cast<Eigen::Index>(imageSize.height);
+    auto &color = densitySettings.color;
+    Palette palette(MakeWaveformColorRange(color, color.color));
+
+    Waveform indices = Waveform::Zero(height, width);
+
+    if (counts.size() == 0 || width == 0 || height == 0)
+    {
+        palette.Apply(indices, output);
+
+        return;
+    }
+
+    auto maximum = static_cast<float>(counts.maxCoeff());
+    auto lastIndex = static_cast<float>(palette.GetSize() - 1);
+    bool logScale = densitySettings.logScale;
+
+    auto scale = (maximum == 0.0f)
+        ? 0.0f
+        : lastIndex / (logScale ? std::log1p(maximum) : maximum);
+
+    // The palette index of each bin. Any count is at least the first color
+    // above black.
+    Waveform binIndices(counts.rows(), counts.cols());
+
+    for (Eigen::Index i = 0; i < counts.size(); ++i)
+    {
+        auto count = static_cast<float>(counts.data()[i]);
+
+        if (count == 0.0f)
+        {
+            binIndices.data()[i] = 0;
+            continue;
+        }
+
+        auto intensity = logScale ? std::log1p(count) : count;
+
+        binIndices.data()[i] = static_cast<uint16_t>(
+            std::max(std::round(intensity * scale), 1.0f));
+    }
+
+    // Each pixel shows the bin under its center.
+    detail::ParallelBands(
+        height,
+        Eigen::Index{64},
+        [&](Eigen::Index beginRow, Eigen::Index endRow)
+        {
+            for (auto row = beginRow; row < endRow; ++row)
+            {
+                auto binRow = (2 * row + 1) * counts.rows() / (2 * height);
+
+                for (Eigen::Index column = 0; column < width; ++column)
+                {
+                    auto binColumn =
+                        (2 * column + 1) * counts.cols() / (2 * width);
+
+                    indices(row, column) = binIndices(binRow, binColumn);
+                }
+            }
+        });
+
+    palette.Apply(indices, output);
+}
+
+
+std::shared_ptr<Pixels> RenderDensity(
+    const DensityMatrix &counts,
+    const DensitySettings &densitySettings,
+    const Size &imageSize)
+{
+    if (imageSize.width == 0 || imageSize.height == 0)
+    {
+        return {};
+    }
+
+    auto result = Pixels::CreateShared(imageSize);
+    RenderDensity(counts, densitySettings, imageSize, &result->data);
+
+    return result;
+}
+
+
+} // end namespace draw
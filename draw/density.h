@@ -0,0 +1,183 @@
+#pragma once
+
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <tau/eigen.h>
+#include "draw/density_settings.h"
+#include "draw/pixels.h"
+#include "draw/detail/parallel.h"
+
+
+/**
+ ** Two dimensional histograms, like a vectorscope, or the density of a
+ ** scatter plot of two channels of data.
+ **
+ ** Bins are counted on bands of the data in parallel, and drawn through the
+ ** same gradient of colors as the waveform.
+ **/
+
+
+namespace draw
+{
+
+
+// Counts with the highest y in row zero.
+using DensityMatrix =
+    Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+
+// The values at the edges of the histogram. Values outside are not counted.
+struct DensityRange
+{
+    double xMinimum;
+    double xMaximum;
+    double yMinimum;
+    double yMaximum;
+};
+
+
+enum class VectorscopeMode
+{
+    // Rec. 709 blue and red color differences, with neutral in the center.
+    cbCr,
+
+    // Hue from 0 to 360 across, and saturation from 0 to 1 upwards.
+    hueSaturation
+};
+
+
+namespace detail
+{
+
+
+// Fewer points than this are counted on the calling thread.
+static constexpr Eigen::Index minimumDensityBand = 16384;
+
+
+/**
+ ** @param getPoint getPoint(index, &x, &y) sets x and y in the range 0 to 1,
+ ** and returns false for points that are not counted.
+ **/
+template<typename GetPoint>
+DensityMatrix BinDensity(
+    Eigen::Index pointCount,
+    size_t binCount,
+    GetPoint &&getPoint)
+{
+    auto bins = static_cast<Eigen::Index>(binCount);
+    DensityMatrix result = DensityMatrix::Zero(bins, bins);
+
+    if (bins == 0)
+    {
+        return result;
+    }
+
+    auto last = bins - 1;
+    auto scale = static_cast<float>(bins);
+    std::mutex resultMutex;
+
+    ParallelBands(
+        pointCount,
+        minimumDensityBand,
+        [&](Eigen::Index begin, Eigen::Index end)
+        {
+            DensityMatrix counts = DensityMatrix::Zero(bins, bins);
+
+            for (auto i = begin; i < end; ++i)
+            {
+                float x;
+                float y;
+
+                if (!getPoint(i, &x, &y))
+                {
+                    continue;
+                }
+
+                auto column = std::min(
+                    static_cast<Eigen::Index>(x * scale),
+                    last);
+
+                auto row = std::min(
+                    static_cast<Eigen::Index>(y * scale),
+                    last);
+
+                counts(last - row, column) += 1;
+            }
+
+            std::lock_guard lock(resultMutex);
+            result += counts;
+        });
+
+    return result;
+}
+
+
+} // end namespace detail
+
+
+/**
+ ** The density of the points (x(i), y(i)).
+ **
+ ** @param x Any vector or matrix with the same number of values as y.
+ **/
+template<typename X, typename Y>
+DensityMatrix GenerateDensity(
+    const Eigen::DenseBase<X> &x,
+    const Eigen::DenseBase<Y> &y,
+    const DensityRange &range,
+    size_t binCount)
+{
+    assert(x.size() == y.size());
+
+    auto xScale = 1.0 / (range.xMaximum - range.xMinimum);
+    auto yScale = 1.0 / (range.yMaximum - range.yMinimum);
+
+    return detail::BinDensity(
+        x.size(),
+        binCount,
+        [&](Eigen::Index i, float *pointX, float *pointY)
+        {
+            auto u = (static_cast<double>(x(i)) - range.xMinimum) * xScale;
+            auto v = (static_cast<double>(y(i)) - range.yMinimum) * yScale;
+
+            // Also rejects NaN.
+            if (!(u >= 0.0 && u <= 1.0 && v >= 0.0 && v <= 1.0))
+            {
+                return false;
+            }
+
+            *pointX = static_cast<float>(u);
+            *pointY = static_cast<float>(v);
+
+            return true;
+        });
+}
+
+
+DensityMatrix GenerateVectorscope(
+    const Pixels &pixels,
+    VectorscopeMode mode,
+    size_t binCount);
+
+
+// @param output Resized to one row for each pixel of imageSize.
+void RenderDensity(
+    const DensityMatrix &counts,
+    const DensitySettings &densitySettings,
+    const Size &imageSize,
+    PixelMatrix *output);
+
+
+// @return nullptr when the image size is empty.
+std::shared_ptr<Pixels> RenderDensity(
+    const DensityMatrix &counts,
+    const DensitySettings &densitySettings,
+    const Size &imageSize);
+
+
+} // end namespace draw
@@ -0,0 +1,223 @@
+#include "draw/density_generator.h"
+
+#include "draw/error.h"
+
+
+namespace draw
+{
+
+
+DensityGenerator::DensityGenerator(
+    DensityControl densityControl,
+    PixelViewControl pixelViewControl)
+    :
+    mutex_(),
+    densityControl_(densityControl),
+    pixelViewControl_(pixelViewControl),
+
+    densitySettingsEndpoint_(
+        this,
+        densityControl,
+        &DensityGenerator::OnDensitySettings_),
+
+    imageSizeEndpoint_(
+        this,
+        pixelViewControl.canvas.viewSettings.imageSize,
+        &DensityGenerator::OnImageSize_),
+
+    densitySettings_(this->densityControl_.Get()),
+    imageSize_(this->pixelViewControl_.canvas.viewSettings.imageSize),
+
+    isRunning_(true),
+    inputs_(),
+    hasFrameCondition_(),
+    thread_(std::bind(&DensityGenerator::Run_, this))
+{
+
+}
+
+
+DensityGenerator::DensityGenerator(DensityGenerator &&other)
+    :
+    DensityGenerator(
+        std::move(other),
+        pex::WriteLock(other.mutex_))
+{
+
+}
+
+
+DensityGenerator::~DensityGenerator()
+{
+    this->Shutdown();
+}
+
+
+void DensityGenerator::operator()(
+    std::shared_ptr<const Pixels> pixels,
+    VectorscopeMode mode)
+{
+    Input input{};
+    input.pixels = pixels;
+    input.mode = mode;
+
+    this->Push_(std::move(input));
+}
+
+
+void DensityGenerator::operator()(
+    const Eigen::VectorXf &x,
+    const Eigen::VectorXf &y,
+    const DensityRange &range)
+{
+    if (x.size() != y.size())
+    {
+        throw DrawError("x and y must have the same size");
+    }
+
+    Input input{};
+    input.x = std::make_shared<const Eigen::VectorXf>(x);
+    input.y = std::make_shared<const Eigen::VectorXf>(y);
+    input.range = range;
+
+    this->Push_(std::move(input));
+}
+
+
+void DensityGenerator::Shutdown()
+{
+    if (this->thread_.joinable())
+    {
+        {
+            pex::WriteLock lock(this->mutex_);
+            this->isRunning_ = false;
+
+            // Wake up worker so it will exit.
+            this->hasFrameCondition_.notify_one();
+        }
+
+        this->thread_.join();
+    }
+}
+
+
+bool DensityGenerator::Enabled() const
+{
+    pex::ReadLock lock(this->mutex_);
+    return this->densitySettings_.enable;
+}
+
+
+void DensityGenerator::Push_(Input &&input)
+{
+    pex::WriteLock lock(this->mutex_);
+
+    input.densitySettings = this->densitySettings_;
+    input.imageSize = this->imageSize_;
+    this->inputs_.push(std::move(input));
+
+    this->hasFrameCondition_.notify_one();
+}
+
+
+void DensityGenerator::OnDensitySettings_(
+    const DensitySettings &densitySettings)
+{
+    pex::WriteLock lock(this->mutex_);
+    this->densitySettings_ = densitySettings;
+}
+
+
+void DensityGenerator::OnImageSize_(const Size &imageSize)
+{
+    pex::WriteLock lock(this->mutex_);
+    this->imageSize_ = imageSize;
+}
+
+
+void DensityGenerator::Run_()
+{
+    while (this->isRunning_)
+    {
+        Input input;
+
+        {
+            pex::WriteLock lock(this->mutex_);
+
+            if (this->inputs_.empty())
+            {
+                this->hasFrameCondition_.wait(
+                    lock,
+                    [this]
+                    {
+                        return !this->inputs_.empty() || !this->isRunning_;
+                    });
+            }
+
+            if (!this->isRunning_)
+            {
+                return;
+            }
+
+            assert(!this->inputs_.empty());
+
+            input = this->inputs_.front();
+            this->inputs_.pop();
+        }
+
+        auto binCount = input.densitySettings.binCount;
+        DensityMatrix counts;
+
+        if (input.pixels)
+        {
+            counts = GenerateVectorscope(*input.pixels, input.mode, binCount);
+        }
+        else
+        {
+            counts = GenerateDensity(*input.x, *input.y, input.range, binCount);
+        }
+
+        auto densityPixels =
+            RenderDensity(counts, input.densitySettings, input.imageSize);
+
+        if (!densityPixels)
+        {
+            continue;
+        }
+
+        this->pixelViewControl_.asyncPixels.Set(densityPixels);
+    }
+}
+
+
+DensityGenerator::DensityGenerator(
+    DensityGenerator &&other,
+    const pex::WriteLock &)
+    :
+    mutex_(),
+    densityControl_(std::move(other.densityControl_)),
+    pixelViewControl_(std::move(other.pixelViewControl_)),
+
+    densitySettingsEndpoint_(
+        this,
+        this->densityControl_,
+        &DensityGenerator::OnDensitySettings_),
+
+    imageSizeEndpoint_(
+        this,
+        this->pixelViewControl_.canvas.viewSettings.imageSize,
+        &DensityGenerator::OnImageSize_),
+
+    densitySettings_(other.densitySettings_),
+    imageSize_(other.imageSize_),
+
+    isRunning_(true),
+    inputs_(),
+    hasFrameCondition_(),
+    thread_(std::bind(&DensityGenerator::Run_, this))
+{
+
+}
+
+
+} // end namespace draw
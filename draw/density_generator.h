@@ -0,0 +1,92 @@
+#pragma once
+
+#include <thread>
+#include <condition_variable>
+#include <queue>
+
+#include <pex/locks.h>
+
+#include <draw/density.h>
+#include <draw/views/pixel_view_settings.h>
+
+
+namespace draw
+{
+
+
+/**
+ ** Renders vectorscopes and scatter densities on a worker thread with the
+ ** settings of a DensityControl, and publishes them to the asyncPixels of a
+ ** pixel view, like WaveformGenerator.
+ **/
+class DensityGenerator
+{
+public:
+    static constexpr auto observerName = "DensityGenerator";
+
+    DensityGenerator(
+        DensityControl densityControl,
+        PixelViewControl pixelViewControl);
+
+    DensityGenerator(DensityGenerator &&other);
+
+    ~DensityGenerator();
+
+    // Queue a vectorscope of the pixels.
+    void operator()(
+        std::shared_ptr<const Pixels> pixels,
+        VectorscopeMode mode = VectorscopeMode::cbCr);
+
+    // Queue the density of the points (x(i), y(i)).
+    void operator()(
+        const Eigen::VectorXf &x,
+        const Eigen::VectorXf &y,
+        const DensityRange &range);
+
+    void Shutdown();
+
+    bool Enabled() const;
+
+private:
+    struct Input
+    {
+        DensitySettings densitySettings;
+        Size imageSize;
+
+        // Set for a vectorscope.
+        std::shared_ptr<const Pixels> pixels;
+        VectorscopeMode mode;
+
+        // Set for a scatter density.
+        std::shared_ptr<const Eigen::VectorXf> x;
+        std::shared_ptr<const Eigen::VectorXf> y;
+        DensityRange range;
+    };
+
+    void Push_(Input &&input);
+
+    void OnDensitySettings_(const DensitySettings &);
+    void OnImageSize_(const Size &);
+
+    void Run_();
+
+private:
+    DensityGenerator(DensityGenerator &&other, const pex::WriteLock &);
+
+private:
+    mutable pex::Mutex mutex_;
+    DensityControl densityControl_;
+    PixelViewControl pixelViewControl_;
+    pex::Endpoint<DensityGenerator, DensityControl> densitySettingsEndpoint_;
+    pex::Endpoint<DensityGenerator, SizeControl> imageSizeEndpoint_;
+    DensitySettings densitySettings_;
+    Size imageSize_;
+    bool isRunning_;
+    std::queue<Input> inputs_;
+
+    std::condition_variable_any hasFrameCondition_;
+    std::thread thread_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,9 @@
+#include "draw/density_settings.h"
+
+
+template struct pex::Group
+    <
+        draw::DensityFields,
+        draw::DensityTemplate,
+        pex::PlainT<draw::DensitySettings>
+    >;
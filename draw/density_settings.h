@@ -0,0 +1,80 @@
+#pragma once
+
+
+#include <fields/fields.h>
+#include <pex/group.h>
+#include <pex/range.h>
+#include "draw/waveform_settings.h"
+
+
+namespace draw
+{
+
+
+template<typename T>
+struct DensityFields
+{
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&T::enable, "enable"),
+        fields::Field(&T::binCount, "binCount"),
+        fields::Field(&T::logScale, "logScale"),
+        fields::Field(&T::color, "color"));
+};
+
+
+template<template<typename> typename T>
+struct DensityTemplate
+{
+    T<bool> enable;
+
+    // The histogram has binCount bins on each axis.
+    T<pex::MakeRange<size_t, pex::Limit<16>, pex::Limit<1024>>> binCount;
+
+    // Map the logarithm of the counts to colors, so that sparse bins stay
+    // visible beside dense ones.
+    T<bool> logScale;
+
+    T<WaveformColorGroup> color;
+
+    static constexpr auto fields = DensityFields<DensityTemplate>::fields;
+    static constexpr auto fieldsTypeName = "Density";
+};
+
+
+struct DensitySettings: public DensityTemplate<pex::Identity>
+{
+    static constexpr size_t defaultBinCount = 256;
+
+    DensitySettings()
+        :
+        DensityTemplate<pex::Identity>{
+            true,
+            defaultBinCount,
+            true,
+            WaveformColor{}}
+    {
+
+    }
+};
+
+
+DECLARE_OUTPUT_STREAM_OPERATOR(DensitySettings)
+DECLARE_EQUALITY_OPERATORS(DensitySettings)
+
+
+using DensityGroup =
+    pex::Group<DensityFields, DensityTemplate, pex::PlainT<DensitySettings>>;
+
+using DensityModel = typename DensityGroup::Model;
+using DensityControl = typename DensityGroup::DefaultControl;
+
+
+} // end namespace draw
+
+
+extern template struct pex::Group
+    <
+        draw::DensityFields,
+        draw::DensityTemplate,
+        pex::PlainT<draw::DensitySettings>
+    >;
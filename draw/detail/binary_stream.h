@@ -0,0 +1,130 @@
+#pragma once
+
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <type_traits>
+
+#include "draw/error.h"
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+// Values are stored in the byte order of the machine that wrote them.
+static_assert(
+    std::endian::native == std::endian::little,
+    "The binary shape format is little endian");
+
+
+class BinaryWriter
+{
+public:
+    BinaryWriter(std::string &output)
+        :
+        output_(output)
+    {
+
+    }
+
+    template<typename T>
+    void Write(T value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        auto bytes = reinterpret_cast<const char *>(&value);
+        this->output_.append(bytes, sizeof(T));
+    }
+
+    void WriteBytes(const void *data, size_t count)
+    {
+        this->output_.append(static_cast<const char *>(data), count);
+    }
+
+    void WriteString(const std::string &value)
+    {
+        this->Write(static_cast<uint32_t>(value.size()));
+        this->WriteBytes(value.data(), value.size());
+    }
+
+private:
+    std::string &output_;
+};
+
+
+// Reads values from a block of bytes that has already been loaded.
+class BinaryReader
+{
+public:
+    BinaryReader(const char *data, size_t size)
+        :
+        data_(data),
+        size_(size),
+        position_(0)
+    {
+
+    }
+
+    template<typename T>
+    T Read()
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        T value;
+        this->ReadBytes(&value, sizeof(T));
+
+        return value;
+    }
+
+    void ReadBytes(void *target, size_t count)
+    {
+        if (count > this->size_ - this->position_)
+        {
+            throw DrawError("Unexpected end of binary shape");
+        }
+
+        std::memcpy(target, this->data_ + this->position_, count);
+        this->position_ += count;
+    }
+
+    std::string ReadString()
+    {
+        auto count = this->Read<uint32_t>();
+
+        if (count > this->size_ - this->position_)
+        {
+            throw DrawError("Unexpected end of binary shape");
+        }
+
+        std::string result(this->data_ + this->position_, count);
+        this->position_ += count;
+
+        return result;
+    }
+
+    // The number of bytes that have not been read.
+    size_t GetRemaining() const
+    {
+        return this->size_ - this->position_;
+    }
+
+private:
+    const char *data_;
+    size_t size_;
+    size_t position_;
+};
+
+
+} // end namespace detail
+
+
+} // end namespace draw
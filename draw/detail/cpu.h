@@ -0,0 +1,33 @@
+#pragma once
+
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define DRAW_X86_TARGETS
+#include <immintrin.h>
+#endif
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+inline bool HasAvx2()
+{
+#ifdef DRAW_X86_TARGETS
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+
+    return hasAvx2;
+#else
+    return false;
+#endif
+}
+
+
+} // end namespace detail
+
+
+} // end namespace draw
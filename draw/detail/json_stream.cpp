@@ -0,0 +1,513 @@
+#include "draw/detail/json_stream.h"
+
+#include <cassert>
+#include <cctype>
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+JsonWriter::JsonWriter(std::ostream &output)
+    :
+    output_(output),
+    isFirst_(),
+    afterKey_(false)
+{
+
+}
+
+
+void JsonWriter::Separate_()
+{
+    if (this->afterKey_)
+    {
+        this->afterKey_ = false;
+
+        return;
+    }
+
+    if (this->isFirst_.empty())
+    {
+        return;
+    }
+
+    if (this->isFirst_.back())
+    {
+        this->isFirst_.back() = false;
+    }
+    else
+    {
+        this->output_.put(',');
+    }
+}
+
+
+void JsonWriter::BeginObject()
+{
+    this->Separate_();
+    this->output_.put('{');
+    this->isFirst_.push_back(true);
+}
+
+
+void JsonWriter::EndObject()
+{
+    assert(!this->isFirst_.empty());
+    this->isFirst_.pop_back();
+    this->output_.put('}');
+}
+
+
+void JsonWriter::BeginArray()
+{
+    this->Separate_();
+    this->output_.put('[');
+    this->isFirst_.push_back(true);
+}
+
+
+void JsonWriter::EndArray()
+{
+    assert(!this->isFirst_.empty());
+    this->isFirst_.pop_back();
+    this->output_.put(']');
+}
+
+
+void JsonWriter::Key(std::string_view key)
+{
+    this->String(key);
+    this->output_.put(':');
+    this->afterKey_ = true;
+}
+
+
+void JsonWriter::String(std::string_view value)
+{
+    this->Separate_();
+    this->output_.put('"');
+
+    auto begin = value.data();
+    auto end = begin + value.size();
+    auto run = begin;
+
+    // Write runs of characters that need no escape in one call.
+    for (auto it = begin; it != end; ++it)
+    {
+        auto character = static_cast<unsigned char>(*it);
+
+        if (character >= 0x20 && character != '"' && character != '\\')
+        {
+            continue;
+        }
+
+        this->output_.write(run, it - run);
+        run = it + 1;
+
+        switch (character)
+        {
+            case '"':
+                this->output_.write("\\\"", 2);
+                break;
+
+            case '\\':
+                this->output_.write("\\\\", 2);
+                break;
+
+            case '\n':
+                this->output_.write("\\n", 2);
+                break;
+
+            case '\r':
+                this->output_.write("\\r", 2);
+                break;
+
+            case '\t':
+                this->output_.write("\\t", 2);
+                break;
+
+            default:
+            {
+                static constexpr char hex[] = "0123456789abcdef";
+                char escaped[] = {'\\', 'u', '0', '0', '0', '0'};
+                escaped[4] = hex[character >> 4];
+                escaped[5] = hex[character & 0xf];
+                this->output_.write(escaped, sizeof(escaped));
+                break;
+            }
+        }
+    }
+
+    this->output_.write(run, end - run);
+    this->output_.put('"');
+}
+
+
+void JsonWriter::Bool(bool value)
+{
+    this->Separate_();
+
+    if (value)
+    {
+        this->output_.write("true", 4);
+    }
+    else
+    {
+        this->output_.write("false", 5);
+    }
+}
+
+
+void JsonWriter::Null()
+{
+    this->Separate_();
+    this->output_.write("null", 4);
+}
+
+
+JsonReader::JsonReader(std::istream &input)
+    :
+    input_(input),
+    buffer_(bufferSize),
+    bufferOffset_(static_cast<uint64_t>(input.tellg())),
+    position_(0),
+    size_(0),
+    text_()
+{
+
+}
+
+
+uint64_t JsonReader::Tell() const
+{
+    return this->bufferOffset_ + this->position_;
+}
+
+
+void JsonReader::Seek(uint64_t offset)
+{
+    if (offset >= this->bufferOffset_
+            && offset <= this->bufferOffset_ + this->size_)
+    {
+        // The offset is already buffered.
+        this->position_ = static_cast<size_t>(offset - this->bufferOffset_);
+
+        return;
+    }
+
+    this->input_.clear();
+    this->input_.seekg(static_cast<std::streamoff>(offset));
+    this->bufferOffset_ = offset;
+    this->position_ = 0;
+    this->size_ = 0;
+}
+
+
+bool JsonReader::Fill_()
+{
+    if (this->position_ < this->size_)
+    {
+        return true;
+    }
+
+    this->bufferOffset_ += this->size_;
+    this->position_ = 0;
+
+    this->input_.read(
+        this->buffer_.data(),
+        static_cast<std::streamsize>(this->buffer_.size()));
+
+    this->size_ = static_cast<size_t>(this->input_.gcount());
+
+    return this->size_ > 0;
+}
+
+
+char JsonReader::Next_()
+{
+    if (!this->Fill_())
+    {
+        throw DrawError("Unexpected end of JSON");
+    }
+
+    return this->buffer_[this->position_++];
+}
+
+
+char JsonReader::Peek()
+{
+    while (this->Fill_())
+    {
+        auto character = this->buffer_[this->position_];
+
+        if (!std::isspace(static_cast<unsigned char>(character)))
+        {
+            return character;
+        }
+
+        ++this->position_;
+    }
+
+    return 0;
+}
+
+
+bool JsonReader::Consume(char expected)
+{
+    if (this->Peek() != expected)
+    {
+        return false;
+    }
+
+    ++this->position_;
+
+    return true;
+}
+
+
+void JsonReader::Expect(char expected)
+{
+    if (!this->Consume(expected))
+    {
+        throw DrawError(
+            std::string("Expected '") + expected + "' at offset "
+            + std::to_string(this->Tell()));
+    }
+}
+
+
+std::string_view JsonReader::ReadString()
+{
+    this->Expect('"');
+    this->text_.clear();
+
+    while (true)
+    {
+        auto character = this->Next_();
+
+        if (character == '"')
+        {
+            return this->text_;
+        }
+
+        if (character != '\\')
+        {
+            this->text_.push_back(character);
+            continue;
+        }
+
+        character = this->Next_();
+
+        switch (character)
+        {
+            case 'n':
+                this->text_.push_back('\n');
+                break;
+
+            case 'r':
+                this->text_.push_back('\r');
+                break;
+
+            case 't':
+                this->text_.push_back('\t');
+                break;
+
+            case 'b':
+                this->text_.push_back('\b');
+                break;
+
+            case 'f':
+                this->text_.push_back('\f');
+                break;
+
+            case 'u':
+            {
+                char hex[4];
+
+                for (auto &digit: hex)
+                {
+                    digit = this->Next_();
+                }
+
+                unsigned codePoint = 0;
+                std::from_chars(hex, hex + 4, codePoint, 16);
+
+                // Encode as UTF-8. Surrogate pairs are not combined.
+                if (codePoint < 0x80)
+                {
+                    this->text_.push_back(static_cast<char>(codePoint));
+                }
+                else if (codePoint < 0x800)
+                {
+                    this->text_.push_back(
+                        static_cast<char>(0xc0 | (codePoint >> 6)));
+
+                    this->text_.push_back(
+                        static_cast<char>(0x80 | (codePoint & 0x3f)));
+                }
+                else
+                {
+                    this->text_.push_back(
+                        static_cast<char>(0xe0 | (codePoint >> 12)));
+
+                    this->text_.push_back(
+                        static_cast<char>(0x80 | ((codePoint >> 6) & 0x3f)));
+
+                    this->text_.push_back(
+                        static_cast<char>(0x80 | (codePoint & 0x3f)));
+                }
+
+                break;
+            }
+
+            default:
+                // '"', '\\' and '/'
+                this->text_.push_back(character);
+                break;
+        }
+    }
+}
+
+
+void JsonReader::SkipWord_(std::string_view word)
+{
+    for (auto expected: word)
+    {
+        if (this->Next_() != expected)
+        {
+            throw DrawError("Expected " + std::string(word));
+        }
+    }
+}
+
+
+bool JsonReader::ReadBool()
+{
+    if (this->Peek() == 't')
+    {
+        this->SkipWord_("true");
+
+        return true;
+    }
+
+    this->SkipWord_("false");
+
+    return false;
+}
+
+
+bool JsonReader::ReadNull()
+{
+    if (this->Peek() != 'n')
+    {
+        return false;
+    }
+
+    this->SkipWord_("null");
+
+    return true;
+}
+
+
+std::string_view JsonReader::ReadNumberText_()
+{
+    this->Peek();
+    this->text_.clear();
+
+    while (this->Fill_())
+    {
+        auto character = this->buffer_[this->position_];
+
+        if (!std::isdigit(static_cast<unsigned char>(character))
+                && character != '-'
+                && character != '+'
+                && character != '.'
+                && character != 'e'
+                && character != 'E')
+        {
+            break;
+        }
+
+        this->text_.push_back(character);
+        ++this->position_;
+    }
+
+    if (this->text_.empty())
+    {
+        throw DrawError(
+            "Expected a number at offset " + std::to_string(this->Tell()));
+    }
+
+    return this->text_;
+}
+
+
+void JsonReader::SkipValue()
+{
+    switch (this->Peek())
+    {
+        case '"':
+            this->ReadString();
+            break;
+
+        case '{':
+            this->Expect('{');
+
+            if (this->Consume('}'))
+            {
+                break;
+            }
+
+            do
+            {
+                this->ReadString();
+                this->Expect(':');
+                this->SkipValue();
+            }
+            while (this->Consume(','));
+
+            this->Expect('}');
+            break;
+
+        case '[':
+            this->Expect('[');
+
+            if (this->Consume(']'))
+            {
+                break;
+            }
+
+            do
+            {
+                this->SkipValue();
+            }
+            while (this->Consume(','));
+
+            this->Expect(']');
+            break;
+
+        case 't':
+        case 'f':
+            this->ReadBool();
+            break;
+
+        case 'n':
+            this->ReadNull();
+            break;
+
+        default:
+            this->ReadNumberText_();
+            break;
+    }
+}
+
+
+} // end namespace detail
+
+
+} // end namespace draw
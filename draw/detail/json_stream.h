@@ -0,0 +1,182 @@
+#pragma once
+
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "draw/error.h"
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+/**
+ ** Writes JSON text as it is produced, without building a document.
+ **
+ ** Commas are inserted between the members of objects and arrays.
+ **/
+class JsonWriter
+{
+public:
+    JsonWriter(std::ostream &output);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    void Key(std::string_view key);
+
+    void String(std::string_view value);
+    void Bool(bool value);
+    void Null();
+
+    template<typename T>
+    void Number(T value)
+    {
+        static_assert(std::is_arithmetic_v<T>);
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (!std::isfinite(value))
+            {
+                // JSON has no representation for NaN or infinity.
+                this->Null();
+
+                return;
+            }
+        }
+
+        this->Separate_();
+
+        char buffer[32];
+
+        // The shortest text that reads back to the same value.
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        this->output_.write(buffer, result.ptr - buffer);
+    }
+
+private:
+    void Separate_();
+
+private:
+    std::ostream &output_;
+
+    // One entry for each open object or array, true until the first member.
+    std::vector<bool> isFirst_;
+
+    bool afterKey_;
+};
+
+
+/**
+ ** Reads JSON text one token at a time.
+ **
+ ** The caller knows the structure it expects, and asks for each value in
+ ** turn. Values it does not want are skipped without being stored.
+ **/
+class JsonReader
+{
+public:
+    static constexpr size_t bufferSize = 64 * 1024;
+
+    JsonReader(std::istream &input);
+
+    // The offset of the next unread character.
+    uint64_t Tell() const;
+
+    // Continue reading from an offset previously returned by Tell.
+    void Seek(uint64_t offset);
+
+    // @return The next character that is not whitespace, or 0 at the end.
+    char Peek();
+
+    // Skip the next character if it is the expected one.
+    bool Consume(char expected);
+
+    // Throws DrawError if the next character is not the expected one.
+    void Expect(char expected);
+
+    // @return A view that is valid until the next call.
+    std::string_view ReadString();
+
+    bool ReadBool();
+
+    // Consumes null, if it is next.
+    bool ReadNull();
+
+    template<typename T>
+    T ReadNumber()
+    {
+        static_assert(std::is_arithmetic_v<T>);
+
+        if (this->ReadNull())
+        {
+            if constexpr (std::is_floating_point_v<T>)
+            {
+                return std::numeric_limits<T>::quiet_NaN();
+            }
+            else
+            {
+                throw DrawError("Expected a number, found null");
+            }
+        }
+
+        auto text = this->ReadNumberText_();
+        T value{};
+
+        auto result = std::from_chars(
+            text.data(),
+            text.data() + text.size(),
+            value);
+
+        if (result.ec != std::errc() || result.ptr != text.data() + text.size())
+        {
+            throw DrawError("Invalid number: " + std::string(text));
+        }
+
+        return value;
+    }
+
+    // Skip one complete value, including any nested objects or arrays.
+    void SkipValue();
+
+private:
+    bool Fill_();
+
+    char Next_();
+
+    std::string_view ReadNumberText_();
+
+    void SkipWord_(std::string_view word);
+
+private:
+    std::istream &input_;
+    std::vector<char> buffer_;
+
+    // The stream offset of buffer_[0].
+    uint64_t bufferOffset_;
+
+    size_t position_;
+    size_t size_;
+    std::string text_;
+};
+
+
+} // end namespace detail
+
+
+} // end namespace draw
@@ -0,0 +1,172 @@
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+BandPool::BandPool(size_t threadCount)
+    :
+    mutex_(),
+    isRunning_(true),
+    jobs_(),
+    hasJobCondition_(),
+    threads_()
+{
+    // The calling thread is the first thread.
+    for (size_t i = 1; i < threadCount; ++i)
+    {
+        this->threads_.emplace_back(std::bind(&BandPool::Work_, this));
+    }
+}
+
+
+BandPool::~BandPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->isRunning_ = false;
+
+        // Wake up workers so they will exit.
+        this->hasJobCondition_.notify_all();
+    }
+
+    for (auto &thread: this->threads_)
+    {
+        thread.join();
+    }
+}
+
+
+BandPool & BandPool::GetDefault()
+{
+    static BandPool pool(GetThreadCount());
+
+    return pool;
+}
+
+
+void BandPool::Run(size_t taskCount, const Task &task)
+{
+    if (taskCount == 0)
+    {
+        return;
+    }
+
+    if (taskCount == 1 || this->threads_.empty())
+    {
+        for (size_t i = 0; i < taskCount; ++i)
+        {
+            task(i);
+        }
+
+        return;
+    }
+
+    Job job{&task, taskCount, 0, 0, nullptr, {}};
+
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    this->jobs_.push_back(&job);
+    this->hasJobCondition_.notify_all();
+
+    while (job.next < job.count)
+    {
+        this->Call_(job, this->Claim_(job), lock);
+    }
+
+    // Wait for the indices claimed by the workers.
+    job.isDone.wait(
+        lock,
+        [&job]
+        {
+            return job.done == job.count;
+        });
+
+    if (job.error)
+    {
+        std::rethrow_exception(job.error);
+    }
+}
+
+
+size_t BandPool::Claim_(Job &job)
+{
+    auto index = job.next++;
+
+    if (job.next == job.count)
+    {
+        // Nothing is left to claim.
+        this->jobs_.erase(
+            std::find(this->jobs_.begin(), this->jobs_.end(), &job));
+    }
+
+    return index;
+}
+
+
+void BandPool::Call_(
+    Job &job,
+    size_t index,
+    std::unique_lock<std::mutex> &lock)
+{
+    lock.unlock();
+
+    std::exception_ptr error;
+
+    try
+    {
+        (*job.task)(index);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    lock.lock();
+
+    if (error && !job.error)
+    {
+        job.error = error;
+    }
+
+    if (++job.done == job.count)
+    {
+        // The caller may return as soon as the mutex is released, so the job
+        // must not be used after this.
+        job.isDone.notify_all();
+    }
+}
+
+
+void BandPool::Work_()
+{
+    std::unique_lock<std::mutex> lock(this->mutex_);
+
+    while (true)
+    {
+        this->hasJobCondition_.wait(
+            lock,
+            [this]
+            {
+                return !this->jobs_.empty() || !this->isRunning_;
+            });
+
+        if (!this->isRunning_)
+        {
+            return;
+        }
+
+        auto &job = *this->jobs_.front();
+        this->Call_(job, this->Claim_(job), lock);
+    }
+}
+
+
+} // end namespace detail
+
+
+} // end namespace draw
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+inline size_t GetThreadCount()
+{
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+
+/**
+ ** Worker threads that stay alive between calls to ParallelBands.
+ **
+ ** Run calls task(index) for every index, on the workers and on the calling
+ ** thread, and returns when every index has finished. Calls may come from
+ ** several threads at once, and from inside a task, because each caller
+ ** works on its own job until the job has no indices left to claim.
+ **/
+class BandPool
+{
+public:
+    using Task = std::function<void(size_t index)>;
+
+    // threadCount includes the calling thread.
+    BandPool(size_t threadCount);
+
+    ~BandPool();
+
+    BandPool(const BandPool &) = delete;
+    BandPool & operator=(const BandPool &) = delete;
+
+    // Shared by every ParallelBands, with one thread per core.
+    static BandPool & GetDefault();
+
+    // Rethrows the first exception thrown by a task.
+    void Run(size_t taskCount, const Task &task);
+
+private:
+    struct Job
+    {
+        const Task *task;
+        size_t count;
+        size_t next;
+        size_t done;
+        std::exception_ptr error;
+        std::condition_variable isDone;
+    };
+
+    // Claim the next index of a job. Called with the mutex locked.
+    size_t Claim_(Job &job);
+
+    // Call the task unlocked, then count it as done.
+    void Call_(Job &job, size_t index, std::unique_lock<std::mutex> &lock);
+
+    void Work_();
+
+private:
+    std::mutex mutex_;
+    bool isRunning_;
+    std::deque<Job *> jobs_;
+    std::condition_variable hasJobCondition_;
+    std::vector<std::thread> threads_;
+};
+
+
+/**
+ ** Split [0, count) into contiguous bands, and call function(begin, end) for
+ ** each band on the threads of BandPool::GetDefault().
+ **
+ ** Small workloads run on the calling thread, where waking workers would
+ ** cost more than it saves.
+ **
+ ** @param count The number of rows (or other units) of work.
+ ** @param minimumBand The fewest rows worth giving to a thread.
+ **/
+template<typename Index, typename Function>
+void ParallelBands(Index count, Index minimumBand, Function &&function)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    auto bandCount = std::min(
+        static_cast<Index>(GetThreadCount()),
+        std::max(static_cast<Index>(1), count / std::max(minimumBand, Index{1})));
+
+    if (bandCount <= 1)
+    {
+        function(Index{0}, count);
+
+        return;
+    }
+
+    auto bandSize = (count + bandCount - 1) / bandCount;
+
+    // Rounding up the band size may leave fewer bands.
+    bandCount = (count + bandSize - 1) / bandSize;
+
+    BandPool::GetDefault().Run(
+        static_cast<size_t>(bandCount),
+        [&](size_t band)
+        {
+            auto begin = static_cast<Index>(band) * bandSize;
+            function(begin, std::min(begin + bandSize, count));
+        });
+}
+
+
+} // end namespace detail
+
+
+} // end namespace draw
@@ -8,6 +8,9 @@ namespace draw
 {
 
 
+class DragPreviewBase;
+
+
 class Drag
 {
 public:
@@ -39,6 +42,10 @@ public:
     virtual void ReportLogicalPosition(
         const tau::Point2d<double> &position) = 0;
 
+    // Drags that edit an existing shape draw it on the preview, and update
+    // the shape list less often.
+    virtual void SetPreview(DragPreviewBase *) {}
+
     // Get the position of the dragged element.
     // The start_ is usually near the dragged element.
     // The offset_ the position of the dragged shape feature.
@@ -0,0 +1,253 @@
+#include "draw/drag_preview.h"
+
+#include <algorithm>
+#include <iostream>
+
+
+namespace draw
+{
+
+
+DragPreviewBase::DragPreviewBase(Clock::duration commitInterval)
+    :
+    commitInterval_(commitInterval),
+    draggedShape_(noShape)
+{
+
+}
+
+
+DragPreviewBase::Clock::duration DragPreviewBase::GetCommitInterval() const
+{
+    return this->commitInterval_;
+}
+
+
+DraggedShapeControl DragPreviewBase::GetDraggedShape()
+{
+    return DraggedShapeControl(this->draggedShape_);
+}
+
+
+void DragPreviewBase::Begin(int64_t shapeId)
+{
+    this->draggedShape_.Set(shapeId);
+}
+
+
+void DragPreviewBase::End()
+{
+    this->StopFlushTimer();
+
+    // Display the committed shape before removing the preview, so that the
+    // shape does not disappear between the two.
+    this->draggedShape_.Set(noShape);
+    this->Hide_();
+}
+
+
+DragPreview::DragPreview(
+    const AsyncShapesControl &shapes,
+    Clock::duration commitInterval)
+    :
+    DragPreviewBase(commitInterval),
+    shapes_(shapes),
+    shapesId_(),
+    timer_(),
+    flush_()
+{
+    // Without an owner, the timer sends its events to itself.
+    this->timer_.Bind(wxEVT_TIMER, &DragPreview::OnTimer_, this);
+}
+
+
+DragPreview::~DragPreview()
+{
+    this->timer_.Stop();
+}
+
+
+void DragPreview::Show(const std::shared_ptr<DrawnShape> &shape)
+{
+    auto shapes = Shapes(this->shapesId_.Get());
+    shapes.Append(shape);
+    this->shapes_.Set(shapes);
+}
+
+
+void DragPreview::StartFlushTimer(
+    Clock::duration delay,
+    std::function<void()> flush)
+{
+    this->flush_ = std::move(flush);
+
+    auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(delay);
+
+    this->timer_.StartOnce(
+        std::max(1, static_cast<int>(milliseconds.count())));
+}
+
+
+void DragPreview::StopFlushTimer()
+{
+    this->timer_.Stop();
+    this->flush_ = nullptr;
+}
+
+
+void DragPreview::Hide_()
+{
+    this->shapes_.Set(Shapes(this->shapesId_.Get()));
+}
+
+
+void DragPreview::OnTimer_(wxTimerEvent &)
+{
+    auto flush = std::move(this->flush_);
+    this->flush_ = nullptr;
+
+    if (flush)
+    {
+        flush();
+    }
+}
+
+
+DragCommitter::DragCommitter(std::shared_ptr<ShapeControl> control)
+    :
+    control_(control),
+    preview_(nullptr),
+    pending_(),
+    lastCommit_(),
+    isFlushScheduled_(false)
+{
+
+}
+
+
+DragCommitter::~DragCommitter()
+{
+    try
+    {
+        this->Finish();
+    }
+    catch (std::exception &e)
+    {
+        std::cerr << "Error finishing drag: " << e.what() << std::endl;
+    }
+}
+
+
+void DragCommitter::SetPreview(DragPreviewBase *preview, int64_t shapeId)
+{
+    this->Finish();
+
+    if (!preview)
+    {
+        return;
+    }
+
+    this->preview_ = preview;
+    this->lastCommit_ = Clock::now();
+    this->preview_->Begin(shapeId);
+}
+
+
+bool DragCommitter::HasPreview() const
+{
+    return !!this->preview_;
+}
+
+
+void DragCommitter::Update(const std::shared_ptr<Shape> &shape)
+{
+    if (!this->preview_)
+    {
+        this->control_->SetValue(*shape);
+
+        return;
+    }
+
+    this->preview_->Show(shape);
+
+    auto now = Clock::now();
+    auto elapsed = now - this->lastCommit_;
+    auto interval = this->preview_->GetCommitInterval();
+
+    if (elapsed >= interval)
+    {
+        this->Send_(shape, now);
+
+        return;
+    }
+
+    // Replace any shape that has not been sent.
+    this->pending_ = shape;
+
+    if (!this->isFlushScheduled_)
+    {
+        // Send it even if the mouse stops moving.
+        this->isFlushScheduled_ = true;
+
+        this->preview_->StartFlushTimer(
+            interval - elapsed,
+            [this]()
+            {
+                this->Flush_();
+            });
+    }
+}
+
+
+void DragCommitter::Finish()
+{
+    if (!this->preview_)
+    {
+        return;
+    }
+
+    auto preview = this->preview_;
+    this->preview_ = nullptr;
+    this->isFlushScheduled_ = false;
+
+    if (this->pending_)
+    {
+        auto pending = std::move(this->pending_);
+        this->pending_.reset();
+        this->control_->SetValue(*pending);
+    }
+
+    // Stops the timer, so Flush_ is not called after the drag.
+    preview->End();
+}
+
+
+void DragCommitter::Send_(
+    const std::shared_ptr<Shape> &shape,
+    Clock::time_point now)
+{
+    if (this->isFlushScheduled_)
+    {
+        this->preview_->StopFlushTimer();
+        this->isFlushScheduled_ = false;
+    }
+
+    this->pending_.reset();
+    this->lastCommit_ = now;
+    this->control_->SetValue(*shape);
+}
+
+
+void DragCommitter::Flush_()
+{
+    this->isFlushScheduled_ = false;
+
+    if (this->preview_ && this->pending_)
+    {
+        auto pending = this->pending_;
+        this->Send_(pending, Clock::now());
+    }
+}
+
+
+} // end namespace draw
@@ -0,0 +1,163 @@
+#pragma once
+
+
+#include <chrono>
+#include <functional>
+#include <memory>
+
+#include <pex/value.h>
+#include <wxpex/ignores.h>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/timer.h>
+WXSHIM_POP_IGNORES
+
+#include "draw/shapes.h"
+
+
+namespace draw
+{
+
+
+using DraggedShapeModel = pex::model::Value<int64_t>;
+using DraggedShapeControl = pex::control::Value<DraggedShapeModel>;
+
+
+/**
+ ** Where a drag draws its shape between updates of the shape list.
+ **
+ ** Drags publish each new position of the shape here, at the rate the canvas
+ ** reports the mouse, and update the shape list at most once per
+ ** commitInterval. Displays of the shape list skip the dragged shape while it
+ ** is drawn here, and display it again when the drag ends.
+ **
+ ** Derived classes draw the shape and provide the timer that sends the last
+ ** shape when the mouse stops moving.
+ **/
+class DragPreviewBase
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto defaultCommitInterval =
+        std::chrono::milliseconds(100);
+
+    // The dragged shape id when there is no drag.
+    static constexpr int64_t noShape = -1;
+
+    DragPreviewBase(Clock::duration commitInterval);
+
+    virtual ~DragPreviewBase() {}
+
+    DragPreviewBase(const DragPreviewBase &) = delete;
+    DragPreviewBase & operator=(const DragPreviewBase &) = delete;
+
+    Clock::duration GetCommitInterval() const;
+
+    // The id of the shape being dragged, or noShape.
+    DraggedShapeControl GetDraggedShape();
+
+    void Begin(int64_t shapeId);
+
+    void End();
+
+    virtual void Show(const std::shared_ptr<DrawnShape> &shape) = 0;
+
+    // Call flush once after delay, unless StopFlushTimer is called first.
+    virtual void StartFlushTimer(
+        Clock::duration delay,
+        std::function<void()> flush) = 0;
+
+    virtual void StopFlushTimer() = 0;
+
+protected:
+    virtual void Hide_() = 0;
+
+private:
+    Clock::duration commitInterval_;
+    DraggedShapeModel draggedShape_;
+};
+
+
+/**
+ ** Draws the dragged shape on its own layer of a pixel view.
+ **
+ ** The layer is drawn above layers published with a ShapesId created before
+ ** the preview. Flushes run on the wx event loop, with the shape list.
+ **/
+class DragPreview: public DragPreviewBase
+{
+public:
+    DragPreview(
+        const AsyncShapesControl &shapes,
+        Clock::duration commitInterval = defaultCommitInterval);
+
+    ~DragPreview();
+
+    void Show(const std::shared_ptr<DrawnShape> &shape) override;
+
+    void StartFlushTimer(
+        Clock::duration delay,
+        std::function<void()> flush) override;
+
+    void StopFlushTimer() override;
+
+protected:
+    void Hide_() override;
+
+private:
+    void OnTimer_(wxTimerEvent &);
+
+private:
+    AsyncShapesControl shapes_;
+    ShapesId shapesId_;
+    wxTimer timer_;
+    std::function<void()> flush_;
+};
+
+
+/**
+ ** Sends the shapes made by a drag to the shape's control.
+ **
+ ** Without a preview, every shape is sent. With a preview, every shape is
+ ** drawn on the preview, and only the most recent is sent once
+ ** commitInterval has passed since the last one, either by the next update
+ ** or by the preview's timer. Shapes that were superseded before their turn
+ ** are dropped. The last shape is sent when the drag ends.
+ **/
+class DragCommitter
+{
+public:
+    using Clock = DragPreviewBase::Clock;
+
+    DragCommitter(std::shared_ptr<ShapeControl> control);
+
+    ~DragCommitter();
+
+    DragCommitter(const DragCommitter &) = delete;
+    DragCommitter & operator=(const DragCommitter &) = delete;
+
+    void SetPreview(DragPreviewBase *preview, int64_t shapeId);
+
+    bool HasPreview() const;
+
+    void Update(const std::shared_ptr<Shape> &shape);
+
+    // Send any shape that is waiting, and hide the preview.
+    void Finish();
+
+private:
+    void Send_(const std::shared_ptr<Shape> &shape, Clock::time_point now);
+
+    void Flush_();
+
+private:
+    std::shared_ptr<ShapeControl> control_;
+    DragPreviewBase *preview_;
+    std::shared_ptr<Shape> pending_;
+    Clock::time_point lastCommit_;
+    bool isFlushScheduled_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,303 @@
+#include "draw/draw_labels.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <utility>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/dcmemory.h>
+#include <wx/image.h>
+WXSHIM_POP_IGNORES
+
+#include <pex/locks.h>
+
+
+namespace draw
+{
+
+
+std::shared_ptr<const GlyphAtlas> CreateGlyphAtlas(
+    double pointSize,
+    bool antialias)
+{
+    wxFont font(
+        wxFontInfo(pointSize)
+        .Family(wxFONTFAMILY_MODERN)
+        .AntiAliased(antialias));
+
+    wxBitmap bitmap(1, 1, 24);
+    wxMemoryDC dc(bitmap);
+    dc.SetFont(font);
+
+    // Leave a column between glyphs so they cannot bleed into each other.
+    static constexpr int gap = 1;
+
+    std::vector<Glyph> glyphs;
+    int width = 0;
+    int lineHeight = 1;
+
+    for (
+        auto character = GlyphAtlas::firstCharacter;
+        character <= GlyphAtlas::lastCharacter;
+        ++character)
+    {
+        auto extent = dc.GetTextExtent(wxString(character));
+        glyphs.push_back({width, 0, extent.x, extent.y, extent.x});
+        width += extent.x + gap;
+        lineHeight = std::max(lineHeight, extent.y);
+    }
+
+    width = std::max(width, 1);
+
+    bitmap = wxBitmap(width, lineHeight, 24);
+    dc.SelectObject(bitmap);
+    dc.SetBackground(*wxBLACK_BRUSH);
+    dc.Clear();
+    dc.SetFont(font);
+    dc.SetTextForeground(*wxWHITE);
+
+    for (auto &glyph: glyphs)
+    {
+        auto character = static_cast<char>(
+            GlyphAtlas::firstCharacter + (&glyph - glyphs.data()));
+
+        dc.DrawText(wxString(character), glyph.x, glyph.y);
+    }
+
+    dc.SelectObject(wxNullBitmap);
+
+    auto image = bitmap.ConvertToImage();
+    auto data = image.GetData();
+    GlyphAtlas::Coverage coverage(lineHeight, width);
+
+    // White text on black, so any channel is the coverage.
+    for (Eigen::Index i = 0; i < coverage.size(); ++i)
+    {
+        coverage.data()[i] = data[3 * i];
+    }
+
+    return std::make_shared<const GlyphAtlas>(
+        std::move(coverage),
+        std::move(glyphs),
+        lineHeight);
+}
+
+
+std::shared_ptr<const GlyphAtlas> GetGlyphAtlas(const FontLook &fontLook)
+{
+    static pex::Mutex mutex;
+
+    static std::map<std::pair<double, bool>, std::shared_ptr<const GlyphAtlas>>
+        atlases;
+
+    pex::WriteLock lock(mutex);
+    auto key = std::make_pair(fontLook.pointSize, fontLook.antialias);
+    auto &atlas = atlases[key];
+
+    if (!atlas)
+    {
+        atlas = CreateGlyphAtlas(fontLook.pointSize, fontLook.antialias);
+    }
+
+    return atlas;
+}
+
+
+namespace
+{
+
+
+// Collects the coverage of the labels into the alpha channel of an image.
+class AlphaTarget
+{
+public:
+    using Color = bool;
+
+    AlphaTarget(const Size &size, uint8_t *alpha)
+        :
+        size_(size),
+        alpha_(alpha)
+    {
+
+    }
+
+    Size GetSize() const
+    {
+        return this->size_;
+    }
+
+    void Blend(
+        int row,
+        int begin,
+        int end,
+        const float *coverage,
+        const Color &,
+        double alpha)
+    {
+        auto target = this->alpha_ + row * this->size_.width;
+
+        for (int column = begin; column < end; ++column)
+        {
+            auto value = static_cast<uint8_t>(
+                coverage[column] * static_cast<float>(alpha) * 255.0f
+                + 0.5f);
+
+            target[column] = std::max(target[column], value);
+        }
+    }
+
+private:
+    Size size_;
+    uint8_t *alpha_;
+};
+
+
+} // end anonymous namespace
+
+
+LabelOverlay::LabelOverlay()
+    :
+    placed_(),
+    color_(),
+    bitmap_()
+{
+
+}
+
+
+void LabelOverlay::Draw(
+    DrawContext &context,
+    LabelRenderer &renderer,
+    const std::vector<Label> &labels,
+    const FontLook &fontLook)
+{
+    if (!fontLook.enable || labels.empty())
+    {
+        return;
+    }
+
+    auto scale = context.GetScale();
+    auto translation = context.GetTranslation();
+    auto size = context.GetSize();
+
+    std::vector<Label> screenLabels;
+    screenLabels.reserve(labels.size());
+
+    for (auto &label: labels)
+    {
+        screenLabels.push_back(
+            {
+                label.text,
+                PointDouble(
+                    label.position.x * scale.horizontal + translation.x,
+                    label.position.y * scale.vertical + translation.y)});
+    }
+
+    auto placed = renderer.Place(
+        screenLabels,
+        tau::Region<double>{{PointDouble(0, 0), size}});
+
+    if (placed.empty())
+    {
+        return;
+    }
+
+    // Draw every label into one bitmap that covers all of them.
+    auto left = std::numeric_limits<int>::max();
+    auto top = std::numeric_limits<int>::max();
+    auto right = std::numeric_limits<int>::lowest();
+    auto bottom = std::numeric_limits<int>::lowest();
+
+    for (auto &label: placed)
+    {
+        left = std::min(left, label.x);
+        top = std::min(top, label.y);
+        right = std::max(right, label.x + label.layout->width);
+        bottom = std::max(bottom, label.y + label.layout->height);
+    }
+
+    for (auto &label: placed)
+    {
+        label.x -= left;
+        label.y -= top;
+    }
+
+    auto overlaySize = Size(right - left, bottom - top);
+
+    if (overlaySize.width <= 0 || overlaySize.height <= 0)
+    {
+        return;
+    }
+
+    auto color = wxpex::ToWxColour(fontLook.color);
+
+    if (!this->IsCurrent_(placed, color))
+    {
+        this->Render_(renderer, std::move(placed), color, overlaySize);
+    }
+
+    wxpex::MaintainTransform maintainTransform(context);
+    context->SetTransform(context->CreateMatrix());
+
+    context->DrawBitmap(
+        this->bitmap_,
+        left,
+        top,
+        overlaySize.width,
+        overlaySize.height);
+}
+
+
+bool LabelOverlay::IsCurrent_(
+    const std::vector<PlacedLabel> &placed,
+    const wxColour &color) const
+{
+    if (!this->bitmap_.IsOk() || color != this->color_)
+    {
+        return false;
+    }
+
+    // Cached layouts are shared, so an unchanged label has the same layout.
+    return std::equal(
+        placed.begin(),
+        placed.end(),
+        this->placed_.begin(),
+        this->placed_.end(),
+        [](const PlacedLabel &first, const PlacedLabel &second)
+        {
+            return first.layout == second.layout
+                && first.x == second.x
+                && first.y == second.y;
+        });
+}
+
+
+void LabelOverlay::Render_(
+    LabelRenderer &renderer,
+    std::vector<PlacedLabel> &&placed,
+    const wxColour &color,
+    const Size &size)
+{
+    wxImage image(size.width, size.height, false);
+
+    image.SetRGB(
+        wxRect(0, 0, size.width, size.height),
+        color.Red(),
+        color.Green(),
+        color.Blue());
+
+    image.InitAlpha();
+    auto alpha = image.GetAlpha();
+    std::fill_n(alpha, size.GetArea(), uint8_t(0));
+
+    AlphaTarget target(size, alpha);
+    renderer.Render(target, placed, true);
+
+    this->placed_ = std::move(placed);
+    this->color_ = color;
+    this->bitmap_ = wxBitmap(image);
+}
+
+
+} // end namespace draw
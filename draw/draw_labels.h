@@ -0,0 +1,79 @@
+#pragma once
+
+
+#include <memory>
+#include <vector>
+
+#include <wxpex/ignores.h>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/bitmap.h>
+WXSHIM_POP_IGNORES
+
+#include "draw/draw_context.h"
+#include "draw/font_look.h"
+#include "draw/label_renderer.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** Rasterize the printable characters of the font chosen by ConfigureFontLook.
+ **
+ ** Uses wx to draw the glyphs, so it must be called on the GUI thread.
+ **/
+std::shared_ptr<const GlyphAtlas> CreateGlyphAtlas(
+    double pointSize,
+    bool antialias);
+
+
+// Atlases are kept for every point size and antialias setting requested.
+std::shared_ptr<const GlyphAtlas> GetGlyphAtlas(const FontLook &fontLook);
+
+
+/**
+ ** Draws many labels with one bitmap.
+ **
+ ** Labels keep the same size in pixels at every zoom. Labels outside of the
+ ** view, or that overlap an earlier label, are skipped.
+ **
+ ** The bitmap is kept while the placed labels do not move relative to each
+ ** other and the color is unchanged, so panning and repainting only draw it.
+ **/
+class LabelOverlay
+{
+public:
+    LabelOverlay();
+
+    /**
+     ** @param labels Positions in the coordinates of the shapes.
+     ** @param renderer Built with the atlas from GetGlyphAtlas(fontLook).
+     **/
+    void Draw(
+        DrawContext &context,
+        LabelRenderer &renderer,
+        const std::vector<Label> &labels,
+        const FontLook &fontLook);
+
+private:
+    bool IsCurrent_(
+        const std::vector<PlacedLabel> &placed,
+        const wxColour &color) const;
+
+    void Render_(
+        LabelRenderer &renderer,
+        std::vector<PlacedLabel> &&placed,
+        const wxColour &color,
+        const Size &size);
+
+private:
+    // Relative to the top left corner of the bitmap.
+    std::vector<PlacedLabel> placed_;
+    wxColour color_;
+    wxBitmap bitmap_;
+};
+
+
+} // end namespace draw
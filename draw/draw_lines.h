@@ -4,16 +4,17 @@
 #include <wxpex/wxshim.h>
 #include <wxpex/point.h>
 #include <wxpex/size.h>
+#include "draw/line_clipper.h"
 
 
 namespace draw
 {
 
 
-template<typename Line>
-void DrawLines(
+// Lines are clipped to the device context together by a LineClipper.
+inline void DrawLines(
     wxDC &dc,
-    const std::vector<Line> &lines)
+    const std::vector<LineClipper::Line> &lines)
 {
     auto size = wxpex::ToSize<double>(dc.GetSize());
     tau::Scale<double> scale;
@@ -22,18 +23,17 @@ void DrawLines(
 
     auto region = tau::Region<double>{{tau::Point2d<double>(0, 0), size}};
 
-    for (auto &line: lines)
-    {
-        auto endPoints = line.Intersect(region);
-
-        if (!endPoints)
-        {
-            continue;
-        }
+    LineClipper clipper(lines);
+    ClippedLines clipped;
+    clipper.Clip(region, &clipped);
 
+    for (size_t i = 0; i < clipped.GetCount(); ++i)
+    {
         dc.DrawLine(
-            wxpex::ToWxPoint(endPoints->first),
-            wxpex::ToWxPoint(endPoints->second));
+            wxpex::ToWxPoint(
+                tau::Point2d<double>(clipped.startX[i], clipped.startY[i])),
+            wxpex::ToWxPoint(
+                tau::Point2d<double>(clipped.endX[i], clipped.endY[i])));
     }
 }
 
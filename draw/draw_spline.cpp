@@ -8,60 +8,6 @@ namespace draw
 using Point = tau::Point2d<double>;
 
 
-std::vector<Point> GetDerivatives(
-    std::span<const Point> points,
-    const Point &firstDerivative,
-    const Point &lastDerivative)
-{
-    if (points.size() < 2)
-    {
-        return {};
-    }
-
-    std::vector<Point> result(points.size());
-
-    result.front() = firstDerivative;
-    result.back() = lastDerivative;
-
-    static constexpr double oneSixth = 1.0 / 6.0;
-
-    // For all intervening points, the tangent is average of the points that
-    // come before and after.
-    for (std::size_t i = 1; i + 1 < points.size(); ++i)
-    {
-        result[i] = oneSixth * (points[i + 1] - points[i - 1]);
-    }
-
-    return result;
-}
-
-
-std::vector<Point> GetDerivatives(std::span<const Point> points)
-{
-    if (points.size() < 2)
-    {
-        return {};
-    }
-
-    std::vector<Point> result(points.size());
-
-    // The first and last points define the tangent end points.
-    result.front() = points[1] - points[0];
-    result.back() = points.back() - points[points.size() - 2];
-
-    static constexpr double oneSixth = 1.0 / 6.0;
-
-    // For all intervening points, the tangent is average of the points that
-    // come before and after.
-    for (std::size_t i = 1; i + 1 < points.size(); ++i)
-    {
-        result[i] = oneSixth * (points[i + 1] - points[i - 1]);
-    }
-
-    return result;
-}
-
-
 void DrawTangentSpline(
     wxGraphicsPath &path,
     std::span<const Point> points,
@@ -110,4 +56,24 @@ void DrawTangentSpline(
 }
 
 
+void DrawTessellatedSpline(
+    wxGraphicsPath &path,
+    const SplineTessellation &tessellation)
+{
+    auto &points = tessellation.points;
+
+    if (points.size() < 2)
+    {
+        return;
+    }
+
+    path.MoveToPoint(points.front().x, points.front().y);
+
+    for (size_t i = 1; i < points.size(); ++i)
+    {
+        path.AddLineToPoint(points[i].x, points[i].y);
+    }
+}
+
+
 } // end namespace draw
@@ -6,6 +6,7 @@
 #include <wxpex/point.h>
 #include <span>
 #include <vector>
+#include "draw/spline_tessellator.h"
 
 
 namespace draw
@@ -27,8 +28,10 @@ void DrawTangentSpline(
     const tau::Point2d<double> &firstDerivative,
     const tau::Point2d<double> &lastDerivative);
 
-std::vector<tau::Point2d<double>> GetDerivatives(
-    std::span<const tau::Point2d<double>> points);
+// Add each segment of a tessellated spline as a line to the path.
+void DrawTessellatedSpline(
+    wxGraphicsPath &path,
+    const SplineTessellation &tessellation);
 
 
 } // end namespace draw
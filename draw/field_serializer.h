@@ -0,0 +1,439 @@
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "draw/detail/json_stream.h"
+#include "draw/detail/binary_stream.h"
+
+
+/**
+ ** Serializers driven by the fields:: descriptors of a type.
+ **
+ ** Structures are written member by member in the order of their fields
+ ** tuple, recursively. Members without fields must be arithmetic, enums,
+ ** strings, vectors, arrays, or optionals of those. Empty members without
+ ** fields, like the plain form of a signal, are not written.
+ **/
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+template<typename T>
+concept HasFieldsTuple = requires { T::fields; };
+
+
+template<typename T>
+concept IsSkippedField = std::is_empty_v<T> && !HasFieldsTuple<T>;
+
+
+template<typename T>
+struct IsVector_: std::false_type {};
+
+template<typename T, typename Allocator>
+struct IsVector_<std::vector<T, Allocator>>: std::true_type {};
+
+template<typename T>
+inline constexpr bool IsVector = IsVector_<T>::value;
+
+
+template<typename T>
+struct IsArray_: std::false_type {};
+
+template<typename T, size_t size>
+struct IsArray_<std::array<T, size>>: std::true_type {};
+
+template<typename T>
+inline constexpr bool IsArray = IsArray_<T>::value;
+
+
+template<typename T>
+struct IsOptional_: std::false_type {};
+
+template<typename T>
+struct IsOptional_<std::optional<T>>: std::true_type {};
+
+template<typename T>
+inline constexpr bool IsOptional = IsOptional_<T>::value;
+
+
+template<typename T, typename Function>
+void ForEachField(Function &&function)
+{
+    std::apply(
+        [&function](const auto &...field)
+        {
+            (function(field), ...);
+        },
+        T::fields);
+}
+
+
+template<typename T>
+struct UnsupportedField_: std::false_type {};
+
+
+} // end namespace detail
+
+
+template<typename T>
+void WriteJson(detail::JsonWriter &writer, const T &value)
+{
+    if constexpr (detail::HasFieldsTuple<T>)
+    {
+        writer.BeginObject();
+
+        detail::ForEachField<T>(
+            [&writer, &value](const auto &field)
+            {
+                using Member =
+                    std::remove_cvref_t<decltype(value.*(field.member))>;
+
+                if constexpr (!detail::IsSkippedField<Member>)
+                {
+                    writer.Key(field.name);
+                    WriteJson(writer, value.*(field.member));
+                }
+            });
+
+        writer.EndObject();
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        writer.Bool(value);
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        writer.Number(value);
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        writer.Number(static_cast<std::underlying_type_t<T>>(value));
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        writer.String(value);
+    }
+    else if constexpr (detail::IsVector<T> || detail::IsArray<T>)
+    {
+        writer.BeginArray();
+
+        for (auto &element: value)
+        {
+            WriteJson(writer, element);
+        }
+
+        writer.EndArray();
+    }
+    else if constexpr (detail::IsOptional<T>)
+    {
+        if (value)
+        {
+            WriteJson(writer, *value);
+        }
+        else
+        {
+            writer.Null();
+        }
+    }
+    else
+    {
+        static_assert(detail::UnsupportedField_<T>::value, "Unsupported type");
+    }
+}
+
+
+/**
+ ** Members missing from the JSON keep their current values, and unknown keys
+ ** are skipped, so files written by other versions can still be read.
+ **/
+template<typename T>
+void ReadJson(detail::JsonReader &reader, T &value)
+{
+    if constexpr (detail::HasFieldsTuple<T>)
+    {
+        reader.Expect('{');
+
+        if (reader.Consume('}'))
+        {
+            return;
+        }
+
+        do
+        {
+            std::string key(reader.ReadString());
+            reader.Expect(':');
+
+            bool isFound = false;
+
+            detail::ForEachField<T>(
+                [&](const auto &field)
+                {
+                    using Member =
+                        std::remove_cvref_t<decltype(value.*(field.member))>;
+
+                    if constexpr (!detail::IsSkippedField<Member>)
+                    {
+                        if (!isFound && key == field.name)
+                        {
+                            isFound = true;
+                            ReadJson(reader, value.*(field.member));
+                        }
+                    }
+                });
+
+            if (!isFound)
+            {
+                reader.SkipValue();
+            }
+        }
+        while (reader.Consume(','));
+
+        reader.Expect('}');
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        value = reader.ReadBool();
+    }
+    else if constexpr (std::is_arithmetic_v<T>)
+    {
+        value = reader.template ReadNumber<T>();
+    }
+    else if constexpr (std::is_enum_v<T>)
+    {
+        value = static_cast<T>(
+            reader.template ReadNumber<std::underlying_type_t<T>>());
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        value = std::string(reader.ReadString());
+    }
+    else if constexpr (detail::IsVector<T> || detail::IsArray<T>)
+    {
+        reader.Expect('[');
+
+        if constexpr (detail::IsVector<T>)
+        {
+            value.clear();
+        }
+
+        if (reader.Consume(']'))
+        {
+            return;
+        }
+
+        size_t index = 0;
+
+        do
+        {
+            if constexpr (detail::IsVector<T>)
+            {
+                ReadJson(reader, value.emplace_back());
+            }
+            else
+            {
+                if (index >= value.size())
+                {
+                    throw DrawError("Too many array elements");
+                }
+
+                ReadJson(reader, value[index++]);
+            }
+        }
+        while (reader.Consume(','));
+
+        reader.Expect(']');
+    }
+    else if constexpr (detail::IsOptional<T>)
+    {
+        if (reader.ReadNull())
+        {
+            value.reset();
+        }
+        else
+        {
+            ReadJson(reader, value.emplace());
+        }
+    }
+    else
+    {
+        static_assert(detail::UnsupportedField_<T>::value, "Unsupported type");
+    }
+}
+
+
+/**
+ ** The binary form has no keys. It must be read by the same version of the
+ ** type that wrote it.
+ **/
+template<typename T>
+void WriteBinary(detail::BinaryWriter &writer, const T &value)
+{
+    if constexpr (detail::HasFieldsTuple<T>)
+    {
+        detail::ForEachField<T>(
+            [&writer, &value](const auto &field)
+            {
+                using Member =
+                    std::remove_cvref_t<decltype(value.*(field.member))>;
+
+                if constexpr (!detail::IsSkippedField<Member>)
+                {
+                    WriteBinary(writer, value.*(field.member));
+                }
+            });
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        writer.Write(static_cast<uint8_t>(value));
+    }
+    else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        writer.Write(value);
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        writer.WriteString(value);
+    }
+    else if constexpr (detail::IsVector<T>)
+    {
+        using Element = typename T::value_type;
+
+        writer.Write(static_cast<uint32_t>(value.size()));
+
+        if constexpr (
+            std::is_arithmetic_v<Element> && !std::is_same_v<Element, bool>)
+        {
+            writer.WriteBytes(value.data(), value.size() * sizeof(Element));
+        }
+        else
+        {
+            for (auto &element: value)
+            {
+                WriteBinary(writer, element);
+            }
+        }
+    }
+    else if constexpr (detail::IsArray<T>)
+    {
+        for (auto &element: value)
+        {
+            WriteBinary(writer, element);
+        }
+    }
+    else if constexpr (detail::IsOptional<T>)
+    {
+        writer.Write(static_cast<uint8_t>(value.has_value()));
+
+        if (value)
+        {
+            WriteBinary(writer, *value);
+        }
+    }
+    else
+    {
+        static_assert(detail::UnsupportedField_<T>::value, "Unsupported type");
+    }
+}
+
+
+template<typename T>
+void ReadBinary(detail::BinaryReader &reader, T &value)
+{
+    if constexpr (detail::HasFieldsTuple<T>)
+    {
+        detail::ForEachField<T>(
+            [&reader, &value](const auto &field)
+            {
+                using Member =
+                    std::remove_cvref_t<decltype(value.*(field.member))>;
+
+                if constexpr (!detail::IsSkippedField<Member>)
+                {
+                    ReadBinary(reader, value.*(field.member));
+                }
+            });
+    }
+    else if constexpr (std::is_same_v<T, bool>)
+    {
+        value = (reader.template Read<uint8_t>() != 0);
+    }
+    else if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+    {
+        value = reader.template Read<T>();
+    }
+    else if constexpr (std::is_same_v<T, std::string>)
+    {
+        value = reader.ReadString();
+    }
+    else if constexpr (detail::IsVector<T>)
+    {
+        using Element = typename T::value_type;
+
+        auto count = reader.template Read<uint32_t>();
+
+        // The count has not been checked, so it must not decide how much is
+        // allocated before the bytes are known to exist.
+        if constexpr (
+            std::is_arithmetic_v<Element> && !std::is_same_v<Element, bool>)
+        {
+            if (count > reader.GetRemaining() / sizeof(Element))
+            {
+                throw DrawError("Unexpected end of binary shape");
+            }
+
+            value.resize(count);
+            reader.ReadBytes(value.data(), count * sizeof(Element));
+        }
+        else
+        {
+            value.clear();
+
+            // Each element is at least one byte, unless it has no fields.
+            value.reserve(std::min(size_t{count}, reader.GetRemaining()));
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                ReadBinary(reader, value.emplace_back());
+            }
+        }
+    }
+    else if constexpr (detail::IsArray<T>)
+    {
+        for (auto &element: value)
+        {
+            ReadBinary(reader, element);
+        }
+    }
+    else if constexpr (detail::IsOptional<T>)
+    {
+        if (reader.template Read<uint8_t>())
+        {
+            ReadBinary(reader, value.emplace());
+        }
+        else
+        {
+            value.reset();
+        }
+    }
+    else
+    {
+        static_assert(detail::UnsupportedField_<T>::value, "Unsupported type");
+    }
+}
+
+
+} // end namespace draw
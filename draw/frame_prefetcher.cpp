@@ -0,0 +1,240 @@
+#include "draw/frame_prefetcher.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iostream>
+#include <iterator>
+
+
+namespace draw
+{
+
+
+FramePrefetcher::FramePrefetcher(
+    std::shared_ptr<FrameSequence> frameSequence,
+    AsyncPixelsControl pixels,
+    size_t lookAhead,
+    size_t cacheFrameCount,
+    size_t threadCount)
+    :
+    mutex_(),
+    frameSequence_(frameSequence),
+    pixels_(pixels),
+    lookAhead_(lookAhead),
+
+    // Leave room for the current frame and every frame ahead of it.
+    cacheFrameCount_(std::max(cacheFrameCount, lookAhead + 1)),
+
+    isRunning_(true),
+    current_(),
+    step_(1),
+    queue_(),
+    loading_(),
+    frames_(),
+    hasRequestCondition_(),
+    threads_()
+{
+    threadCount = std::max(threadCount, size_t{1});
+
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        this->threads_.emplace_back(std::bind(&FramePrefetcher::Run_, this));
+    }
+}
+
+
+FramePrefetcher::~FramePrefetcher()
+{
+    this->Shutdown();
+}
+
+
+void FramePrefetcher::Seek(size_t index)
+{
+    auto frameCount = this->frameSequence_->GetFrameCount();
+
+    if (index >= frameCount)
+    {
+        return;
+    }
+
+    pex::WriteLock lock(this->mutex_);
+
+    if (this->current_)
+    {
+        auto delta = static_cast<ptrdiff_t>(index)
+            - static_cast<ptrdiff_t>(*this->current_);
+
+        if (delta != 0)
+        {
+            // The size of the step sets the spacing of the frames that
+            // are decoded ahead.
+            this->step_ = delta;
+        }
+    }
+
+    this->current_ = index;
+
+    // Frames queued for the previous position, or for the previous
+    // direction, are dropped.
+    this->queue_.clear();
+
+    auto found = this->frames_.find(index);
+
+    if (found != this->frames_.end())
+    {
+        this->pixels_.Set(found->second);
+    }
+    else if (!this->loading_.count(index))
+    {
+        this->queue_.push_back(index);
+    }
+
+    auto next = static_cast<ptrdiff_t>(index);
+
+    for (size_t i = 0; i < this->lookAhead_; ++i)
+    {
+        next += this->step_;
+
+        if (next < 0 || next >= static_cast<ptrdiff_t>(frameCount))
+        {
+            break;
+        }
+
+        auto nextIndex = static_cast<size_t>(next);
+
+        if (!this->IsAvailable_(nextIndex))
+        {
+            this->queue_.push_back(nextIndex);
+        }
+    }
+
+    if (!this->queue_.empty())
+    {
+        this->hasRequestCondition_.notify_all();
+    }
+}
+
+
+void FramePrefetcher::Shutdown()
+{
+    {
+        pex::WriteLock lock(this->mutex_);
+        this->isRunning_ = false;
+
+        // Wake up workers so they will exit.
+        this->hasRequestCondition_.notify_all();
+    }
+
+    for (auto &thread: this->threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+
+bool FramePrefetcher::IsAvailable_(size_t index) const
+{
+    return this->frames_.count(index) || this->loading_.count(index);
+}
+
+
+void FramePrefetcher::Evict_()
+{
+    assert(this->current_);
+
+    auto current = *this->current_;
+
+    auto distance = [current](size_t index) -> size_t
+    {
+        return (index > current) ? index - current : current - index;
+    };
+
+    while (this->frames_.size() > this->cacheFrameCount_)
+    {
+        // The frames are ordered by index, so the furthest frame is at one
+        // end or the other.
+        auto first = this->frames_.begin();
+        auto last = std::prev(this->frames_.end());
+
+        if (distance(first->first) >= distance(last->first))
+        {
+            this->frames_.erase(first);
+        }
+        else
+        {
+            this->frames_.erase(last);
+        }
+    }
+}
+
+
+void FramePrefetcher::Run_()
+{
+    while (true)
+    {
+        size_t index;
+
+        {
+            pex::WriteLock lock(this->mutex_);
+
+            this->hasRequestCondition_.wait(
+                lock,
+                [this]
+                {
+                    return !this->queue_.empty() || !this->isRunning_;
+                });
+
+            if (!this->isRunning_)
+            {
+                return;
+            }
+
+            index = this->queue_.front();
+            this->queue_.pop_front();
+
+            if (this->IsAvailable_(index))
+            {
+                continue;
+            }
+
+            this->loading_.insert(index);
+        }
+
+        std::shared_ptr<Pixels> pixels;
+
+        try
+        {
+            pixels = this->frameSequence_->LoadFrame(index);
+        }
+        catch (const std::exception &error)
+        {
+            std::cerr << "Failed to load frame " << index << ": "
+                << error.what() << std::endl;
+        }
+
+        pex::WriteLock lock(this->mutex_);
+        this->loading_.erase(index);
+
+        if (!pixels)
+        {
+            continue;
+        }
+
+        this->frames_[index] = pixels;
+        this->Evict_();
+
+        if (this->current_ == index)
+        {
+            // The playhead is waiting for this frame.
+            this->pixels_.Set(pixels);
+        }
+    }
+}
+
+
+} // end namespace draw
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <deque>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include <pex/locks.h>
+
+#include "draw/pixels.h"
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** A sequence of frames decoded on demand, e.g. from a video file.
+ **/
+class FrameSequence
+{
+public:
+    virtual ~FrameSequence() = default;
+
+    virtual size_t GetFrameCount() const = 0;
+
+    /**
+     ** Called from the prefetch threads, possibly for several frames at once.
+     ** May throw if the frame cannot be decoded.
+     **/
+    virtual std::shared_ptr<Pixels> LoadFrame(size_t index) = 0;
+};
+
+
+/**
+ ** Publishes frames for scrubbing, decoding ahead of the playhead.
+ **
+ ** Each Seek publishes the requested frame as soon as it is available. Frames
+ ** further along in the direction of travel, spaced by the size of the last
+ ** step, are decoded on background threads. Reversing direction cancels the
+ ** queued frames.
+ **/
+class FramePrefetcher
+{
+public:
+    static constexpr size_t defaultLookAhead = 8;
+    static constexpr size_t defaultCacheFrameCount = 64;
+
+    FramePrefetcher(
+        std::shared_ptr<FrameSequence> frameSequence,
+        AsyncPixelsControl pixels,
+        size_t lookAhead = defaultLookAhead,
+        size_t cacheFrameCount = defaultCacheFrameCount,
+        size_t threadCount = detail::GetThreadCount());
+
+    ~FramePrefetcher();
+
+    FramePrefetcher(const FramePrefetcher &) = delete;
+    FramePrefetcher & operator=(const FramePrefetcher &) = delete;
+
+    void Seek(size_t index);
+
+    void Shutdown();
+
+private:
+    bool IsAvailable_(size_t index) const;
+
+    // Remove the cached frames furthest from the current frame.
+    void Evict_();
+
+    void Run_();
+
+private:
+    mutable pex::Mutex mutex_;
+    std::shared_ptr<FrameSequence> frameSequence_;
+    AsyncPixelsControl pixels_;
+    size_t lookAhead_;
+    size_t cacheFrameCount_;
+    bool isRunning_;
+
+    std::optional<size_t> current_;
+    ptrdiff_t step_;
+
+    // The most urgent frame is first.
+    std::deque<size_t> queue_;
+
+    std::set<size_t> loading_;
+    std::map<size_t, std::shared_ptr<Pixels>> frames_;
+    std::condition_variable_any hasRequestCondition_;
+    std::vector<std::thread> threads_;
+};
+
+
+} // end namespace draw
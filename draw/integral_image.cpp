@@ -0,0 +1,418 @@
+#include "draw/integral_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tau/vector2d.h>
+
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+// Fewer rows than this are summed on the calling thread.
+static constexpr Eigen::Index minimumIntegralBand = 64;
+
+
+/**
+ ** Fill summed-area tables with one more row and column than the image, so
+ ** that sums(row, column) is the total of the pixels above and left of it.
+ **
+ ** The tables keep their memory when their size is unchanged.
+ **
+ ** @param pixelStride The number of values between horizontally adjacent
+ ** pixels of one channel.
+ **/
+static void BuildIntegral(
+    const uint8_t *data,
+    Eigen::Index pixelStride,
+    Eigen::Index width,
+    Eigen::Index height,
+    detail::SumTable *sums,
+    detail::SquareTable *squares)
+{
+    sums->resize(height + 1, width + 1);
+    squares->resize(height + 1, width + 1);
+    sums->row(0).setZero();
+    squares->row(0).setZero();
+
+    // Rows are summed independently.
+    detail::ParallelBands(
+        height,
+        minimumIntegralBand,
+        [&](Eigen::Index beginRow, Eigen::Index endRow)
+        {
+            for (auto row = beginRow; row < endRow; ++row)
+            {
+                const uint8_t *source = data + row * width * pixelStride;
+                uint32_t *sumRow = sums->row(row + 1).data();
+                uint64_t *squareRow = squares->row(row + 1).data();
+                uint32_t sum = 0;
+                uint64_t square = 0;
+
+                sumRow[0] = 0;
+                squareRow[0] = 0;
+
+                for (Eigen::Index column = 0; column < width; ++column)
+                {
+                    uint32_t value = source[column * pixelStride];
+
+                    sum += value;
+                    square += value * value;
+                    sumRow[column + 1] = sum;
+                    squareRow[column + 1] = square;
+                }
+            }
+        });
+
+    // Then each band of columns is summed downwards.
+    detail::ParallelBands(
+        width + 1,
+        minimumIntegralBand,
+        [&](Eigen::Index beginColumn, Eigen::Index endColumn)
+        {
+            auto count = endColumn - beginColumn;
+
+            for (Eigen::Index row = 1; row <= height; ++row)
+            {
+                sums->row(row).segment(beginColumn, count) +=
+                    sums->row(row - 1).segment(beginColumn, count);
+
+                squares->row(row).segment(beginColumn, count) +=
+                    squares->row(row - 1).segment(beginColumn, count);
+            }
+        });
+}
+
+
+double RegionStatistics::GetMean(size_t channel) const
+{
+    if (this->count == 0.0)
+    {
+        return 0.0;
+    }
+
+    return this->sums.at(channel) / this->count;
+}
+
+
+double RegionStatistics::GetVariance(size_t channel) const
+{
+    if (this->count == 0.0)
+    {
+        return 0.0;
+    }
+
+    auto mean = this->GetMean(channel);
+
+    // Rounding can leave a tiny negative variance for flat regions.
+    return std::max(
+        this->sumsOfSquares.at(channel) / this->count - mean * mean,
+        0.0);
+}
+
+
+double RegionStatistics::GetStandardDeviation(size_t channel) const
+{
+    return std::sqrt(this->GetVariance(channel));
+}
+
+
+IntegralImage::IntegralImage()
+    :
+    width_(0),
+    height_(0),
+    sums_(),
+    squares_()
+{
+
+}
+
+
+IntegralImage::IntegralImage(const Pixels &pixels)
+    :
+    IntegralImage()
+{
+    this->Assign(pixels);
+}
+
+
+IntegralImage::IntegralImage(const Gray<uint8_t> &gray)
+    :
+    IntegralImage()
+{
+    this->Assign(gray);
+}
+
+
+void IntegralImage::Assign(const Pixels &pixels)
+{
+    this->width_ = static_cast<Eigen::Index>(pixels.size.width);
+    this->height_ = static_cast<Eigen::Index>(pixels.size.height);
+    this->sums_.resize(3);
+    this->squares_.resize(3);
+
+    // The channels are interleaved.
+    for (size_t channel = 0; channel < 3; ++channel)
+    {
+        BuildIntegral(
+            pixels.data.data() + channel,
+            3,
+            this->width_,
+            this->height_,
+            &this->sums_[channel],
+            &this->squares_[channel]);
+    }
+}
+
+
+void IntegralImage::Assign(const Gray<uint8_t> &gray)
+{
+    this->width_ = gray.cols();
+    this->height_ = gray.rows();
+    this->sums_.resize(1);
+    this->squares_.resize(1);
+
+    BuildIntegral(
+        gray.data(),
+        1,
+        this->width_,
+        this->height_,
+        &this->sums_[0],
+        &this->squares_[0]);
+}
+
+
+Size IntegralImage::GetSize() const
+{
+    return Size(
+        static_cast<SizeType>(this->width_),
+        static_cast<SizeType>(this->height_));
+}
+
+
+size_t IntegralImage::GetChannelCount() const
+{
+    return this->sums_.size();
+}
+
+
+RegionStatistics IntegralImage::GetBox(
+    Eigen::Index left,
+    Eigen::Index top,
+    Eigen::Index right,
+    Eigen::Index bottom) const
+{
+    auto result = this->MakeEmpty_();
+
+    left = std::clamp(left, Eigen::Index{0}, this->width_);
+    right = std::clamp(right, Eigen::Index{0}, this->width_);
+    top = std::clamp(top, Eigen::Index{0}, this->height_);
+    bottom = std::clamp(bottom, Eigen::Index{0}, this->height_);
+
+    if (left >= right || top >= bottom)
+    {
+        return result;
+    }
+
+    result.count = static_cast<double>((right - left) * (bottom - top));
+
+    // Each band is small enough for its sum to fit in 32 bits.
+    auto bandRows = std::max(
+        maximumExactPixels / (right - left),
+        Eigen::Index{1});
+
+    for (auto bandTop = top; bandTop < bottom; bandTop += bandRows)
+    {
+        auto bandBottom = std::min(bandTop + bandRows, bottom);
+
+        auto sumBox = [&](const auto &table)
+        {
+            // Unsigned arithmetic cancels the wrapping of the sums.
+            return table(bandBottom, right) - table(bandTop, right)
+                - table(bandBottom, left) + table(bandTop, left);
+        };
+
+        for (size_t channel = 0; channel < this->sums_.size(); ++channel)
+        {
+            result.sums[channel] +=
+                static_cast<double>(sumBox(this->sums_[channel]));
+
+            result.sumsOfSquares[channel] +=
+                static_cast<double>(sumBox(this->squares_[channel]));
+        }
+    }
+
+    return result;
+}
+
+
+RegionStatistics IntegralImage::GetPolygon(const PointsDouble &points) const
+{
+    auto result = this->MakeEmpty_();
+
+    if (points.size() < 3)
+    {
+        return result;
+    }
+
+    auto [lowest, highest] = std::minmax_element(
+        points.begin(),
+        points.end(),
+        [](const PointDouble &first, const PointDouble &second)
+        {
+            return first.y < second.y;
+        });
+
+    auto firstRow = std::max(
+        static_cast<Eigen::Index>(std::floor(lowest->y)),
+        Eigen::Index{0});
+
+    auto endRow = std::min(
+        static_cast<Eigen::Index>(std::ceil(highest->y)),
+        this->height_);
+
+    std::vector<double> crossings;
+
+    for (auto row = firstRow; row < endRow; ++row)
+    {
+        auto y = static_cast<double>(row) + 0.5;
+        crossings.clear();
+
+        for (size_t i = 0; i < points.size(); ++i)
+        {
+            auto &start = points[i];
+            auto &end = points[(i + 1) % points.size()];
+
+            if ((start.y <= y) != (end.y <= y))
+            {
+                crossings.push_back(
+                    start.x
+                    + (y - start.y) * (end.x - start.x) / (end.y - start.y));
+            }
+        }
+
+        std::sort(crossings.begin(), crossings.end());
+
+        for (size_t i = 0; i + 1 < crossings.size(); i += 2)
+        {
+            this->AddSpan_(row, crossings[i], crossings[i + 1], &result);
+        }
+    }
+
+    return result;
+}
+
+
+RegionStatistics IntegralImage::GetEllipse(const EllipseRegion &ellipse) const
+{
+    auto result = this->MakeEmpty_();
+
+    if (ellipse.semiMajor <= 0.0 || ellipse.semiMinor <= 0.0)
+    {
+        return result;
+    }
+
+    auto major = tau::Vector2d<double>(1.0, 0.0).Rotate(ellipse.rotation);
+    auto minor = tau::Vector2d<double>(0.0, 1.0).Rotate(ellipse.rotation);
+
+    auto majorSquared = ellipse.semiMajor * ellipse.semiMajor;
+    auto minorSquared = ellipse.semiMinor * ellipse.semiMinor;
+
+    // A point at offset (dx, dy) from the center is inside when
+    // a dx^2 + b dx dy + c dy^2 <= 1.
+    auto a = major.x * major.x / majorSquared
+        + minor.x * minor.x / minorSquared;
+
+    auto b = 2.0
+        * (major.x * major.y / majorSquared + minor.x * minor.y / minorSquared);
+
+    auto c = major.y * major.y / majorSquared
+        + minor.y * minor.y / minorSquared;
+
+    auto halfHeight = std::sqrt(
+        majorSquared * major.y * major.y + minorSquared * minor.y * minor.y);
+
+    auto firstRow = std::max(
+        static_cast<Eigen::Index>(std::floor(ellipse.center.y - halfHeight)),
+        Eigen::Index{0});
+
+    auto endRow = std::min(
+        static_cast<Eigen::Index>(std::ceil(ellipse.center.y + halfHeight)),
+        this->height_);
+
+    for (auto row = firstRow; row < endRow; ++row)
+    {
+        auto dy = static_cast<double>(row) + 0.5 - ellipse.center.y;
+        auto linear = b * dy;
+        auto constant = c * dy * dy - 1.0;
+        auto discriminant = linear * linear - 4.0 * a * constant;
+
+        if (discriminant < 0.0)
+        {
+            continue;
+        }
+
+        auto root = std::sqrt(discriminant);
+
+        this->AddSpan_(
+            row,
+            ellipse.center.x + (-linear - root) / (2.0 * a),
+            ellipse.center.x + (-linear + root) / (2.0 * a),
+            &result);
+    }
+
+    return result;
+}
+
+
+RegionStatistics IntegralImage::MakeEmpty_() const
+{
+    RegionStatistics result;
+    result.sums.resize(this->sums_.size(), 0.0);
+    result.sumsOfSquares.resize(this->sums_.size(), 0.0);
+
+    return result;
+}
+
+
+void IntegralImage::AddSpan_(
+    Eigen::Index row,
+    double begin,
+    double end,
+    RegionStatistics *statistics) const
+{
+    // The first and last columns with centers in the span.
+    auto left = static_cast<Eigen::Index>(std::ceil(begin - 0.5));
+    auto right = static_cast<Eigen::Index>(std::ceil(end - 0.5));
+
+    left = std::clamp(left, Eigen::Index{0}, this->width_);
+    right = std::clamp(right, Eigen::Index{0}, this->width_);
+
+    if (left >= right)
+    {
+        return;
+    }
+
+    statistics->count += static_cast<double>(right - left);
+
+    // A row is narrower than maximumExactPixels, so its sum is exact.
+    auto sumSpan = [&](const auto &table)
+    {
+        return table(row + 1, right) - table(row, right)
+            - table(row + 1, left) + table(row, left);
+    };
+
+    for (size_t channel = 0; channel < this->sums_.size(); ++channel)
+    {
+        statistics->sums[channel] +=
+            static_cast<double>(sumSpan(this->sums_[channel]));
+
+        statistics->sumsOfSquares[channel] +=
+            static_cast<double>(sumSpan(this->squares_[channel]));
+    }
+}
+
+
+} // end namespace draw
@@ -0,0 +1,128 @@
+#pragma once
+
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include <tau/eigen.h>
+#include "draw/gray.h"
+#include "draw/pixels.h"
+#include "draw/points.h"
+#include "draw/size.h"
+
+
+namespace draw
+{
+
+
+struct RegionStatistics
+{
+    // The number of pixels in the region.
+    double count = 0.0;
+
+    // One value for each channel.
+    std::vector<double> sums;
+    std::vector<double> sumsOfSquares;
+
+    double GetMean(size_t channel) const;
+
+    double GetVariance(size_t channel) const;
+
+    double GetStandardDeviation(size_t channel) const;
+};
+
+
+struct EllipseRegion
+{
+    PointDouble center;
+    double semiMajor;
+    double semiMinor;
+
+    // Degrees, as in Ellipse.
+    double rotation;
+};
+
+
+namespace detail
+{
+
+
+// The sums of 8-bit values wrap, but the difference of two sums is exact
+// while the pixels between them sum to less than 2^32.
+using SumTable =
+    Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+using SquareTable =
+    Eigen::Matrix<uint64_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+
+} // end namespace detail
+
+
+/**
+ ** Summed-area tables of the values and squared values of each channel of
+ ** an 8-bit image.
+ **
+ ** The sum over any rectangle is found from four values of a table, and the
+ ** sum over any other shape from two values for each row it covers. Each
+ ** channel keeps 32-bit sums and 64-bit squares, 12 bytes for each pixel.
+ ** Boxes of more than maximumExactPixels are summed in bands of rows, so
+ ** the 32-bit sums do not overflow.
+ **
+ ** Assign builds the tables of a new frame in the memory of the last one.
+ **
+ ** A pixel is in a shape when its center is inside.
+ **/
+class IntegralImage
+{
+public:
+    static constexpr Eigen::Index maximumExactPixels =
+        std::numeric_limits<uint32_t>::max() / 255;
+
+    IntegralImage();
+
+    IntegralImage(const Pixels &pixels);
+
+    IntegralImage(const Gray<uint8_t> &gray);
+
+    void Assign(const Pixels &pixels);
+
+    void Assign(const Gray<uint8_t> &gray);
+
+    Size GetSize() const;
+
+    size_t GetChannelCount() const;
+
+    // The pixels in columns [left, right) and rows [top, bottom), clipped to
+    // the image.
+    RegionStatistics GetBox(
+        Eigen::Index left,
+        Eigen::Index top,
+        Eigen::Index right,
+        Eigen::Index bottom) const;
+
+    // The pixels inside the polygon, by the even-odd rule.
+    RegionStatistics GetPolygon(const PointsDouble &points) const;
+
+    RegionStatistics GetEllipse(const EllipseRegion &ellipse) const;
+
+private:
+    RegionStatistics MakeEmpty_() const;
+
+    // Add the pixels of one row with centers from begin up to end.
+    void AddSpan_(
+        Eigen::Index row,
+        double begin,
+        double end,
+        RegionStatistics *statistics) const;
+
+private:
+    Eigen::Index width_;
+    Eigen::Index height_;
+    std::vector<detail::SumTable> sums_;
+    std::vector<detail::SquareTable> squares_;
+};
+
+
+} // end namespace draw
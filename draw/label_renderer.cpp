@@ -0,0 +1,274 @@
+#include "draw/label_renderer.h"
+
+#include <cmath>
+#include "draw/error.h"
+
+
+namespace draw
+{
+
+
+static constexpr size_t glyphCount =
+    GlyphAtlas::lastCharacter - GlyphAtlas::firstCharacter + 1;
+
+
+GlyphAtlas::GlyphAtlas(
+    Coverage coverage,
+    std::vector<Glyph> glyphs,
+    int lineHeight)
+    :
+    coverage_(std::move(coverage)),
+    glyphs_(std::move(glyphs)),
+    lineHeight_(lineHeight)
+{
+    if (this->glyphs_.size() != glyphCount)
+    {
+        throw DrawError("Expected one glyph for each printable character");
+    }
+
+    for (auto &glyph: this->glyphs_)
+    {
+        bool isInside = glyph.x >= 0
+            && glyph.y >= 0
+            && glyph.width >= 0
+            && glyph.height >= 0
+            && glyph.x + glyph.width <= this->coverage_.cols()
+            && glyph.y + glyph.height <= this->coverage_.rows();
+
+        if (!isInside)
+        {
+            throw DrawError("Glyph is outside of the atlas");
+        }
+    }
+}
+
+
+const Glyph & GlyphAtlas::GetGlyph(char character) const
+{
+    if (character < firstCharacter || character > lastCharacter)
+    {
+        character = missingCharacter;
+    }
+
+    return this->glyphs_[static_cast<size_t>(character - firstCharacter)];
+}
+
+
+const GlyphAtlas::Coverage & GlyphAtlas::GetCoverage() const
+{
+    return this->coverage_;
+}
+
+
+int GlyphAtlas::GetLineHeight() const
+{
+    return this->lineHeight_;
+}
+
+
+LabelRenderer::LabelRenderer(
+    std::shared_ptr<const GlyphAtlas> atlas,
+    size_t maximumLayouts)
+    :
+    atlas_(atlas),
+    maximumLayouts_(maximumLayouts),
+    layouts_(),
+    cells_()
+{
+    if (!this->atlas_)
+    {
+        throw DrawError("LabelRenderer requires an atlas");
+    }
+}
+
+
+const GlyphAtlas & LabelRenderer::GetAtlas() const
+{
+    return *this->atlas_;
+}
+
+
+std::shared_ptr<const LabelLayout> LabelRenderer::GetLayout(
+    const std::string &text)
+{
+    auto found = this->layouts_.find(text);
+
+    if (found != this->layouts_.end())
+    {
+        return found->second;
+    }
+
+    auto layout = std::make_shared<LabelLayout>();
+    layout->quads.reserve(text.size());
+    layout->height = this->atlas_->GetLineHeight();
+
+    for (auto character: text)
+    {
+        auto &glyph = this->atlas_->GetGlyph(character);
+
+        if (glyph.width > 0 && glyph.height > 0)
+        {
+            layout->quads.push_back(
+                {glyph.x, glyph.y, layout->width, glyph.width, glyph.height});
+        }
+
+        layout->width += glyph.advance;
+    }
+
+    if (this->layouts_.size() >= this->maximumLayouts_)
+    {
+        // Labels that are still drawn are laid out again on the next call.
+        this->layouts_.clear();
+    }
+
+    this->layouts_.emplace(text, layout);
+
+    return layout;
+}
+
+
+namespace
+{
+
+
+struct Box
+{
+    int left;
+    int top;
+    int right;
+    int bottom;
+
+    bool Overlaps(const Box &other) const
+    {
+        return this->left < other.right
+            && other.left < this->right
+            && this->top < other.bottom
+            && other.top < this->bottom;
+    }
+};
+
+
+} // end anonymous namespace
+
+
+std::vector<PlacedLabel> LabelRenderer::Place(
+    const std::vector<Label> &labels,
+    const tau::Region<double> &viewport,
+    int padding)
+{
+    std::vector<PlacedLabel> result;
+
+    auto viewLeft = static_cast<int>(std::floor(viewport.topLeft.x));
+    auto viewTop = static_cast<int>(std::floor(viewport.topLeft.y));
+
+    auto viewBox = Box{
+        viewLeft,
+        viewTop,
+        static_cast<int>(
+            std::ceil(viewport.topLeft.x + viewport.size.width)),
+        static_cast<int>(
+            std::ceil(viewport.topLeft.y + viewport.size.height))};
+
+    if (viewBox.right <= viewBox.left || viewBox.bottom <= viewBox.top)
+    {
+        return result;
+    }
+
+    // Cells a few lines tall keep the candidates for each label short.
+    auto cellSize = std::max(4 * this->atlas_->GetLineHeight(), 16);
+    auto columnCount = (viewBox.right - viewBox.left) / cellSize + 1;
+    auto rowCount = (viewBox.bottom - viewBox.top) / cellSize + 1;
+
+    this->cells_.resize(static_cast<size_t>(columnCount * rowCount));
+
+    for (auto &cell: this->cells_)
+    {
+        cell.clear();
+    }
+
+    auto toColumn = [&](int x)
+    {
+        return std::clamp((x - viewLeft) / cellSize, 0, columnCount - 1);
+    };
+
+    auto toRow = [&](int y)
+    {
+        return std::clamp((y - viewTop) / cellSize, 0, rowCount - 1);
+    };
+
+    std::vector<Box> accepted;
+
+    for (auto &label: labels)
+    {
+        if (label.text.empty())
+        {
+            continue;
+        }
+
+        auto x = static_cast<int>(std::round(label.position.x));
+        auto y = static_cast<int>(std::round(label.position.y));
+        auto layout = this->GetLayout(label.text);
+
+        auto box = Box{
+            x - padding,
+            y - padding,
+            x + layout->width + padding,
+            y + layout->height + padding};
+
+        if (!box.Overlaps(viewBox))
+        {
+            continue;
+        }
+
+        auto firstColumn = toColumn(box.left);
+        auto lastColumn = toColumn(box.right - 1);
+        auto firstRow = toRow(box.top);
+        auto lastRow = toRow(box.bottom - 1);
+
+        bool overlaps = false;
+
+        for (int row = firstRow; row <= lastRow && !overlaps; ++row)
+        {
+            for (int column = firstColumn; column <= lastColumn; ++column)
+            {
+                auto &cell = this->cells_[
+                    static_cast<size_t>(row * columnCount + column)];
+
+                overlaps = std::any_of(
+                    cell.begin(),
+                    cell.end(),
+                    [&](size_t index)
+                    {
+                        return accepted[index].Overlaps(box);
+                    });
+
+                if (overlaps)
+                {
+                    break;
+                }
+            }
+        }
+
+        if (overlaps)
+        {
+            continue;
+        }
+
+        for (int row = firstRow; row <= lastRow; ++row)
+        {
+            for (int column = firstColumn; column <= lastColumn; ++column)
+            {
+                this->cells_[static_cast<size_t>(row * columnCount + column)]
+                    .push_back(accepted.size());
+            }
+        }
+
+        accepted.push_back(box);
+        result.push_back({layout, x, y});
+    }
+
+    return result;
+}
+
+
+} // end namespace draw
@@ -0,0 +1,214 @@
+#pragma once
+
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <tau/region.h>
+#include "draw/gray.h"
+#include "draw/points.h"
+#include "draw/size.h"
+
+
+/**
+ ** Text labels drawn from a cache of rasterized glyphs.
+ **
+ ** A GlyphAtlas holds the coverage of each printable ASCII character for one
+ ** font size. A LabelRenderer lays out each string once, places labels so
+ ** that none are outside of the view or overlap, and blends them into any
+ ** raster target. Colors are applied while blending, so one atlas serves
+ ** every color.
+ **
+ ** Only building an atlas from a font needs wx (see draw_labels.h). Placing
+ ** and rendering labels can be done on any thread.
+ **/
+
+
+namespace draw
+{
+
+
+struct Glyph
+{
+    // The glyph's rectangle in the atlas.
+    int x;
+    int y;
+    int width;
+    int height;
+
+    // The distance to the next glyph.
+    int advance;
+};
+
+
+class GlyphAtlas
+{
+public:
+    static constexpr char firstCharacter = ' ';
+    static constexpr char lastCharacter = '~';
+
+    // Characters outside of the atlas are drawn as this one.
+    static constexpr char missingCharacter = '?';
+
+    using Coverage = Gray<uint8_t>;
+
+    /**
+     ** @param glyphs One glyph for each character from firstCharacter to
+     ** lastCharacter.
+     **/
+    GlyphAtlas(Coverage coverage, std::vector<Glyph> glyphs, int lineHeight);
+
+    const Glyph & GetGlyph(char character) const;
+
+    const Coverage & GetCoverage() const;
+
+    int GetLineHeight() const;
+
+private:
+    Coverage coverage_;
+    std::vector<Glyph> glyphs_;
+    int lineHeight_;
+};
+
+
+// The glyphs of one string, relative to its top left corner.
+struct LabelLayout
+{
+    struct GlyphQuad
+    {
+        int sourceX;
+        int sourceY;
+        int targetX;
+        int width;
+        int height;
+    };
+
+    std::vector<GlyphQuad> quads;
+    int width = 0;
+    int height = 0;
+};
+
+
+struct Label
+{
+    std::string text;
+
+    // The top left corner of the label.
+    PointDouble position;
+};
+
+
+struct PlacedLabel
+{
+    std::shared_ptr<const LabelLayout> layout;
+    int x;
+    int y;
+};
+
+
+class LabelRenderer
+{
+public:
+    static constexpr size_t defaultMaximumLayouts = 16384;
+
+    // Empty space kept around each label when removing overlaps.
+    static constexpr int defaultPadding = 2;
+
+    LabelRenderer(
+        std::shared_ptr<const GlyphAtlas> atlas,
+        size_t maximumLayouts = defaultMaximumLayouts);
+
+    const GlyphAtlas & GetAtlas() const;
+
+    // Layouts are cached by text, until maximumLayouts are cached.
+    std::shared_ptr<const LabelLayout> GetLayout(const std::string &text);
+
+    /**
+     ** Choose the labels to draw.
+     **
+     ** Labels that are entirely outside of the viewport are dropped. A label
+     ** that overlaps one earlier in the list is dropped, so labels should be
+     ** given in order of importance.
+     **
+     ** @param labels Positions in the pixels of the target.
+     **/
+    std::vector<PlacedLabel> Place(
+        const std::vector<Label> &labels,
+        const tau::Region<double> &viewport,
+        int padding = defaultPadding);
+
+    /**
+     ** Blend the placed labels into a raster target, like the targets of a
+     ** RasterContext. Glyphs are clipped to the target.
+     **/
+    template<typename Target>
+    void Render(
+        Target &target,
+        const std::vector<PlacedLabel> &placed,
+        const typename Target::Color &color,
+        double alpha = 1.0) const
+    {
+        auto size = target.GetSize();
+        auto &coverage = this->atlas_->GetCoverage();
+
+        // Blend expects coverage indexed by the column of the target.
+        std::vector<float> rowCoverage(static_cast<size_t>(size.width));
+
+        for (auto &label: placed)
+        {
+            for (auto &quad: label.layout->quads)
+            {
+                auto left = label.x + quad.targetX;
+                auto begin = std::max(left, 0);
+                auto end = std::min(left + quad.width, int(size.width));
+
+                if (begin >= end)
+                {
+                    continue;
+                }
+
+                auto firstRow = std::max(label.y, 0);
+
+                auto lastRow =
+                    std::min(label.y + quad.height, int(size.height));
+
+                for (int row = firstRow; row < lastRow; ++row)
+                {
+                    auto source = coverage.row(quad.sourceY + row - label.y);
+
+                    for (int column = begin; column < end; ++column)
+                    {
+                        rowCoverage[static_cast<size_t>(column)] =
+                            static_cast<float>(
+                                source(quad.sourceX + column - left))
+                            / 255.0f;
+                    }
+
+                    target.Blend(
+                        row,
+                        begin,
+                        end,
+                        rowCoverage.data(),
+                        color,
+                        alpha);
+                }
+            }
+        }
+    }
+
+private:
+    std::shared_ptr<const GlyphAtlas> atlas_;
+    size_t maximumLayouts_;
+
+    std::unordered_map<std::string, std::shared_ptr<const LabelLayout>>
+        layouts_;
+
+    // Labels accepted by Place, by cell of the viewport.
+    std::vector<std::vector<size_t>> cells_;
+};
+
+
+} // end namespace draw
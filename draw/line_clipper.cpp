@@ -0,0 +1,206 @@
+#include "draw/line_clipper.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <utility>
+
+
+namespace draw
+{
+
+
+LineClipper::LineClipper()
+    :
+    lineCount_(0),
+    families_(),
+    pointX_(),
+    pointY_(),
+    enter_(),
+    exit_()
+{
+
+}
+
+
+LineClipper::LineClipper(const std::vector<Line> &lines)
+    :
+    LineClipper()
+{
+    this->Assign(lines);
+}
+
+
+void LineClipper::Assign(const std::vector<Line> &lines)
+{
+    this->lineCount_ = lines.size();
+    this->families_.clear();
+    this->pointX_.clear();
+    this->pointY_.clear();
+
+    // Lines with the same direction, or opposite directions, share a family.
+    std::map<std::pair<double, double>, std::vector<size_t>> directions;
+
+    for (size_t i = 0; i < lines.size(); ++i)
+    {
+        auto &line = lines[i];
+        auto length = std::hypot(line.vector.x, line.vector.y);
+
+        if (length == 0.0)
+        {
+            // A line without a direction is never drawn.
+            continue;
+        }
+
+        auto x = line.vector.x / length;
+        auto y = line.vector.y / length;
+
+        if (x < 0.0 || (x == 0.0 && y < 0.0))
+        {
+            x = -x;
+            y = -y;
+        }
+
+        directions[{x, y}].push_back(i);
+    }
+
+    this->pointX_.reserve(lines.size());
+    this->pointY_.reserve(lines.size());
+
+    for (auto &[direction, indices]: directions)
+    {
+        auto begin = this->pointX_.size();
+
+        for (auto index: indices)
+        {
+            this->pointX_.push_back(lines[index].point.x);
+            this->pointY_.push_back(lines[index].point.y);
+        }
+
+        this->families_.push_back(
+            {begin, this->pointX_.size(), direction.first, direction.second});
+    }
+}
+
+
+size_t LineClipper::GetCount() const
+{
+    return this->lineCount_;
+}
+
+
+size_t LineClipper::GetFamilyCount() const
+{
+    return this->families_.size();
+}
+
+
+void LineClipper::Clip(
+    const tau::Region<double> &region,
+    ClippedLines *result)
+{
+    result->Clear();
+
+    auto count = this->pointX_.size();
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    this->enter_.resize(count);
+    this->exit_.resize(count);
+
+    auto xMinimum = region.topLeft.x;
+    auto yMinimum = region.topLeft.y;
+    auto xMaximum = xMinimum + region.size.width;
+    auto yMaximum = yMinimum + region.size.height;
+
+    constexpr auto infinity = std::numeric_limits<double>::infinity();
+
+    for (auto &family: this->families_)
+    {
+        auto familyCount = family.end - family.begin;
+        const double *pointX = this->pointX_.data() + family.begin;
+        const double *pointY = this->pointY_.data() + family.begin;
+        double *enter = this->enter_.data() + family.begin;
+        double *exit = this->exit_.data() + family.begin;
+
+        if (family.directionY == 0.0)
+        {
+            // Horizontal, with a direction of (1, 0).
+            for (size_t i = 0; i < familyCount; ++i)
+            {
+                bool isInside =
+                    pointY[i] >= yMinimum && pointY[i] <= yMaximum;
+
+                enter[i] = isInside ? xMinimum - pointX[i] : infinity;
+                exit[i] = isInside ? xMaximum - pointX[i] : -infinity;
+            }
+
+            continue;
+        }
+
+        if (family.directionX == 0.0)
+        {
+            // Vertical, with a direction of (0, 1).
+            for (size_t i = 0; i < familyCount; ++i)
+            {
+                bool isInside =
+                    pointX[i] >= xMinimum && pointX[i] <= xMaximum;
+
+                enter[i] = isInside ? yMinimum - pointY[i] : infinity;
+                exit[i] = isInside ? yMaximum - pointY[i] : -infinity;
+            }
+
+            continue;
+        }
+
+        // The direction of a family always points right, so it enters at the
+        // left edge. Which horizontal edge it enters depends on the sign of
+        // directionY.
+        auto inverseX = 1.0 / family.directionX;
+        auto inverseY = 1.0 / family.directionY;
+
+        auto yEnterEdge = (family.directionY > 0.0) ? yMinimum : yMaximum;
+        auto yExitEdge = (family.directionY > 0.0) ? yMaximum : yMinimum;
+
+        for (size_t i = 0; i < familyCount; ++i)
+        {
+            auto enterX = (xMinimum - pointX[i]) * inverseX;
+            auto exitX = (xMaximum - pointX[i]) * inverseX;
+            auto enterY = (yEnterEdge - pointY[i]) * inverseY;
+            auto exitY = (yExitEdge - pointY[i]) * inverseY;
+
+            enter[i] = std::max(enterX, enterY);
+            exit[i] = std::min(exitX, exitY);
+        }
+    }
+
+    // Keep the lines that cross the region.
+    for (auto &family: this->families_)
+    {
+        for (auto i = family.begin; i < family.end; ++i)
+        {
+            auto enter = this->enter_[i];
+            auto exit = this->exit_[i];
+
+            if (enter > exit)
+            {
+                continue;
+            }
+
+            auto x = this->pointX_[i];
+            auto y = this->pointY_[i];
+
+            result->startX.push_back(x + enter * family.directionX);
+            result->startY.push_back(y + enter * family.directionY);
+            result->endX.push_back(x + exit * family.directionX);
+            result->endY.push_back(y + exit * family.directionY);
+        }
+    }
+}
+
+
+} // end namespace draw
@@ -0,0 +1,96 @@
+#pragma once
+
+
+#include <cstddef>
+#include <vector>
+#include <tau/line2d.h>
+#include <tau/region.h>
+
+
+namespace draw
+{
+
+
+// The visible part of each line, as separate arrays of coordinates.
+struct ClippedLines
+{
+    std::vector<double> startX;
+    std::vector<double> startY;
+    std::vector<double> endX;
+    std::vector<double> endY;
+
+    size_t GetCount() const
+    {
+        return this->startX.size();
+    }
+
+    void Clear()
+    {
+        this->startX.clear();
+        this->startY.clear();
+        this->endX.clear();
+        this->endY.clear();
+    }
+};
+
+
+/**
+ ** Clips many infinite lines to a region in one pass.
+ **
+ ** Lines are grouped into families that share a direction, like the rows or
+ ** columns of a grid. The Liang-Barsky edge parameters of a family are found
+ ** once, and its lines are clipped in a branch-free loop over packed arrays
+ ** that the compiler can vectorize.
+ **
+ ** Clipped lines are grouped by family, so their order may differ from the
+ ** order of the lines, and a line may come back with its ends swapped.
+ **/
+class LineClipper
+{
+public:
+    using Line = tau::Line2d<double>;
+
+    LineClipper();
+
+    LineClipper(const std::vector<Line> &lines);
+
+    void Assign(const std::vector<Line> &lines);
+
+    // The number of lines assigned, including any without a direction.
+    size_t GetCount() const;
+
+    size_t GetFamilyCount() const;
+
+    /**
+     ** Lines that only touch a corner of the region are kept as segments of
+     ** zero length.
+     **
+     ** @param result Cleared, then filled with the visible segments.
+     **/
+    void Clip(const tau::Region<double> &region, ClippedLines *result);
+
+private:
+    struct Family
+    {
+        size_t begin;
+        size_t end;
+
+        // The shared direction, with a length of one.
+        double directionX;
+        double directionY;
+    };
+
+    size_t lineCount_;
+    std::vector<Family> families_;
+
+    // A point on each line, ordered by family.
+    std::vector<double> pointX_;
+    std::vector<double> pointY_;
+
+    // The entering and exiting parameters, reused between calls to Clip.
+    std::vector<double> enter_;
+    std::vector<double> exit_;
+};
+
+
+} // end namespace draw
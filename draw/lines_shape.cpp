@@ -21,12 +21,27 @@ LinesShape::LinesShape(
     const Lines &lines)
     :
     settings_(settings),
-    lines_(lines)
+    lines_(lines),
+    clipper_(lines),
+    clipped_()
 {
 
 }
 
 
+const LinesShape::Lines & LinesShape::GetLines() const
+{
+    return this->lines_;
+}
+
+
+void LinesShape::SetLines(const Lines &lines)
+{
+    this->lines_ = lines;
+    this->clipper_.Assign(this->lines_);
+}
+
+
 void LinesShape::Draw(DrawContext &context)
 {
     if (this->lines_.empty())
@@ -50,19 +65,14 @@ void LinesShape::Draw(DrawContext &context)
         auto region =
             tau::Region<double>{{-1.0 * translation, size}};
 
-        for (auto &line: this->lines_)
-        {
-            auto endPoints = line.Intersect(region);
+        this->clipper_.Clip(region, &this->clipped_);
 
-            if (!endPoints)
-            {
-                continue;
-            }
+        auto &clipped = this->clipped_;
 
-            auto start = endPoints->first;
-            auto end = endPoints->second;
-            path.MoveToPoint(start.x, start.y);
-            path.AddLineToPoint(end.x, end.y);
+        for (size_t i = 0; i < clipped.GetCount(); ++i)
+        {
+            path.MoveToPoint(clipped.startX[i], clipped.startY[i]);
+            path.AddLineToPoint(clipped.endX[i], clipped.endY[i]);
             path.CloseSubpath();
         }
     }
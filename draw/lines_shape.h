@@ -5,6 +5,7 @@
 #include <tau/line2d.h>
 #include "draw/look.h"
 #include "draw/shapes.h"
+#include "draw/line_clipper.h"
 
 
 namespace draw
@@ -59,8 +60,19 @@ public:
 
     void Draw(DrawContext &context) override;
 
+    const Lines & GetLines() const;
+
+    // Replace the lines, and group them again for clipping.
+    void SetLines(const Lines &lines);
+
     LinesShapeSettings settings_;
+
+private:
     Lines lines_;
+
+    // Grouped by direction when the lines are assigned.
+    LineClipper clipper_;
+    ClippedLines clipped_;
 };
 
 
@@ -0,0 +1,96 @@
+#include "draw/packed_pixels.h"
+
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+PackedPixels::PackedPixels()
+    :
+    size(),
+    data()
+{
+
+}
+
+
+PackedPixels::PackedPixels(const Size &size_)
+    :
+    size(size_),
+    data(size_.height, size_.width)
+{
+
+}
+
+
+std::shared_ptr<PackedPixels> PackedPixels::CreateShared(const Size &size_)
+{
+    return std::make_shared<PackedPixels>(size_);
+}
+
+
+std::shared_ptr<PackedPixels> ToPacked(const Pixels &pixels)
+{
+    using Index = Pixels::Index;
+
+    auto result = PackedPixels::CreateShared(
+        Size(
+            static_cast<SizeType>(pixels.size.width),
+            static_cast<SizeType>(pixels.size.height)));
+
+    const uint8_t *input = pixels.data.data();
+    uint32_t *output = result->data.data();
+    auto width = pixels.size.width;
+
+    detail::ParallelBands(
+        pixels.size.height,
+        Index{64},
+        [=](Index beginRow, Index endRow)
+        {
+            for (auto i = beginRow * width; i < endRow * width; ++i)
+            {
+                auto rgb = input + 3 * i;
+
+                output[i] = PackedPixels::Pack(rgb[0], rgb[1], rgb[2]);
+            }
+        });
+
+    return result;
+}
+
+
+std::shared_ptr<Pixels> ToRgb(const PackedPixels &packedPixels)
+{
+    using Index = Pixels::Index;
+
+    auto result = Pixels::CreateShared(
+        tau::Size<Index>(
+            static_cast<Index>(packedPixels.size.width),
+            static_cast<Index>(packedPixels.size.height)));
+
+    const uint32_t *input = packedPixels.data.data();
+    uint8_t *output = result->data.data();
+    auto width = static_cast<Index>(packedPixels.size.width);
+
+    detail::ParallelBands(
+        static_cast<Index>(packedPixels.size.height),
+        Index{64},
+        [=](Index beginRow, Index endRow)
+        {
+            for (auto i = beginRow * width; i < endRow * width; ++i)
+            {
+                auto rgb = output + 3 * i;
+
+                rgb[0] = PackedPixels::GetRed(input[i]);
+                rgb[1] = PackedPixels::GetGreen(input[i]);
+                rgb[2] = PackedPixels::GetBlue(input[i]);
+            }
+        });
+
+    return result;
+}
+
+
+} // end namespace draw
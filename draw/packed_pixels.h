@@ -0,0 +1,115 @@
+#pragma once
+
+
+#include <cstdint>
+#include <memory>
+#include <pex/endpoint.h>
+#include <tau/eigen.h>
+#include <wxpex/async.h>
+
+#include "draw/pixels.h"
+#include "draw/size.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** The byte offsets of each channel in a packed pixel, in the order used by
+ ** the platform's 32-bit bitmaps (wxAlphaPixelFormat).
+ **/
+struct PackedLayout
+{
+#if defined(__WXMSW__)
+    static constexpr int blue = 0;
+    static constexpr int green = 1;
+    static constexpr int red = 2;
+    static constexpr int alpha = 3;
+#elif defined(__WXOSX__)
+    static constexpr int alpha = 0;
+    static constexpr int red = 1;
+    static constexpr int green = 2;
+    static constexpr int blue = 3;
+#else
+    static constexpr int red = 0;
+    static constexpr int green = 1;
+    static constexpr int blue = 2;
+    static constexpr int alpha = 3;
+#endif
+};
+
+
+/**
+ ** Four bytes per pixel, in the memory layout of the platform's bitmaps.
+ **
+ ** Rows are contiguous and each pixel is 32-bit aligned, so generators can
+ ** write whole pixels, and the display copies rows without converting them.
+ **/
+struct PackedPixels
+{
+    using Data =
+        Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+    Size size;
+
+    // One row of the matrix for each row of pixels.
+    Data data;
+
+    PackedPixels();
+
+    PackedPixels(const Size &size_);
+
+    static std::shared_ptr<PackedPixels> CreateShared(const Size &size_);
+
+    static uint32_t Pack(
+        uint8_t red,
+        uint8_t green,
+        uint8_t blue,
+        uint8_t alpha = 255)
+    {
+        uint32_t result = 0;
+        auto bytes = reinterpret_cast<uint8_t *>(&result);
+
+        bytes[PackedLayout::red] = red;
+        bytes[PackedLayout::green] = green;
+        bytes[PackedLayout::blue] = blue;
+        bytes[PackedLayout::alpha] = alpha;
+
+        return result;
+    }
+
+    static uint8_t GetRed(uint32_t pixel)
+    {
+        return reinterpret_cast<const uint8_t *>(&pixel)[PackedLayout::red];
+    }
+
+    static uint8_t GetGreen(uint32_t pixel)
+    {
+        return reinterpret_cast<const uint8_t *>(&pixel)[PackedLayout::green];
+    }
+
+    static uint8_t GetBlue(uint32_t pixel)
+    {
+        return reinterpret_cast<const uint8_t *>(&pixel)[PackedLayout::blue];
+    }
+};
+
+
+// Opaque packed pixels with the colors of RGB pixels.
+std::shared_ptr<PackedPixels> ToPacked(const Pixels &pixels);
+
+// RGB pixels with the colors of packed pixels, without alpha.
+std::shared_ptr<Pixels> ToRgb(const PackedPixels &packedPixels);
+
+
+using AsyncPackedPixels = wxpex::MakeAsync<std::shared_ptr<PackedPixels>>;
+
+using AsyncPackedPixelsModel = typename AsyncPackedPixels::Model;
+using AsyncPackedPixelsControl = typename AsyncPackedPixelsModel::Unfiltered;
+
+using PackedPixelsControl =
+    typename AsyncPackedPixels::Control<AsyncPackedPixelsModel>;
+
+
+} // end namespace draw
@@ -0,0 +1,235 @@
+#include "draw/palette.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "draw/detail/cpu.h"
+#include "draw/detail/parallel.h"
+#include "draw/trace.h"
+
+
+#ifdef DRAW_X86_TARGETS
+#define DRAW_PALETTE_GATHER
+#endif
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+// Fewer pixels than this are mapped on the calling thread.
+static constexpr Eigen::Index minimumPaletteBand = 64 * 1024;
+
+
+inline void CopyColor(
+    const uint8_t *rgb,
+    size_t lastIndex,
+    uint16_t index,
+    uint8_t *output)
+{
+    std::memcpy(output, rgb + 3 * std::min(size_t{index}, lastIndex), 3);
+}
+
+
+#ifdef DRAW_PALETTE_GATHER
+
+/**
+ ** Map count indices, eight at a time.
+ **
+ ** Each group of eight writes exactly its own 24 bytes, so bands mapped by
+ ** other threads and the end of the output are never touched.
+ **
+ ** @return The number of indices mapped.
+ **/
+__attribute__((target("avx2")))
+size_t GatherColors(
+    const int32_t *packed,
+    size_t lastIndex,
+    const uint16_t *indices,
+    size_t count,
+    uint8_t *output)
+{
+    auto last = _mm256_set1_epi32(static_cast<int>(lastIndex));
+
+    // Drop the fourth byte of each color, leaving 12 bytes in each lane.
+    auto compact = _mm256_setr_epi8(
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1,
+        0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+
+    size_t i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        auto index = _mm256_cvtepu16_epi32(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(indices + i)));
+
+        index = _mm256_min_epu32(index, last);
+
+        auto colors = _mm256_i32gather_epi32(packed, index, 4);
+        colors = _mm256_shuffle_epi8(colors, compact);
+
+        auto target = output + 3 * i;
+
+        auto high = _mm256_extracti128_si256(colors, 1);
+
+        // The 4 bytes past the first 12 colors are replaced by the second.
+        _mm_storeu_si128(
+            reinterpret_cast<__m128i *>(target),
+            _mm256_castsi256_si128(colors));
+
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(target + 12), high);
+
+        auto last4 = _mm_extract_epi32(high, 2);
+        std::memcpy(target + 20, &last4, 4);
+    }
+
+    return i;
+}
+
+#endif
+
+
+} // end namespace detail
+
+
+Palette::Palette()
+    :
+    rgb_(),
+    packed_(),
+    useSimd_(true)
+{
+
+}
+
+
+Palette::Palette(const PixelMatrix &colors)
+    :
+    rgb_(static_cast<size_t>(colors.rows()) * 3),
+    packed_(static_cast<size_t>(colors.rows())),
+    useSimd_(true)
+{
+    for (Eigen::Index row = 0; row < colors.rows(); ++row)
+    {
+        auto index = static_cast<size_t>(row);
+        auto red = colors(row, 0);
+        auto green = colors(row, 1);
+        auto blue = colors(row, 2);
+
+        this->rgb_[3 * index] = red;
+        this->rgb_[3 * index + 1] = green;
+        this->rgb_[3 * index + 2] = blue;
+
+        this->packed_[index] = static_cast<int32_t>(
+            uint32_t{red}
+            | (uint32_t{green} << 8)
+            | (uint32_t{blue} << 16));
+    }
+}
+
+
+size_t Palette::GetSize() const
+{
+    return this->packed_.size();
+}
+
+
+void Palette::SetUseSimd(bool useSimd)
+{
+    this->useSimd_ = useSimd;
+}
+
+
+void Palette::Apply(const Waveform &indices, PixelMatrix *output) const
+{
+    DRAW_TRACE_SCOPE("palette.apply");
+
+    output->resize(indices.size(), 3);
+
+    if (indices.size() == 0)
+    {
+        return;
+    }
+
+    if (this->packed_.empty())
+    {
+        output->setZero();
+
+        return;
+    }
+
+    auto minimumBand = std::max(
+        Eigen::Index{1},
+        detail::minimumPaletteBand / std::max(indices.cols(), Eigen::Index{1}));
+
+    uint8_t *data = output->data();
+
+    detail::ParallelBands(
+        indices.rows(),
+        minimumBand,
+        [this, &indices, data](Eigen::Index begin, Eigen::Index end)
+        {
+            this->ApplyRows_(indices, begin, end, data);
+        });
+}
+
+
+void Palette::ApplyRows_(
+    const Waveform &indices,
+    Eigen::Index beginRow,
+    Eigen::Index endRow,
+    uint8_t *output) const
+{
+    auto first = static_cast<size_t>(beginRow * indices.cols());
+    auto count = static_cast<size_t>((endRow - beginRow) * indices.cols());
+
+    // Waveform is row major, so the band is contiguous.
+    this->Apply(indices.data() + first, count, output + 3 * first);
+}
+
+
+void Palette::Apply(
+    const uint16_t *source,
+    size_t count,
+    uint8_t *target) const
+{
+    if (this->packed_.empty())
+    {
+        std::memset(target, 0, 3 * count);
+
+        return;
+    }
+
+    auto lastIndex = this->packed_.size() - 1;
+    size_t mapped = 0;
+
+#ifdef DRAW_PALETTE_GATHER
+    if (
+        this->useSimd_
+        && this->packed_.size() <= maximumGatherSize
+        && detail::HasAvx2())
+    {
+        mapped = detail::GatherColors(
+            this->packed_.data(),
+            lastIndex,
+            source,
+            count,
+            target);
+    }
+#endif
+
+    for (size_t i = mapped; i < count; ++i)
+    {
+        detail::CopyColor(
+            this->rgb_.data(),
+            lastIndex,
+            source[i],
+            target + 3 * i);
+    }
+}
+
+
+} // end namespace draw
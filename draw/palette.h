@@ -0,0 +1,69 @@
+#pragma once
+
+
+#include <cstdint>
+#include <vector>
+
+#include "draw/pixels.h"
+#include "draw/waveform.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** Maps an image of palette indices to interleaved RGB pixels.
+ **
+ ** The result is the same as tau::BasicColorMap, with one RGB row per index.
+ ** Palettes of up to maximumGatherSize colors are looked up eight pixels at
+ ** a time with AVX2 gathers when the processor supports them. Bands of rows
+ ** are mapped in parallel.
+ **/
+class Palette
+{
+public:
+    static constexpr size_t maximumGatherSize = 256;
+
+    Palette();
+
+    // @param colors One RGB row per palette index.
+    Palette(const PixelMatrix &colors);
+
+    size_t GetSize() const;
+
+    /**
+     ** Indices past the end of the palette use the last color.
+     **
+     ** @param output Resized to one row per index.
+     **/
+    void Apply(const Waveform &indices, PixelMatrix *output) const;
+
+    // Map count indices to exactly 3 * count bytes of interleaved RGB.
+    void Apply(
+        const uint16_t *indices,
+        size_t count,
+        uint8_t *output) const;
+
+    // Disable the SIMD path, e.g. to compare against it.
+    void SetUseSimd(bool useSimd);
+
+private:
+    void ApplyRows_(
+        const Waveform &indices,
+        Eigen::Index beginRow,
+        Eigen::Index endRow,
+        uint8_t *output) const;
+
+private:
+    // Three bytes for each color.
+    std::vector<uint8_t> rgb_;
+
+    // Each color packed into the low three bytes, for gathering.
+    std::vector<int32_t> packed_;
+
+    bool useSimd_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,332 @@
+#include "draw/parade.h"
+
+#include <mutex>
+#include <vector>
+
+#include "draw/error.h"
+#include "draw/palette.h"
+#include "draw/trace.h"
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+ParadeSettings::ParadeSettings()
+    :
+    layout(ParadeLayout::sideBySide),
+    includeLuma(false),
+    levelCount(WaveformSettings::defaultLevelCount),
+    columnCount(WaveformSettings::defaultColumnCount),
+    verticalScale(WaveformSettings::defaultVerticalZoom),
+    colors{}
+{
+    static constexpr std::array<double, 3> hues{0.0, 120.0, 240.0};
+
+    for (size_t i = 0; i < hues.size(); ++i)
+    {
+        this->colors[i].color.hue = hues[i];
+    }
+
+    auto &luma = this->colors[static_cast<size_t>(ParadeChannel::luma)];
+    luma.color.saturation = 0.0;
+}
+
+
+size_t ParadeSettings::GetChannelCount() const
+{
+    return this->includeLuma ? paradeChannelCount : paradeChannelCount - 1;
+}
+
+
+const WaveformColor & ParadeSettings::GetColor(ParadeChannel channel) const
+{
+    return this->colors.at(static_cast<size_t>(channel));
+}
+
+
+namespace
+{
+
+
+// The first value of each color channel, and the distances between values.
+struct ParadePlanes
+{
+    std::array<const uint8_t *, 3> channels;
+    Eigen::Index pixelStride;
+    Eigen::Index rowStride;
+    Eigen::Index width;
+    Eigen::Index height;
+};
+
+
+// Accumulated by column, so the levels of one column share cache lines.
+using ParadeCounts = Eigen::Matrix<uint16_t, Eigen::Dynamic, Eigen::Dynamic>;
+
+
+// Fewer rows than this are counted on the calling thread.
+static constexpr Eigen::Index minimumParadeBand = 64;
+
+
+ParadeHistograms GenerateParade(
+    const ParadePlanes &planes,
+    size_t levelCount,
+    size_t columnCount,
+    bool includeLuma)
+{
+    DRAW_TRACE_SCOPE("parade.histogram");
+
+    if (levelCount < 1 || columnCount < 1)
+    {
+        throw DrawError("Parade requires levels and columns");
+    }
+
+    auto levels = static_cast<Eigen::Index>(levelCount);
+    auto columns = static_cast<Eigen::Index>(columnCount);
+    auto channelCount = includeLuma ? paradeChannelCount : 3;
+
+    std::array<ParadeCounts, paradeChannelCount> totals;
+
+    for (size_t i = 0; i < channelCount; ++i)
+    {
+        totals[i] = ParadeCounts::Zero(levels, columns);
+    }
+
+    // Scale values and columns as DoGenerateWaveform does, and look up the
+    // row of each of the 256 values once.
+    auto maximum = levels - 1;
+    std::array<Eigen::Index, 256> valueRows;
+
+    auto valueMultiplier =
+        1.0f / (255.0f / static_cast<float>(maximum));
+
+    for (Eigen::Index value = 0; value < 256; ++value)
+    {
+        auto level = (maximum == 255)
+            ? value
+            : FloatToIndex(static_cast<float>(value) * valueMultiplier);
+
+        valueRows[static_cast<size_t>(value)] = maximum - level;
+    }
+
+    auto columnMultiplier = 1.0f / (
+        static_cast<float>(planes.width - 1)
+        / static_cast<float>(columns - 1));
+
+    std::vector<Eigen::Index> targetColumns(
+        static_cast<size_t>(planes.width));
+
+    for (Eigen::Index column = 0; column < planes.width; ++column)
+    {
+        targetColumns[static_cast<size_t>(column)] = (planes.width > 1)
+            ? FloatToIndex(static_cast<float>(column) * columnMultiplier)
+            : 0;
+    }
+
+    std::mutex totalsMutex;
+
+    detail::ParallelBands(
+        planes.height,
+        minimumParadeBand,
+        [&](Eigen::Index beginRow, Eigen::Index endRow)
+        {
+            std::array<ParadeCounts, paradeChannelCount> counts;
+
+            for (size_t i = 0; i < channelCount; ++i)
+            {
+                counts[i] = ParadeCounts::Zero(levels, columns);
+            }
+
+            auto stride = planes.pixelStride;
+
+            for (auto row = beginRow; row < endRow; ++row)
+            {
+                auto offset = row * planes.rowStride;
+                auto red = planes.channels[0] + offset;
+                auto green = planes.channels[1] + offset;
+                auto blue = planes.channels[2] + offset;
+
+                for (Eigen::Index column = 0; column < planes.width; ++column)
+                {
+                    auto target = targetColumns[static_cast<size_t>(column)];
+                    auto r = red[column * stride];
+                    auto g = green[column * stride];
+                    auto b = blue[column * stride];
+
+                    counts[0](valueRows[r], target) += 1;
+                    counts[1](valueRows[g], target) += 1;
+                    counts[2](valueRows[b], target) += 1;
+
+                    if (includeLuma)
+                    {
+                        // Rec. 709 weights, in 256ths.
+                        auto luma = (54 * r + 183 * g + 19 * b + 128) >> 8;
+                        counts[3](valueRows[luma], target) += 1;
+                    }
+                }
+            }
+
+            std::lock_guard lock(totalsMutex);
+
+            for (size_t i = 0; i < channelCount; ++i)
+            {
+                totals[i] += counts[i];
+            }
+        });
+
+    ParadeHistograms result;
+
+    for (size_t i = 0; i < channelCount; ++i)
+    {
+        result[i] = totals[i];
+    }
+
+    return result;
+}
+
+
+} // end anonymous namespace
+
+
+ParadeHistograms GenerateParade(
+    const Pixels &pixels,
+    size_t levelCount,
+    size_t columnCount,
+    bool includeLuma)
+{
+    auto width = static_cast<Eigen::Index>(pixels.size.width);
+    auto data = pixels.data.data();
+
+    return GenerateParade(
+        ParadePlanes{
+            {data, data + 1, data + 2},
+            3,
+            3 * width,
+            width,
+            static_cast<Eigen::Index>(pixels.size.height)},
+        levelCount,
+        columnCount,
+        includeLuma);
+}
+
+
+ParadeHistograms GenerateParade(
+    const PlanarRgb<uint8_t> &planar,
+    size_t levelCount,
+    size_t columnCount,
+    bool includeLuma)
+{
+    const auto &red = tau::GetRed(planar);
+
+    return GenerateParade(
+        ParadePlanes{
+            {
+                red.data(),
+                tau::GetGreen(planar).data(),
+                tau::GetBlue(planar).data()},
+            1,
+            red.cols(),
+            red.cols(),
+            red.rows()},
+        levelCount,
+        columnCount,
+        includeLuma);
+}
+
+
+void RenderParade(
+    const ParadeHistograms &histograms,
+    const ParadeSettings &paradeSettings,
+    const Size &imageSize,
+    PixelMatrix *output)
+{
+    DRAW_TRACE_SCOPE("parade.render");
+
+    auto width = static_cast<Eigen::Index>(imageSize.width);
+    auto height = static_cast<Eigen::Index>(imageSize.height);
+
+    *output = PixelMatrix::Zero(width * height, 3);
+
+    auto channelCount = paradeSettings.GetChannelCount();
+    PixelMatrix pane;
+
+    for (size_t i = 0; i < channelCount; ++i)
+    {
+        auto &histogram = histograms[i];
+
+        if (histogram.size() == 0)
+        {
+            continue;
+        }
+
+        Eigen::Index left = 0;
+        Eigen::Index paneWidth = width;
+
+        if (paradeSettings.layout == ParadeLayout::sideBySide)
+        {
+            auto count = static_cast<Eigen::Index>(channelCount);
+            auto index = static_cast<Eigen::Index>(i);
+
+            left = width * index / count;
+            paneWidth = width * (index + 1) / count - left;
+        }
+
+        if (paneWidth <= 0 || height <= 0)
+        {
+            continue;
+        }
+
+        auto &color = paradeSettings.GetColor(static_cast<ParadeChannel>(i));
+        WaveformColormap::Rescale rescale(0, color.count - 1);
+        Waveform rescaled = rescale(histogram);
+        Palette palette(MakeWaveformColorRange(color, color.color));
+
+        palette.Apply(
+            Resize(
+                rescaled,
+                Size(
+                    static_cast<SizeType>(paneWidth),
+                    static_cast<SizeType>(height)),
+                paradeSettings.verticalScale),
+            &pane);
+
+        // Panes side by side do not overlap, and overlaid channels add.
+        for (Eigen::Index row = 0; row < height; ++row)
+        {
+            auto target = output->middleRows(row * width + left, paneWidth);
+            auto source = pane.middleRows(row * paneWidth, paneWidth);
+
+            target = (target.template cast<int>() + source.template cast<int>())
+                .cwiseMin(255)
+                .template cast<uint8_t>();
+        }
+    }
+}
+
+
+std::shared_ptr<Pixels> RenderParade(
+    const Pixels &pixels,
+    const ParadeSettings &paradeSettings,
+    const Size &imageSize)
+{
+    if (imageSize.width == 0 || imageSize.height == 0)
+    {
+        return {};
+    }
+
+    auto histograms = GenerateParade(
+        pixels,
+        paradeSettings.levelCount,
+        paradeSettings.columnCount,
+        paradeSettings.includeLuma);
+
+    auto result = Pixels::CreateShared(imageSize);
+
+    RenderParade(histograms, paradeSettings, imageSize, &result->data);
+
+    return result;
+}
+
+
+} // end namespace draw
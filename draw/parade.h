@@ -0,0 +1,102 @@
+#pragma once
+
+
+#include <array>
+#include <memory>
+
+#include "draw/pixels.h"
+#include "draw/planar.h"
+#include "draw/waveform_engine.h"
+
+
+/**
+ ** RGB parade and overlay waveforms.
+ **
+ ** The red, green, blue and luma histograms are built together in one pass
+ ** over the image, so each pixel is read once instead of once per channel.
+ **/
+
+
+namespace draw
+{
+
+
+enum class ParadeLayout
+{
+    // Each channel in its own pane, from left to right.
+    sideBySide,
+
+    // Every channel over the full image, with the colors added together.
+    overlay
+};
+
+
+enum class ParadeChannel
+{
+    red,
+    green,
+    blue,
+    luma
+};
+
+
+static constexpr size_t paradeChannelCount = 4;
+
+
+struct ParadeSettings
+{
+    ParadeLayout layout;
+
+    // Luma is the Rec. 709 weighted sum of the channels.
+    bool includeLuma;
+
+    size_t levelCount;
+    size_t columnCount;
+    double verticalScale;
+
+    // Indexed by ParadeChannel.
+    std::array<WaveformColor, paradeChannelCount> colors;
+
+    ParadeSettings();
+
+    size_t GetChannelCount() const;
+
+    const WaveformColor & GetColor(ParadeChannel channel) const;
+};
+
+
+// Histograms with the layout returned by DoGenerateWaveform, indexed by
+// ParadeChannel. The luma histogram is empty unless it was requested.
+using ParadeHistograms = std::array<Waveform, paradeChannelCount>;
+
+
+ParadeHistograms GenerateParade(
+    const Pixels &pixels,
+    size_t levelCount,
+    size_t columnCount,
+    bool includeLuma);
+
+
+ParadeHistograms GenerateParade(
+    const PlanarRgb<uint8_t> &planar,
+    size_t levelCount,
+    size_t columnCount,
+    bool includeLuma);
+
+
+// @param output Resized to one row for each pixel of imageSize.
+void RenderParade(
+    const ParadeHistograms &histograms,
+    const ParadeSettings &paradeSettings,
+    const Size &imageSize,
+    PixelMatrix *output);
+
+
+// @return nullptr when the image size is empty.
+std::shared_ptr<Pixels> RenderParade(
+    const Pixels &pixels,
+    const ParadeSettings &paradeSettings,
+    const Size &imageSize);
+
+
+} // end namespace draw
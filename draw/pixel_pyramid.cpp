@@ -0,0 +1,232 @@
+#include "draw/pixel_pyramid.h"
+
+#include <cassert>
+#include <cmath>
+#include <functional>
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+std::shared_ptr<Pixels> Downsample(const Pixels &pixels)
+{
+    using Index = Pixels::Index;
+
+    static_assert(
+        Pixels::Data::IsRowMajor,
+        "Expected interleaved color channels");
+
+    auto size = pixels.size;
+    auto halved = size;
+    halved.width = (size.width + 1) / 2;
+    halved.height = (size.height + 1) / 2;
+
+    auto result = Pixels::CreateShared(halved);
+
+    const uint8_t *input = pixels.data.data();
+    uint8_t *output = result->data.data();
+
+    auto inputStride = static_cast<size_t>(size.width) * 3;
+    auto outputStride = static_cast<size_t>(halved.width) * 3;
+
+    detail::ParallelBands(
+        halved.height,
+        Index{32},
+        [=](Index beginRow, Index endRow)
+        {
+            for (Index row = beginRow; row < endRow; ++row)
+            {
+                auto top = input + static_cast<size_t>(2 * row) * inputStride;
+
+                auto bottom = (2 * row + 1 < size.height)
+                    ? top + inputStride
+                    : top;
+
+                auto target = output + static_cast<size_t>(row) * outputStride;
+
+                for (Index column = 0; column < halved.width; ++column)
+                {
+                    auto left = static_cast<size_t>(2 * column) * 3;
+
+                    auto right = (2 * column + 1 < size.width)
+                        ? left + 3
+                        : left;
+
+                    for (size_t channel = 0; channel < 3; ++channel)
+                    {
+                        unsigned sum = 2u
+                            + top[left + channel]
+                            + top[right + channel]
+                            + bottom[left + channel]
+                            + bottom[right + channel];
+
+                        *target++ = static_cast<uint8_t>(sum / 4);
+                    }
+                }
+            }
+        });
+
+    return result;
+}
+
+
+size_t SelectPyramidLevel(const tau::Scale<double> &scale, size_t levelCount)
+{
+    if (levelCount < 2)
+    {
+        return 0;
+    }
+
+    auto largest = std::max(scale.horizontal, scale.vertical);
+
+    if (largest >= 1.0 || largest <= 0.0)
+    {
+        return 0;
+    }
+
+    // Each level halves the size, so a scale of 1/4 can use level 2.
+    auto level = static_cast<size_t>(std::floor(std::log2(1.0 / largest)));
+
+    return std::min(level, levelCount - 1);
+}
+
+
+PixelPyramid::PixelPyramid(const std::shared_ptr<Pixels> &source)
+    :
+    levels{source}
+{
+    assert(source);
+
+    while (true)
+    {
+        auto &last = *this->levels.back();
+
+        if (last.size.width <= minimumLevelSize
+                && last.size.height <= minimumLevelSize)
+        {
+            break;
+        }
+
+        this->levels.push_back(Downsample(last));
+    }
+}
+
+
+const std::shared_ptr<Pixels> & PixelPyramid::GetSource() const
+{
+    assert(!this->levels.empty());
+
+    return this->levels.front();
+}
+
+
+size_t PixelPyramid::GetLevelCount() const
+{
+    return this->levels.size();
+}
+
+
+size_t PixelPyramid::SelectLevel(const tau::Scale<double> &scale) const
+{
+    return SelectPyramidLevel(scale, this->levels.size());
+}
+
+
+tau::Scale<double> PixelPyramid::GetLevelScale(
+    size_t level,
+    const tau::Scale<double> &scale) const
+{
+    auto &source = *this->levels.at(0);
+    auto &target = *this->levels.at(level);
+
+    auto result = scale;
+
+    result.horizontal *= static_cast<double>(source.size.width)
+        / static_cast<double>(target.size.width);
+
+    result.vertical *= static_cast<double>(source.size.height)
+        / static_cast<double>(target.size.height);
+
+    return result;
+}
+
+
+PyramidGenerator::PyramidGenerator(AsyncPyramidControl control)
+    :
+    mutex_(),
+    control_(control),
+    isRunning_(true),
+    pending_(),
+    hasFrameCondition_(),
+    thread_(std::bind(&PyramidGenerator::Run_, this))
+{
+
+}
+
+
+PyramidGenerator::~PyramidGenerator()
+{
+    this->Shutdown();
+}
+
+
+void PyramidGenerator::operator()(const std::shared_ptr<Pixels> &pixels)
+{
+    pex::WriteLock lock(this->mutex_);
+
+    // Replace any frame that has not been started.
+    this->pending_ = pixels;
+    this->hasFrameCondition_.notify_one();
+}
+
+
+void PyramidGenerator::Shutdown()
+{
+    if (this->thread_.joinable())
+    {
+        {
+            pex::WriteLock lock(this->mutex_);
+            this->isRunning_ = false;
+
+            // Wake up worker so it will exit.
+            this->hasFrameCondition_.notify_one();
+        }
+
+        this->thread_.join();
+    }
+}
+
+
+void PyramidGenerator::Run_()
+{
+    while (true)
+    {
+        std::shared_ptr<Pixels> pixels;
+
+        {
+            pex::WriteLock lock(this->mutex_);
+
+            this->hasFrameCondition_.wait(
+                lock,
+                [this]
+                {
+                    return !!this->pending_ || !this->isRunning_;
+                });
+
+            if (!this->isRunning_)
+            {
+                return;
+            }
+
+            pixels = std::move(this->pending_);
+            this->pending_.reset();
+        }
+
+        this->control_.Set(std::make_shared<PixelPyramid>(pixels));
+    }
+}
+
+
+} // end namespace draw
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <thread>
+#include <condition_variable>
+
+#include <pex/locks.h>
+#include <wxpex/async.h>
+#include <tau/scale.h>
+
+#include "draw/pixels.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** Average each 2x2 block of pixels.
+ **
+ ** Odd widths and heights round up, and the last column or row averages only
+ ** the pixels that exist.
+ **/
+std::shared_ptr<Pixels> Downsample(const Pixels &pixels);
+
+
+/**
+ ** Select the smallest pyramid level that does not need to be magnified to
+ ** display at the given scale.
+ **/
+size_t SelectPyramidLevel(const tau::Scale<double> &scale, size_t levelCount);
+
+
+/**
+ ** A mip pyramid of successively halved images.
+ **
+ ** Level 0 is the full resolution source. Zoomed-out views blit from a
+ ** smaller level, so their cost follows the size of the window instead of the
+ ** size of the image.
+ **/
+struct PixelPyramid
+{
+    // Levels are not created once both dimensions are this small.
+    static constexpr Pixels::Index minimumLevelSize = 256;
+
+    std::vector<std::shared_ptr<Pixels>> levels;
+
+    PixelPyramid() = default;
+
+    PixelPyramid(const std::shared_ptr<Pixels> &source);
+
+    const std::shared_ptr<Pixels> & GetSource() const;
+
+    size_t GetLevelCount() const;
+
+    /**
+     ** Select the smallest level that does not need to be magnified to
+     ** display at the given scale.
+     **/
+    size_t SelectLevel(const tau::Scale<double> &scale) const;
+
+    /**
+     ** The scale that displays a level at the same size as the source at
+     ** the given scale.
+     **/
+    tau::Scale<double> GetLevelScale(
+        size_t level,
+        const tau::Scale<double> &scale) const;
+};
+
+
+using AsyncPyramid = wxpex::MakeAsync<std::shared_ptr<PixelPyramid>>;
+
+using AsyncPyramidModel = typename AsyncPyramid::Model;
+using AsyncPyramidControl = typename AsyncPyramidModel::Unfiltered;
+
+using PyramidControl = typename AsyncPyramid::Control<AsyncPyramidModel>;
+
+
+/**
+ ** Builds pyramids on a worker thread and publishes them to an async control.
+ **
+ ** Only the most recent pixels are kept. When frames arrive faster than
+ ** pyramids can be built, the intermediate frames are skipped.
+ **/
+class PyramidGenerator
+{
+public:
+    PyramidGenerator(AsyncPyramidControl control);
+
+    ~PyramidGenerator();
+
+    PyramidGenerator(const PyramidGenerator &) = delete;
+    PyramidGenerator & operator=(const PyramidGenerator &) = delete;
+
+    void operator()(const std::shared_ptr<Pixels> &pixels);
+
+    void Shutdown();
+
+private:
+    void Run_();
+
+private:
+    pex::Mutex mutex_;
+    AsyncPyramidControl control_;
+    bool isRunning_;
+    std::shared_ptr<Pixels> pending_;
+    std::condition_variable_any hasFrameCondition_;
+    std::thread thread_;
+};
+
+
+} // end namespace draw
@@ -6,6 +6,8 @@
 #include <tau/color.h>
 #include <wxpex/async.h>
 
+#include "draw/size.h"
+
 
 namespace draw
 {
@@ -26,6 +28,29 @@ template<typename Observer>
 using PixelsEndpoint = pex::Endpoint<Observer, PixelsControl>;
 
 
+/**
+ ** Pixels stored as a ring of columns, like the window of a
+ ** StreamingWaveform.
+ **
+ ** Column offset is displayed first, and the columns before it are displayed
+ ** after the last one, so the ring is shown without unrolling it.
+ **/
+struct PixelRing
+{
+    std::shared_ptr<Pixels> pixels;
+    SizeType offset;
+};
+
+
+using AsyncPixelRing = wxpex::MakeAsync<std::shared_ptr<PixelRing>>;
+
+using AsyncPixelRingModel = typename AsyncPixelRing::Model;
+using AsyncPixelRingControl = typename AsyncPixelRingModel::Unfiltered;
+
+using PixelRingControl =
+    typename AsyncPixelRing::Control<AsyncPixelRingModel>;
+
+
 class PixelsContext
 {
 public:
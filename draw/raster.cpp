@@ -0,0 +1,677 @@
+#include "draw/raster.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <tau/angles.h>
+
+
+namespace draw
+{
+
+
+Rasterizer::Rasterizer(const Size &size)
+    :
+    size_(size),
+    antialias_(true),
+    edges_(),
+    active_(),
+    crossings_(),
+    coverage_(static_cast<size_t>(std::max(size.width, 0)), 0.0f),
+    nextEdge_(0),
+    beginRow_(0),
+    endRow_(0),
+    touchedBegin_(0),
+    touchedEnd_(0)
+{
+
+}
+
+
+void Rasterizer::SetAntialias(bool antialias)
+{
+    this->antialias_ = antialias;
+}
+
+
+const Size & Rasterizer::GetSize() const
+{
+    return this->size_;
+}
+
+
+void Rasterizer::Reset()
+{
+    this->edges_.clear();
+}
+
+
+void Rasterizer::AddPolygon(const PointsDouble &points)
+{
+    auto count = points.size();
+
+    if (count < 3)
+    {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto &first = points[i];
+        auto &second = points[(i + 1) % count];
+
+        if (first.y == second.y)
+        {
+            // Horizontal edges never cross a scanline.
+            continue;
+        }
+
+        auto slope = (second.x - first.x) / (second.y - first.y);
+
+        if (first.y < second.y)
+        {
+            this->edges_.push_back({first.y, second.y, first.x, slope, 1});
+        }
+        else
+        {
+            this->edges_.push_back({second.y, first.y, second.x, slope, -1});
+        }
+    }
+}
+
+
+bool Rasterizer::PrepareRender_()
+{
+    if (this->edges_.empty() || this->coverage_.empty())
+    {
+        return false;
+    }
+
+    std::sort(
+        this->edges_.begin(),
+        this->edges_.end(),
+        [](const Edge &left, const Edge &right)
+        {
+            return left.top < right.top;
+        });
+
+    auto bottom = this->edges_.front().bottom;
+
+    for (auto &edge: this->edges_)
+    {
+        bottom = std::max(bottom, edge.bottom);
+    }
+
+    this->beginRow_ = std::max(
+        0,
+        static_cast<int>(std::floor(this->edges_.front().top)));
+
+    this->endRow_ = std::min(
+        this->size_.height,
+        static_cast<int>(std::ceil(bottom)));
+
+    this->active_.clear();
+    this->nextEdge_ = 0;
+
+    return this->beginRow_ < this->endRow_;
+}
+
+
+void Rasterizer::AddSpan_(double begin, double end, float weight)
+{
+    auto width = static_cast<double>(this->size_.width);
+
+    begin = std::clamp(begin, 0.0, width);
+    end = std::clamp(end, 0.0, width);
+
+    if (begin >= end)
+    {
+        return;
+    }
+
+    if (!this->antialias_)
+    {
+        // Cover the pixels with centers inside the span.
+        auto first = static_cast<int>(std::ceil(begin - 0.5));
+        auto last = static_cast<int>(std::ceil(end - 0.5));
+
+        if (first >= last)
+        {
+            return;
+        }
+
+        std::fill(
+            this->coverage_.begin() + first,
+            this->coverage_.begin() + last,
+            1.0f);
+
+        this->touchedBegin_ = std::min(this->touchedBegin_, first);
+        this->touchedEnd_ = std::max(this->touchedEnd_, last);
+
+        return;
+    }
+
+    auto first = static_cast<int>(begin);
+    auto last = std::min(static_cast<int>(end), this->size_.width - 1);
+
+    this->touchedBegin_ = std::min(this->touchedBegin_, first);
+    this->touchedEnd_ = std::max(this->touchedEnd_, last + 1);
+
+    if (first == last)
+    {
+        this->coverage_[static_cast<size_t>(first)] +=
+            static_cast<float>(end - begin) * weight;
+
+        return;
+    }
+
+    this->coverage_[static_cast<size_t>(first)] +=
+        static_cast<float>(first + 1 - begin) * weight;
+
+    for (auto column = first + 1; column < last; ++column)
+    {
+        this->coverage_[static_cast<size_t>(column)] += weight;
+    }
+
+    this->coverage_[static_cast<size_t>(last)] +=
+        static_cast<float>(end - last) * weight;
+}
+
+
+std::pair<int, int> Rasterizer::ComputeRow_(int row, FillRule fillRule)
+{
+    // Clear the coverage of the previous row.
+    if (this->touchedBegin_ < this->touchedEnd_)
+    {
+        std::fill(
+            this->coverage_.begin() + this->touchedBegin_,
+            this->coverage_.begin() + this->touchedEnd_,
+            0.0f);
+    }
+
+    this->touchedBegin_ = this->size_.width;
+    this->touchedEnd_ = 0;
+
+    auto sampleCount = this->antialias_ ? subsampleCount : 1;
+    auto weight = 1.0f / static_cast<float>(sampleCount);
+
+    for (int sample = 0; sample < sampleCount; ++sample)
+    {
+        auto y = static_cast<double>(row)
+            + (static_cast<double>(sample) + 0.5)
+                / static_cast<double>(sampleCount);
+
+        // Activate the edges that begin above this scanline.
+        while (
+            this->nextEdge_ < this->edges_.size()
+            && this->edges_[this->nextEdge_].top <= y)
+        {
+            this->active_.push_back(this->nextEdge_++);
+        }
+
+        // Retire the edges that end above it.
+        this->active_.erase(
+            std::remove_if(
+                this->active_.begin(),
+                this->active_.end(),
+                [this, y](size_t index)
+                {
+                    return this->edges_[index].bottom <= y;
+                }),
+            this->active_.end());
+
+        this->crossings_.clear();
+
+        for (auto index: this->active_)
+        {
+            auto &edge = this->edges_[index];
+
+            this->crossings_.push_back(
+                {edge.column + (y - edge.top) * edge.slope, edge.winding});
+        }
+
+        std::sort(this->crossings_.begin(), this->crossings_.end());
+
+        int winding = 0;
+
+        for (size_t i = 0; i + 1 < this->crossings_.size(); ++i)
+        {
+            if (fillRule == FillRule::evenOdd)
+            {
+                winding ^= 1;
+            }
+            else
+            {
+                winding += this->crossings_[i].winding;
+            }
+
+            if (winding != 0)
+            {
+                this->AddSpan_(
+                    this->crossings_[i].column,
+                    this->crossings_[i + 1].column,
+                    weight);
+            }
+        }
+    }
+
+    if (this->touchedBegin_ >= this->touchedEnd_)
+    {
+        return {0, 0};
+    }
+
+    return {this->touchedBegin_, this->touchedEnd_};
+}
+
+
+namespace detail
+{
+
+
+using Point = PointDouble;
+
+
+double Cross(const Point &first, const Point &second)
+{
+    return first.x * second.y - first.y * second.x;
+}
+
+
+// Add a polygon with counter-clockwise winding, so that overlapping pieces
+// of a stroke join under the nonzero rule.
+void AddOriented(Rasterizer &rasterizer, PointsDouble points)
+{
+    double area = 0.0;
+
+    for (size_t i = 0; i < points.size(); ++i)
+    {
+        area += Cross(points[i], points[(i + 1) % points.size()]);
+    }
+
+    if (area < 0.0)
+    {
+        std::reverse(points.begin(), points.end());
+    }
+
+    rasterizer.AddPolygon(points);
+}
+
+
+void AddCircle(Rasterizer &rasterizer, const Point &center, double radius)
+{
+    // One vertex for every two pixels of circumference.
+    auto count = std::clamp(
+        static_cast<int>(std::ceil(tau::Angles<double>::pi * radius)),
+        8,
+        128);
+
+    PointsDouble points;
+    points.reserve(static_cast<size_t>(count));
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto angle = tau::Angles<double>::tau * static_cast<double>(i)
+            / static_cast<double>(count);
+
+        points.emplace_back(
+            center.x + radius * std::cos(angle),
+            center.y + radius * std::sin(angle));
+    }
+
+    AddOriented(rasterizer, points);
+}
+
+
+// The normal to a segment, with the length of half the stroke.
+Point GetNormal(const Point &first, const Point &second, double halfWeight)
+{
+    auto delta = second - first;
+    auto length = std::hypot(delta.x, delta.y);
+
+    return Point(-delta.y, delta.x) * (halfWeight / length);
+}
+
+
+// The miter limit used by wxGraphicsContext backends.
+static constexpr double miterLimit = 10.0;
+
+
+void AddJoin(
+    Rasterizer &rasterizer,
+    const Point &point,
+    const Point &incoming,
+    const Point &outgoing,
+    wxpex::PenJoin penJoin,
+    double halfWeight)
+{
+    if (penJoin == wxpex::PenJoin::round)
+    {
+        AddCircle(rasterizer, point, halfWeight);
+
+        return;
+    }
+
+    // The gap to fill is on the outside of the turn.
+    auto sign = (Cross(incoming, outgoing) > 0.0) ? -1.0 : 1.0;
+    auto first = incoming * sign;
+    auto second = outgoing * sign;
+
+    if (penJoin == wxpex::PenJoin::miter)
+    {
+        auto sum = first + second;
+        auto sumSquared = sum.x * sum.x + sum.y * sum.y;
+
+        if (sumSquared > 0.0)
+        {
+            auto miterLength = 2.0 * halfWeight * halfWeight
+                / std::sqrt(sumSquared);
+
+            if (miterLength <= miterLimit * halfWeight)
+            {
+                auto tip = point
+                    + sum * (2.0 * halfWeight * halfWeight / sumSquared);
+
+                AddOriented(
+                    rasterizer,
+                    {point, point + first, tip, point + second});
+
+                return;
+            }
+        }
+    }
+
+    // Bevel
+    AddOriented(rasterizer, {point, point + first, point + second});
+}
+
+
+} // end namespace detail
+
+
+void AddStroke(
+    Rasterizer &rasterizer,
+    const PointsDouble &points,
+    bool isClosed,
+    const Stroke &stroke)
+{
+    using detail::Point;
+
+    auto halfWeight = stroke.weight / 2.0;
+
+    if (points.empty() || halfWeight <= 0.0)
+    {
+        return;
+    }
+
+    // Remove repeated points, which have no direction.
+    PointsDouble path;
+    path.reserve(points.size());
+
+    for (auto &point: points)
+    {
+        if (!path.empty() && point == path.back())
+        {
+            continue;
+        }
+
+        path.push_back(point);
+    }
+
+    if (isClosed && path.size() > 1 && path.front() == path.back())
+    {
+        path.pop_back();
+    }
+
+    if (path.size() == 1)
+    {
+        if (stroke.penCap == wxpex::PenCap::round)
+        {
+            detail::AddCircle(rasterizer, path.front(), halfWeight);
+        }
+
+        return;
+    }
+
+    auto count = path.size();
+    auto segmentCount = isClosed ? count : count - 1;
+
+    std::vector<Point> normals;
+    normals.reserve(segmentCount);
+
+    for (size_t i = 0; i < segmentCount; ++i)
+    {
+        auto first = path[i];
+        auto second = path[(i + 1) % count];
+        auto normal = detail::GetNormal(first, second, halfWeight);
+        normals.push_back(normal);
+
+        if (!isClosed && stroke.penCap == wxpex::PenCap::projecting)
+        {
+            // Extend the open ends by half of the weight.
+            auto along = Point(normal.y, -normal.x);
+
+            if (i == 0)
+            {
+                first -= along;
+            }
+
+            if (i == segmentCount - 1)
+            {
+                second += along;
+            }
+        }
+
+        detail::AddOriented(
+            rasterizer,
+            {first + normal, second + normal, second - normal, first - normal});
+    }
+
+    auto penJoin = wxpex::PenJoin(stroke.penJoin);
+
+    for (size_t i = 0; i < segmentCount; ++i)
+    {
+        if (!isClosed && i == 0)
+        {
+            continue;
+        }
+
+        auto incoming = normals[(i + segmentCount - 1) % segmentCount];
+
+        detail::AddJoin(
+            rasterizer,
+            path[i],
+            incoming,
+            normals[i],
+            penJoin,
+            halfWeight);
+    }
+
+    if (!isClosed && stroke.penCap == wxpex::PenCap::round)
+    {
+        detail::AddCircle(rasterizer, path.front(), halfWeight);
+        detail::AddCircle(rasterizer, path.back(), halfWeight);
+    }
+}
+
+
+std::array<double, 3> GetRgb(const RasterColor &color)
+{
+    auto value = color.value;
+    auto chroma = value * color.saturation;
+    auto sector = std::fmod(color.hue, 360.0) / 60.0;
+
+    if (sector < 0.0)
+    {
+        sector += 6.0;
+    }
+
+    auto second = chroma * (1.0 - std::abs(std::fmod(sector, 2.0) - 1.0));
+    auto offset = value - chroma;
+
+    std::array<double, 3> rgb{};
+
+    switch (static_cast<int>(sector))
+    {
+        case 0:
+            rgb = {chroma, second, 0.0};
+            break;
+
+        case 1:
+            rgb = {second, chroma, 0.0};
+            break;
+
+        case 2:
+            rgb = {0.0, chroma, second};
+            break;
+
+        case 3:
+            rgb = {0.0, second, chroma};
+            break;
+
+        case 4:
+            rgb = {second, 0.0, chroma};
+            break;
+
+        default:
+            rgb = {chroma, 0.0, second};
+            break;
+    }
+
+    for (auto &channel: rgb)
+    {
+        channel += offset;
+    }
+
+    return rgb;
+}
+
+
+MonoRasterTarget::MonoRasterTarget(
+    tau::MonoImage<int32_t> &image,
+    int32_t maximumValue)
+    :
+    image_(image),
+    maximumValue_(maximumValue)
+{
+
+}
+
+
+Size MonoRasterTarget::GetSize() const
+{
+    return GetMatrixSize(this->image_);
+}
+
+
+MonoRasterTarget::Color MonoRasterTarget::MakeColor(
+    const RasterColor &color) const
+{
+    return color.value * static_cast<double>(this->maximumValue_);
+}
+
+
+void MonoRasterTarget::Clear()
+{
+    this->image_.setZero();
+}
+
+
+void MonoRasterTarget::Blend(
+    int row,
+    int begin,
+    int end,
+    const float *coverage,
+    Color color,
+    double alpha)
+{
+    for (int column = begin; column < end; ++column)
+    {
+        auto weight = alpha * static_cast<double>(coverage[column]);
+
+        if (weight <= 0.0)
+        {
+            continue;
+        }
+
+        auto &value = this->image_(row, column);
+        auto current = static_cast<double>(value);
+
+        value = static_cast<int32_t>(
+            std::round(current + (color - current) * std::min(weight, 1.0)));
+    }
+}
+
+
+PixelsRasterTarget::PixelsRasterTarget(Pixels &pixels)
+    :
+    pixels_(pixels)
+{
+
+}
+
+
+Size PixelsRasterTarget::GetSize() const
+{
+    return Size(
+        static_cast<SizeType>(this->pixels_.size.width),
+        static_cast<SizeType>(this->pixels_.size.height));
+}
+
+
+PixelsRasterTarget::Color PixelsRasterTarget::MakeColor(
+    const RasterColor &color) const
+{
+    auto rgb = GetRgb(color);
+
+    for (auto &channel: rgb)
+    {
+        channel *= 255.0;
+    }
+
+    return rgb;
+}
+
+
+void PixelsRasterTarget::Clear()
+{
+    this->pixels_.data.setZero();
+}
+
+
+void PixelsRasterTarget::Blend(
+    int row,
+    int begin,
+    int end,
+    const float *coverage,
+    const Color &color,
+    double alpha)
+{
+    auto width = static_cast<ptrdiff_t>(this->pixels_.size.width);
+
+    // The pixel data is interleaved, three values to a pixel.
+    uint8_t *rowData = this->pixels_.data.data() + 3 * row * width;
+
+    for (int column = begin; column < end; ++column)
+    {
+        auto weight = alpha * static_cast<double>(coverage[column]);
+
+        if (weight <= 0.0)
+        {
+            continue;
+        }
+
+        weight = std::min(weight, 1.0);
+        uint8_t *pixel = rowData + 3 * column;
+
+        for (size_t channel = 0; channel < 3; ++channel)
+        {
+            auto current = static_cast<double>(pixel[channel]);
+
+            pixel[channel] = static_cast<uint8_t>(
+                std::round(current + (color[channel] - current) * weight));
+        }
+    }
+}
+
+
+} // end namespace draw
@@ -0,0 +1,306 @@
+#pragma once
+
+
+#include <array>
+#include <utility>
+#include <vector>
+#include <tau/mono_image.h>
+
+#include "draw/look.h"
+#include "draw/pixels.h"
+#include "draw/points.h"
+#include "draw/size.h"
+
+
+namespace draw
+{
+
+
+enum class FillRule
+{
+    evenOdd,
+    nonzero
+};
+
+
+/**
+ ** Converts polygons to per-pixel coverage, one row at a time.
+ **
+ ** When antialiasing, each row is sampled on several sub-scanlines, and the
+ ** coverage of the pixels at the ends of each span is fractional.
+ **/
+class Rasterizer
+{
+public:
+    static constexpr int subsampleCount = 4;
+
+    Rasterizer(const Size &size);
+
+    void SetAntialias(bool antialias);
+
+    const Size & GetSize() const;
+
+    // Remove every polygon.
+    void Reset();
+
+    // Add a closed polygon.
+    void AddPolygon(const PointsDouble &points);
+
+    /**
+     ** Calls blend(row, begin, end, coverage) for every row touched by the
+     ** polygons, where coverage[column] is in the range 0 to 1 for columns
+     ** in [begin, end).
+     **/
+    template<typename Blend>
+    void Render(FillRule fillRule, Blend &&blend)
+    {
+        if (!this->PrepareRender_())
+        {
+            return;
+        }
+
+        for (int row = this->beginRow_; row < this->endRow_; ++row)
+        {
+            auto [begin, end] = this->ComputeRow_(row, fillRule);
+
+            if (begin < end)
+            {
+                blend(row, begin, end, this->coverage_.data());
+            }
+        }
+    }
+
+private:
+    struct Edge
+    {
+        double top;
+        double bottom;
+
+        // The column at the top of the edge.
+        double column;
+
+        // Columns per row.
+        double slope;
+
+        // +1 when the edge was added from top to bottom.
+        int winding;
+    };
+
+    struct Crossing
+    {
+        double column;
+        int winding;
+
+        bool operator<(const Crossing &other) const
+        {
+            return this->column < other.column;
+        }
+    };
+
+    // Sort the edges and clamp the rows to the image.
+    bool PrepareRender_();
+
+    // @return The range of columns with coverage.
+    std::pair<int, int> ComputeRow_(int row, FillRule fillRule);
+
+    void AddSpan_(double begin, double end, float weight);
+
+private:
+    Size size_;
+    bool antialias_;
+    std::vector<Edge> edges_;
+    std::vector<size_t> active_;
+    std::vector<Crossing> crossings_;
+    std::vector<float> coverage_;
+
+    size_t nextEdge_;
+    int beginRow_;
+    int endRow_;
+    int touchedBegin_;
+    int touchedEnd_;
+};
+
+
+/**
+ ** Add the outline of a stroke to a rasterizer.
+ **
+ ** The pieces of the outline overlap, so they must be rendered with
+ ** FillRule::nonzero. Pen styles other than solid are drawn as solid.
+ **/
+void AddStroke(
+    Rasterizer &rasterizer,
+    const PointsDouble &points,
+    bool isClosed,
+    const Stroke &stroke);
+
+
+using RasterColor = decltype(Fill::color);
+
+
+// Red, green, and blue, from 0 to 1.
+std::array<double, 3> GetRgb(const RasterColor &color);
+
+
+/**
+ ** Draws into a MonoImage, using the HSV value of a color like GetMonoImage.
+ **/
+class MonoRasterTarget
+{
+public:
+    using Color = double;
+
+    MonoRasterTarget(tau::MonoImage<int32_t> &image, int32_t maximumValue);
+
+    Size GetSize() const;
+
+    Color MakeColor(const RasterColor &color) const;
+
+    void Clear();
+
+    void Blend(
+        int row,
+        int begin,
+        int end,
+        const float *coverage,
+        Color color,
+        double alpha);
+
+private:
+    tau::MonoImage<int32_t> &image_;
+    int32_t maximumValue_;
+};
+
+
+class PixelsRasterTarget
+{
+public:
+    using Color = std::array<double, 3>;
+
+    PixelsRasterTarget(Pixels &pixels);
+
+    Size GetSize() const;
+
+    Color MakeColor(const RasterColor &color) const;
+
+    void Clear();
+
+    void Blend(
+        int row,
+        int begin,
+        int end,
+        const float *coverage,
+        const Color &color,
+        double alpha);
+
+private:
+    Pixels &pixels_;
+};
+
+
+/**
+ ** Draws polygons and lines with a Look, like DrawContext, directly into
+ ** memory.
+ **
+ ** No wx objects are used, so frames can be rendered on worker threads, with
+ ** one RasterContext per thread.
+ **/
+template<typename Target>
+class RasterContext
+{
+public:
+    template<typename... Args>
+    RasterContext(Args &&...args)
+        :
+        target_(std::forward<Args>(args)...),
+        rasterizer_(this->target_.GetSize()),
+        look_{}
+    {
+
+    }
+
+    RasterContext(const RasterContext &) = delete;
+    RasterContext & operator=(const RasterContext &) = delete;
+
+    void ConfigureLook(const Look &look)
+    {
+        this->look_ = look;
+        this->rasterizer_.SetAntialias(look.stroke.antialias);
+    }
+
+    const Look & GetLook() const
+    {
+        return this->look_;
+    }
+
+    // Fill the target with black.
+    void Clear()
+    {
+        this->target_.Clear();
+    }
+
+    // Fill and stroke a closed polygon.
+    void DrawPolygon(const PointsDouble &points)
+    {
+        if (this->look_.fill.enable)
+        {
+            this->rasterizer_.Reset();
+            this->rasterizer_.AddPolygon(points);
+            this->Render_(FillRule::evenOdd, this->look_.fill.color);
+        }
+
+        this->Stroke_(points, true);
+    }
+
+    // Stroke an open path.
+    void DrawLines(const PointsDouble &points)
+    {
+        this->Stroke_(points, false);
+    }
+
+    Target & GetTarget()
+    {
+        return this->target_;
+    }
+
+private:
+    void Stroke_(const PointsDouble &points, bool isClosed)
+    {
+        if (!this->look_.stroke.enable)
+        {
+            return;
+        }
+
+        this->rasterizer_.Reset();
+        AddStroke(this->rasterizer_, points, isClosed, this->look_.stroke);
+        this->Render_(FillRule::nonzero, this->look_.stroke.color);
+    }
+
+    void Render_(FillRule fillRule, const RasterColor &rasterColor)
+    {
+        auto color = this->target_.MakeColor(rasterColor);
+        auto alpha = rasterColor.alpha;
+
+        this->rasterizer_.Render(
+            fillRule,
+            [this, &color, alpha](
+                int row,
+                int begin,
+                int end,
+                const float *coverage)
+            {
+                this->target_.Blend(row, begin, end, coverage, color, alpha);
+            });
+    }
+
+private:
+    Target target_;
+    Rasterizer rasterizer_;
+    Look look_;
+};
+
+
+using MonoRaster = RasterContext<MonoRasterTarget>;
+using PixelsRaster = RasterContext<PixelsRasterTarget>;
+
+
+} // end namespace draw
@@ -0,0 +1,186 @@
+#include "draw/region_statistics.h"
+
+#include "draw/trace.h"
+
+
+namespace draw
+{
+
+
+StatisticsRegion MakeStatisticsRegion(const Polygon &polygon)
+{
+    return polygon.GetPoints();
+}
+
+
+StatisticsRegion MakeStatisticsRegion(const Quad &quad)
+{
+    auto points = quad.GetPoints();
+
+    return PointsDouble(points.begin(), points.end());
+}
+
+
+StatisticsRegion MakeStatisticsRegion(const Ellipse &ellipse)
+{
+    return EllipseRegion{
+        ellipse.center,
+        0.5 * ellipse.major * ellipse.scale,
+        0.5 * ellipse.minor * ellipse.scale,
+        ellipse.rotation};
+}
+
+
+RegionStatistics GetStatistics(
+    const IntegralImage &integral,
+    const StatisticsRegion &region)
+{
+    if (std::holds_alternative<PointsDouble>(region))
+    {
+        return integral.GetPolygon(std::get<PointsDouble>(region));
+    }
+
+    if (std::holds_alternative<EllipseRegion>(region))
+    {
+        return integral.GetEllipse(std::get<EllipseRegion>(region));
+    }
+
+    auto size = integral.GetSize();
+
+    return integral.GetBox(0, 0, size.width, size.height);
+}
+
+
+RegionStatisticsGenerator::RegionStatisticsGenerator(
+    AsyncRegionStatisticsControl control)
+    :
+    mutex_(),
+    control_(control),
+    isRunning_(true),
+    pending_(),
+    region_(),
+    isRegionChanged_(false),
+    hasWorkCondition_(),
+    integral_(),
+    thread_(std::bind(&RegionStatisticsGenerator::Run_, this))
+{
+
+}
+
+
+RegionStatisticsGenerator::~RegionStatisticsGenerator()
+{
+    this->Shutdown();
+}
+
+
+void RegionStatisticsGenerator::operator()(
+    const std::shared_ptr<const Pixels> &pixels)
+{
+    this->SetPending_(
+        [pixels](IntegralImage &integral)
+        {
+            integral.Assign(*pixels);
+        });
+}
+
+
+void RegionStatisticsGenerator::operator()(
+    const std::shared_ptr<const Gray<uint8_t>> &gray)
+{
+    this->SetPending_(
+        [gray](IntegralImage &integral)
+        {
+            integral.Assign(*gray);
+        });
+}
+
+
+void RegionStatisticsGenerator::SetRegion(const StatisticsRegion &region)
+{
+    pex::WriteLock lock(this->mutex_);
+    this->region_ = region;
+    this->isRegionChanged_ = true;
+    this->hasWorkCondition_.notify_one();
+}
+
+
+void RegionStatisticsGenerator::Shutdown()
+{
+    if (this->thread_.joinable())
+    {
+        {
+            pex::WriteLock lock(this->mutex_);
+            this->isRunning_ = false;
+
+            // Wake up worker so it will exit.
+            this->hasWorkCondition_.notify_one();
+        }
+
+        this->thread_.join();
+    }
+}
+
+
+void RegionStatisticsGenerator::SetPending_(BuildIntegral &&buildIntegral)
+{
+    pex::WriteLock lock(this->mutex_);
+
+    // Replace any frame that has not been started.
+    this->pending_ = std::move(buildIntegral);
+    this->hasWorkCondition_.notify_one();
+}
+
+
+void RegionStatisticsGenerator::Run_()
+{
+    while (true)
+    {
+        BuildIntegral buildIntegral;
+        StatisticsRegion region;
+
+        {
+            pex::WriteLock lock(this->mutex_);
+
+            this->hasWorkCondition_.wait(
+                lock,
+                [this]
+                {
+                    return !!this->pending_
+                        || this->isRegionChanged_
+                        || !this->isRunning_;
+                });
+
+            if (!this->isRunning_)
+            {
+                return;
+            }
+
+            buildIntegral = std::move(this->pending_);
+            this->pending_ = nullptr;
+            region = this->region_;
+            this->isRegionChanged_ = false;
+        }
+
+        if (buildIntegral)
+        {
+            DRAW_TRACE_SCOPE("statistics.integral");
+            buildIntegral(this->integral_);
+        }
+
+        if (this->integral_.GetChannelCount() == 0)
+        {
+            // There is no frame to measure yet.
+            continue;
+        }
+
+        DRAW_TRACE_SCOPE("statistics.region");
+
+        this->control_.Set(
+            std::make_shared<RegionStatistics>(
+                GetStatistics(this->integral_, region)));
+    }
+}
+
+
+} // end namespace draw
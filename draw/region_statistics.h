@@ -0,0 +1,111 @@
+#pragma once
+
+#include <memory>
+#include <functional>
+#include <thread>
+#include <variant>
+#include <condition_variable>
+
+#include <pex/locks.h>
+#include <wxpex/async.h>
+
+#include "draw/integral_image.h"
+#include "draw/polygon.h"
+#include "draw/quad.h"
+#include "draw/ellipse.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** The part of a frame to measure.
+ **
+ ** std::monostate measures the whole frame. Points are a polygon, filled by
+ ** the even-odd rule.
+ **/
+using StatisticsRegion =
+    std::variant<std::monostate, PointsDouble, EllipseRegion>;
+
+
+StatisticsRegion MakeStatisticsRegion(const Polygon &polygon);
+
+StatisticsRegion MakeStatisticsRegion(const Quad &quad);
+
+StatisticsRegion MakeStatisticsRegion(const Ellipse &ellipse);
+
+
+RegionStatistics GetStatistics(
+    const IntegralImage &integral,
+    const StatisticsRegion &region);
+
+
+using AsyncRegionStatistics =
+    wxpex::MakeAsync<std::shared_ptr<RegionStatistics>>;
+
+using AsyncRegionStatisticsModel = typename AsyncRegionStatistics::Model;
+
+using AsyncRegionStatisticsControl =
+    typename AsyncRegionStatisticsModel::Unfiltered;
+
+using RegionStatisticsControl =
+    typename AsyncRegionStatistics::Control<AsyncRegionStatisticsModel>;
+
+
+/**
+ ** Measures a region of each frame on a worker thread and publishes the
+ ** statistics to an async control.
+ **
+ ** The integral image of a frame is built once, so moving the region only
+ ** costs a query. Call SetRegion as a shape is dragged to update the
+ ** statistics at the rate they can be computed. Each frame is built in the
+ ** tables of the last one.
+ **
+ ** As in PyramidGenerator, only the most recent frame and region are kept.
+ ** Nothing is published until the first frame arrives.
+ **/
+class RegionStatisticsGenerator
+{
+public:
+    RegionStatisticsGenerator(AsyncRegionStatisticsControl control);
+
+    ~RegionStatisticsGenerator();
+
+    RegionStatisticsGenerator(const RegionStatisticsGenerator &) = delete;
+
+    RegionStatisticsGenerator & operator=(
+        const RegionStatisticsGenerator &) = delete;
+
+    void operator()(const std::shared_ptr<const Pixels> &pixels);
+
+    void operator()(const std::shared_ptr<const Gray<uint8_t>> &gray);
+
+    void SetRegion(const StatisticsRegion &region);
+
+    void Shutdown();
+
+private:
+    using BuildIntegral = std::function<void(IntegralImage &)>;
+
+    void SetPending_(BuildIntegral &&buildIntegral);
+
+    void Run_();
+
+private:
+    pex::Mutex mutex_;
+    AsyncRegionStatisticsControl control_;
+    bool isRunning_;
+    BuildIntegral pending_;
+    StatisticsRegion region_;
+    bool isRegionChanged_;
+    std::condition_variable_any hasWorkCondition_;
+
+    // Only used by the worker thread.
+    IntegralImage integral_;
+
+    std::thread thread_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,116 @@
+#include "draw/scroll_predictor.h"
+
+#include <cmath>
+
+
+namespace draw
+{
+
+
+ScrollPredictor::ScrollPredictor(double smoothing)
+    :
+    smoothing_(smoothing),
+    lastPosition_(),
+    lastTime_(),
+    velocity_(0.0, 0.0)
+{
+
+}
+
+
+bool ScrollPredictor::Report(
+    const tau::Point2d<int> &viewPosition,
+    Clock::time_point now)
+{
+    if (!this->lastPosition_)
+    {
+        this->lastPosition_ = viewPosition;
+        this->lastTime_ = now;
+
+        return false;
+    }
+
+    auto seconds =
+        std::chrono::duration<double>(now - this->lastTime_).count();
+
+    auto deltaX = static_cast<double>(viewPosition.x - this->lastPosition_->x);
+    auto deltaY = static_cast<double>(viewPosition.y - this->lastPosition_->y);
+
+    this->lastPosition_ = viewPosition;
+    this->lastTime_ = now;
+
+    if (seconds <= 0.0)
+    {
+        return false;
+    }
+
+    if (seconds > idleSeconds)
+    {
+        // The previous gesture has ended.
+        this->velocity_ = tau::Point2d<double>(0.0, 0.0);
+    }
+
+    auto velocityX = deltaX / seconds;
+    auto velocityY = deltaY / seconds;
+
+    auto agreement =
+        velocityX * this->velocity_.x + velocityY * this->velocity_.y;
+
+    if (agreement < 0.0)
+    {
+        this->velocity_ = tau::Point2d<double>(velocityX, velocityY);
+
+        return true;
+    }
+
+    auto keep = 1.0 - this->smoothing_;
+
+    this->velocity_ = tau::Point2d<double>(
+        keep * this->velocity_.x + this->smoothing_ * velocityX,
+        keep * this->velocity_.y + this->smoothing_ * velocityY);
+
+    return false;
+}
+
+
+tau::Point2d<double> ScrollPredictor::GetVelocity() const
+{
+    return this->velocity_;
+}
+
+
+bool ScrollPredictor::IsMoving(Clock::time_point now) const
+{
+    if (!this->lastPosition_)
+    {
+        return false;
+    }
+
+    auto seconds =
+        std::chrono::duration<double>(now - this->lastTime_).count();
+
+    if (seconds > idleSeconds)
+    {
+        return false;
+    }
+
+    return this->velocity_.x != 0.0 || this->velocity_.y != 0.0;
+}
+
+
+tau::Point2d<int> ScrollPredictor::PredictOffset(double seconds) const
+{
+    return tau::Point2d<int>(
+        static_cast<int>(std::round(this->velocity_.x * seconds)),
+        static_cast<int>(std::round(this->velocity_.y * seconds)));
+}
+
+
+void ScrollPredictor::Reset()
+{
+    this->lastPosition_.reset();
+    this->velocity_ = tau::Point2d<double>(0.0, 0.0);
+}
+
+
+} // end namespace draw
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <tau/vector2d.h>
+
+
+namespace draw
+{
+
+
+/**
+ ** Estimates scroll velocity from successive view positions.
+ **
+ ** The velocity is smoothed with an exponential moving average. A reversal
+ ** of direction restarts the average, so prefetching can be redirected
+ ** immediately.
+ **/
+class ScrollPredictor
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Positions reported further apart than this begin a new gesture.
+    static constexpr double idleSeconds = 0.25;
+
+    /**
+     ** @param smoothing The weight of the newest velocity, from 0 to 1.
+     **/
+    ScrollPredictor(double smoothing = 0.5);
+
+    /**
+     ** @return true when the direction of motion has reversed.
+     **/
+    bool Report(
+        const tau::Point2d<int> &viewPosition,
+        Clock::time_point now = Clock::now());
+
+    // Window pixels per second.
+    tau::Point2d<double> GetVelocity() const;
+
+    bool IsMoving(Clock::time_point now = Clock::now()) const;
+
+    // The expected change in view position after a number of seconds.
+    tau::Point2d<int> PredictOffset(double seconds) const;
+
+    void Reset();
+
+private:
+    double smoothing_;
+    std::optional<tau::Point2d<int>> lastPosition_;
+    Clock::time_point lastTime_;
+    tau::Point2d<double> velocity_;
+};
+
+
+} // end namespace draw
@@ -1,5 +1,5 @@
 #include "draw/segments_shape.h"
-#include "draw/draw_spline.h"
+#include <algorithm>
 #include <cmath>
 
 
@@ -47,12 +47,15 @@ SegmentsShape::SegmentsShape(
     const PointsDouble &points)
     :
     segmentsSettings_(settings),
-    points_(points)
+    points_(points),
+    tessellator_()
 {
     if (points.size() < 2)
     {
         throw std::logic_error("Segments requires at least 2 points");
     }
+
+    this->tessellator_.SetPoints(this->points_);
 }
 
 
@@ -70,19 +73,24 @@ void SegmentsShape::Draw(DrawContext &context)
     {
         auto look = this->segmentsSettings_.look;
 
-        using Point = tau::Point2d<double>;
-        auto pointSpan = std::span<Point>(this->points_);
-        auto derivatives = GetDerivatives(pointSpan);
-        auto derivativeSpan = std::span<Point>(derivatives);
+        auto scale = context.GetScale();
+
+        auto &tessellation =
+            this->tessellator_.Get(std::max(scale.horizontal, scale.vertical));
 
-        auto hueStep = 360.0 / static_cast<double>(pointSpan.size());
+        auto segmentCount = tessellation.GetSegmentCount();
+        auto hueStep = 360.0 / static_cast<double>(this->points_.size());
 
-        for (size_t i = 0; i + 1 < pointSpan.size(); ++i)
+        for (size_t i = 0; i < segmentCount; ++i)
         {
-            DrawTangentSpline(
-                path,
-                pointSpan.subspan(i, 2),
-                derivativeSpan.subspan(i, 2));
+            auto segment = tessellation.GetSegment(i);
+
+            path.MoveToPoint(segment.front().x, segment.front().y);
+
+            for (size_t k = 1; k < segment.size(); ++k)
+            {
+                path.AddLineToPoint(segment[k].x, segment[k].y);
+            }
 
             context->DrawPath(path);
 
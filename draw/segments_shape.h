@@ -7,6 +7,7 @@
 #include <draw/points.h>
 #include <draw/look.h>
 #include <draw/shapes.h>
+#include <draw/spline_tessellator.h>
 
 
 namespace draw
@@ -99,6 +100,7 @@ public:
 private:
     SegmentsSettings segmentsSettings_;
     PointsDouble points_;
+    SplineTessellator tessellator_;
 };
 
 
@@ -3,6 +3,7 @@
 #include <pex/ordered_list.h>
 #include <pex/indexed_map.h>
 #include "draw/node_settings.h"
+#include "draw/trace.h"
 
 
 namespace draw
@@ -36,6 +37,9 @@ public:
         :
         list_(listControl),
         ignoreSelected_(false),
+        isBatching_(false),
+        firstDeferred_(),
+        lastAdded_(),
 
         memberWillRemoveEndpoint_(
             PEX_THIS("SelectionBrain"),
@@ -97,6 +101,39 @@ public:
         this->list_.EraseSelected();
     }
 
+    // Defer reconnecting and selecting members until EndBatch.
+    void BeginBatch()
+    {
+        this->isBatching_ = true;
+        this->firstDeferred_.reset();
+        this->lastAdded_.reset();
+    }
+
+    // Catch up with every member added or removed since BeginBatch.
+    void EndBatch()
+    {
+        if (!this->isBatching_)
+        {
+            return;
+        }
+
+        this->isBatching_ = false;
+
+        if (this->firstDeferred_)
+        {
+            this->ClearConnections_(*this->firstDeferred_);
+            this->RestoreConnections_(*this->firstDeferred_);
+        }
+
+        if (this->lastAdded_ && *this->lastAdded_ < this->list_.count.Get())
+        {
+            this->SelectAdded_(*this->lastAdded_);
+        }
+
+        this->firstDeferred_.reset();
+        this->lastAdded_.reset();
+    }
+
 private:
     void ToggleSelect_(size_t unordered)
     {
@@ -210,42 +247,72 @@ private:
         }
     }
 
-    void OnMemberAdded_(const std::optional<size_t> &memberIndex)
+    void DeferFrom_(size_t index)
     {
-        if (!memberIndex)
+        if (!this->firstDeferred_ || index < *this->firstDeferred_)
         {
-            return;
-        }
-
-        // size of the list was just increased.
-        // ClearConnections up to the last list size.
-        size_t newCount = this->list_.size();
-
-        if (newCount > 1)
-        {
-            this->ClearConnections_(*memberIndex);
+            this->firstDeferred_ = index;
         }
+    }
 
-        this->RestoreConnections_(*memberIndex);
-
+    void SelectAdded_(size_t memberIndex)
+    {
         if constexpr (pex::HasGetVirtual<ListItem>)
         {
             auto itemBase =
-                pex::GetUnordered(this->list_, *memberIndex).GetVirtual();
+                pex::GetUnordered(this->list_, memberIndex).GetVirtual();
 
             if (itemBase)
             {
                 // The derived type exists.
                 // Select it.
-                this->Select_(*memberIndex);
+                this->Select_(memberIndex);
             }
         }
         else
         {
             // Items in list are not virtual.
             // They already exist.
-            this->Select_(*memberIndex);
+            this->Select_(memberIndex);
+        }
+    }
+
+    void OnMemberAdded_(const std::optional<size_t> &memberIndex)
+    {
+        if (!memberIndex)
+        {
+            return;
+        }
+
+        if (this->isBatching_)
+        {
+            // Connections at and after the new member have moved.
+            this->ClearConnections_(*memberIndex);
+            this->DeferFrom_(*memberIndex);
+
+            if (this->lastAdded_ && *this->lastAdded_ >= *memberIndex)
+            {
+                ++(*this->lastAdded_);
+            }
+            else
+            {
+                this->lastAdded_ = *memberIndex;
+            }
+
+            return;
+        }
+
+        // size of the list was just increased.
+        // ClearConnections up to the last list size.
+        size_t newCount = this->list_.size();
+
+        if (newCount > 1)
+        {
+            this->ClearConnections_(*memberIndex);
         }
+
+        this->RestoreConnections_(*memberIndex);
+        this->SelectAdded_(*memberIndex);
     }
 
     void OnMemberWillRemove_(const std::optional<size_t> &index)
@@ -265,6 +332,25 @@ private:
             return;
         }
 
+        if (this->isBatching_)
+        {
+            this->DeferFrom_(*index);
+
+            if (this->lastAdded_)
+            {
+                if (*this->lastAdded_ == *index)
+                {
+                    this->lastAdded_.reset();
+                }
+                else if (*this->lastAdded_ > *index)
+                {
+                    --(*this->lastAdded_);
+                }
+            }
+
+            return;
+        }
+
         this->RestoreConnections_(*index);
     }
 
@@ -322,6 +408,9 @@ private:
         pex::Endpoint<SelectionBrain, pex::control::ListOptionalIndex>;
 
     bool ignoreSelected_;
+    bool isBatching_;
+    std::optional<size_t> firstDeferred_;
+    std::optional<size_t> lastAdded_;
     IndexEndpoint memberWillRemoveEndpoint_;
     IndexEndpoint memberRemovedEndpoint_;
     IndexEndpoint memberAddedEndpoint_;
@@ -357,7 +446,10 @@ public:
     std::optional<Found> FindClicked(
         const tau::Point2d<int> &position)
     {
+        DRAW_TRACE_SCOPE("shapeEditor.hitTest");
+
         auto count = this->list_.count.Get();
+        DRAW_TRACE_COUNTER("shapeEditor.shapeCount", count);
         assert(count == this->list_.size());
 
         for (size_t index = 0; index < count; ++index)
@@ -2,11 +2,13 @@
 
 
 #include <concepts>
+#include <optional>
 #include <pex/endpoint.h>
 #include <pex/list_observer.h>
 #include "draw/selection_brain.h"
 #include "draw/oddeven.h"
 #include "draw/drag.h"
+#include "draw/drag_preview.h"
 #include "draw/views/canvas_settings.h"
 #include "draw/shapes.h"
 #include "draw/shape_list.h"
@@ -68,7 +70,8 @@ public:
         :
         Drag(index, start, offset),
         control_(control),
-        startingShape_(startingShape)
+        startingShape_(startingShape),
+        committer_(control)
     {
         if (this->index_ > 0)
         {
@@ -91,21 +94,38 @@ public:
         :
         Drag(start, offset),
         control_(control),
-        startingShape_(startingShape)
+        startingShape_(startingShape),
+        committer_(control)
     {
         PEX_NAME("DragShape");
         PEX_MEMBER(startingShape_);
     }
 
+    void SetPreview(DragPreviewBase *preview) override
+    {
+        this->committer_.SetPreview(preview, this->startingShape_.id);
+    }
+
     void ReportLogicalPosition(const tau::Point2d<double> &position) override
     {
         this->startingShape_.shape.center = this->GetPosition(position);
-        this->control_->SetValue(this->startingShape_);
+
+        if (!this->committer_.HasPreview())
+        {
+            this->control_->SetValue(this->startingShape_);
+
+            return;
+        }
+
+        // The preview keeps the shape, so it needs its own copy.
+        this->committer_.Update(
+            std::make_shared<DerivedShape>(this->startingShape_));
     }
 
 protected:
     std::shared_ptr<ShapeControl> control_;
     DerivedShape startingShape_;
+    DragCommitter committer_;
 };
 
 
@@ -124,7 +144,8 @@ public:
         :
         Drag(index, start, offset),
         control_(control),
-        startingShape_(startingShape)
+        startingShape_(startingShape),
+        committer_(control)
     {
         if (this->index_ > 0)
         {
@@ -148,16 +169,24 @@ public:
         :
         Drag(start, offset),
         control_(control),
-        startingShape_(startingShape)
+        startingShape_(startingShape),
+        committer_(control)
     {
         PEX_NAME("DragEditShape");
         PEX_MEMBER_ADDRESS(this->control_.get(), "control_");
         PEX_MEMBER(startingShape_);
     }
 
+    void SetPreview(DragPreviewBase *preview) override
+    {
+        this->committer_.SetPreview(preview, this->startingShape_.id);
+    }
+
     void ReportLogicalPosition(const tau::Point2d<double> &position) override
     {
-        this->control_->SetValue(*this->MakeShape_(position));
+        // The new shape is drawn by the preview, and sent to the control
+        // when the committer is ready.
+        this->committer_.Update(this->MakeShape_(position));
     }
 
 protected:
@@ -167,6 +196,7 @@ protected:
 protected:
     std::shared_ptr<ShapeControl> control_;
     DerivedShape startingShape_;
+    DragCommitter committer_;
 };
 
 
@@ -490,8 +520,17 @@ public:
             this,
             canvasControl.menuId),
 
+        countEndpoint_(
+            this,
+            shapeList.count,
+            &ShapeEditor::OnCount_),
+
+        isBatchingEndpoint_(),
+
         drag_(),
-        rightClickMenu_{}
+        dragPreview_(nullptr),
+        rightClickMenu_{},
+        hoverPosition_()
     {
         if constexpr (HasRightClickMenu<Create>)
         {
@@ -502,11 +541,41 @@ public:
         }
     }
 
+    // Also follows the list's batches, updating selection once per batch.
+    ShapeEditor(
+        const ShapeListControl &shapeList,
+        const CanvasControl &canvasControl)
+        :
+        ShapeEditor(shapeList.shapes, canvasControl)
+    {
+        this->isBatchingEndpoint_ =
+            IsBatchingEndpoint(
+                this,
+                shapeList.isBatching,
+                &ShapeEditor::OnIsBatching_);
+
+        if (shapeList.isBatching.Get())
+        {
+            this->BeginBatch();
+        }
+    }
+
     ~ShapeEditor()
     {
 
     }
 
+    /**
+     ** Draw edited shapes on the preview while they are dragged, and update
+     ** the shape list at the preview's commit interval.
+     **
+     ** The preview must outlive the editor, or be removed with nullptr.
+     **/
+    void SetDragPreview(DragPreviewBase *dragPreview)
+    {
+        this->dragPreview_ = dragPreview;
+    }
+
     void SetIsEnabled(bool isEnabled)
     {
         // Do not leave drag state set when toggling the enable switch.
@@ -544,12 +613,24 @@ public:
             return;
         }
 
-        this->UpdateCursor_();
-
         if (this->drag_)
         {
             this->drag_->ReportLogicalPosition(position);
+
+            return;
+        }
+
+        // Hit-testing walks every shape in the list.
+        // The result can only change when the cursor enters a new pixel.
+        tau::Point2d<int> hoverPosition = position;
+
+        if (this->hoverPosition_ == hoverPosition)
+        {
+            return;
         }
+
+        this->hoverPosition_ = hoverPosition;
+        this->UpdateCursor_();
     }
 
     bool IsDragging_() const
@@ -565,6 +646,9 @@ protected:
             return;
         }
 
+        // Clicks change the selection, and drags change the shapes.
+        this->hoverPosition_.reset();
+
         if (!isDown)
         {
             // Mouse has been released.
@@ -599,6 +683,11 @@ protected:
                 this->canvasControl_.modifier.Get(),
                 this->canvasControl_.cursor);
 
+            if (this->drag_ && this->dragPreview_)
+            {
+                this->drag_->SetPreview(this->dragPreview_);
+            }
+
             return;
         }
 
@@ -660,6 +749,8 @@ protected:
             return;
         }
 
+        this->hoverPosition_.reset();
+
         if (!isDown)
         {
             // Mouse has been released.
@@ -705,6 +796,7 @@ protected:
         if constexpr (HasRightClickMenu<Create>)
         {
             auto action = this->rightClickMenu_.GetAction(windowId);
+            this->hoverPosition_.reset();
 
             if (action)
             {
@@ -731,6 +823,24 @@ protected:
         }
     }
 
+    void OnCount_(size_t)
+    {
+        // Shapes have been added or removed.
+        this->hoverPosition_.reset();
+    }
+
+    void OnIsBatching_(bool isBatching)
+    {
+        if (isBatching)
+        {
+            this->BeginBatch();
+        }
+        else
+        {
+            this->EndBatch();
+        }
+    }
+
     void UpdateCursor_()
     {
         if (this->isProcessingAction_)
@@ -845,9 +955,19 @@ protected:
     pex::Endpoint<ShapeEditor, decltype(CanvasControl::menuId)>
         menuIdEndpoint_;
 
+    pex::Endpoint<ShapeEditor, decltype(ShapesControl::count)>
+        countEndpoint_;
+
+    using IsBatchingEndpoint = pex::Endpoint<ShapeEditor, IsBatchingControl>;
+    IsBatchingEndpoint isBatchingEndpoint_;
+
     std::unique_ptr<Drag> drag_;
+    DragPreviewBase *dragPreview_;
 
     RightClickMenu<Create> rightClickMenu_;
+
+    // The last logical pixel hit-tested for the cursor.
+    std::optional<tau::Point2d<int>> hoverPosition_;
 };
 
 
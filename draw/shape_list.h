@@ -1,6 +1,9 @@
 #pragma once
 
 
+#include <iterator>
+#include <optional>
+#include <vector>
 #include <fields/fields.h>
 #include <pex/ordered_list.h>
 #include "draw/shapes.h"
@@ -42,6 +45,9 @@ struct ShapeListTemplate
 
 using OrderedShapesControl = pex::ControlSelector<OrderedShapes>;
 
+using IsBatchingModel = pex::ModelSelector<bool>;
+using IsBatchingControl = pex::ControlSelector<bool>;
+
 
 struct ShapeListCustom
 {
@@ -52,6 +58,7 @@ struct ShapeListCustom
         Model()
             :
             Base(),
+            isBatching(),
 
             shapeAddedEndpoint_(
                 this,
@@ -66,11 +73,23 @@ struct ShapeListCustom
             indicesEndpoint_(
                 this,
                 this->shapes.indices,
-                &Model::OnShapesIndices_)
+                &Model::OnShapesIndices_),
+
+            isBatchingEndpoint_(
+                this,
+                this->isBatching,
+                &Model::OnIsBatching_),
+
+            pendingDisplays_(),
+            firstChanged_()
         {
             this->shapesDisplay.count.Set(this->shapes.count.Get());
         }
 
+        // True while a ShapeListBatch is open. It is not one of the fields,
+        // so it is not saved with the list.
+        IsBatchingModel isBatching;
+
     private:
         void OnShapeAdded_(const std::optional<size_t> &index)
         {
@@ -79,6 +98,18 @@ struct ShapeListCustom
                 return;
             }
 
+            if (this->isBatching.Get())
+            {
+                // The display for a new shape is created when the batch
+                // closes.
+                this->pendingDisplays_.emplace(
+                    std::next(this->pendingDisplays_.begin(), *index));
+
+                this->NoteChanged_(*index);
+
+                return;
+            }
+
             this->shapesDisplay.Insert(*index, ShapeDisplay{});
         }
 
@@ -89,14 +120,84 @@ struct ShapeListCustom
                 return;
             }
 
+            if (this->isBatching.Get())
+            {
+                this->pendingDisplays_.erase(
+                    std::next(this->pendingDisplays_.begin(), *index));
+
+                this->NoteChanged_(*index);
+
+                return;
+            }
+
             this->shapesDisplay.Erase(*index);
         }
 
         void OnShapesIndices_(const std::vector<size_t> &indices)
         {
+            if (this->isBatching.Get())
+            {
+                return;
+            }
+
             this->shapesDisplay.indices.Set(indices);
         }
 
+        void NoteChanged_(size_t index)
+        {
+            if (!this->firstChanged_ || index < *this->firstChanged_)
+            {
+                this->firstChanged_ = index;
+            }
+        }
+
+        void OnIsBatching_(bool isBatching_)
+        {
+            if (isBatching_)
+            {
+                // Track the displays of the existing shapes as they move.
+                auto count = this->shapesDisplay.count.Get();
+                this->pendingDisplays_.clear();
+                this->pendingDisplays_.reserve(count);
+
+                for (size_t i = 0; i < count; ++i)
+                {
+                    this->pendingDisplays_.emplace_back(
+                        this->shapesDisplay.at(i).Get());
+                }
+
+                this->firstChanged_.reset();
+
+                return;
+            }
+
+            if (this->firstChanged_)
+            {
+                // Resize once, then restore the displays that moved.
+                auto previousCount = this->shapesDisplay.count.Get();
+                auto count = this->pendingDisplays_.size();
+                this->shapesDisplay.count.Set(count);
+
+                for (size_t i = *this->firstChanged_; i < count; ++i)
+                {
+                    const auto &display = this->pendingDisplays_[i];
+
+                    if (display)
+                    {
+                        this->shapesDisplay.at(i).Set(*display);
+                    }
+                    else if (i < previousCount)
+                    {
+                        this->shapesDisplay.at(i).Set(ShapeDisplay{});
+                    }
+                }
+            }
+
+            this->shapesDisplay.indices.Set(this->shapes.indices.Get());
+            this->pendingDisplays_.clear();
+            this->firstChanged_.reset();
+        }
+
     private:
         using CountEndpoint = pex::Endpoint<Model, pex::model::ListCount>;
 
@@ -117,6 +218,61 @@ struct ShapeListCustom
             >;
 
         IndicesEndpoint indicesEndpoint_;
+
+        using IsBatchingEndpoint = pex::Endpoint<Model, IsBatchingControl>;
+
+        IsBatchingEndpoint isBatchingEndpoint_;
+
+        // Displays of shapes that existed when the batch opened, and empty
+        // entries for shapes added since.
+        std::vector<std::optional<ShapeDisplay>> pendingDisplays_;
+        std::optional<size_t> firstChanged_;
+    };
+
+    template<typename Base>
+    struct Control: public Base
+    {
+        using Base::Base;
+
+        Control()
+            :
+            Base(),
+            isBatching()
+        {
+
+        }
+
+        Control(typename Base::Upstream &upstream)
+            :
+            Base(upstream),
+            isBatching(upstream.isBatching)
+        {
+
+        }
+
+        Control(const Control &other)
+            :
+            Base(other),
+            isBatching(other.isBatching)
+        {
+
+        }
+
+        Control & operator=(const Control &other)
+        {
+            this->Base::operator=(other);
+            this->isBatching = other.isBatching;
+
+            return *this;
+        }
+
+        void Emplace(const Control &other)
+        {
+            this->StandardEmplace_(other);
+            this->isBatching.Emplace(other.isBatching);
+        }
+
+        IsBatchingControl isBatching;
     };
 };
 
@@ -129,6 +285,77 @@ using ShapeListControl = typename ShapeListGroup::DefaultControl;
 using ShapesControl = decltype(ShapeListControl::shapes);
 using ListedShape = typename ShapesControl::ListItem;
 
+
+/**
+ ** Groups changes to a shape list so that observers update once.
+ **
+ ** The shapes change immediately, but the shape displays, selection brains,
+ ** and views wait for the batch to close before they catch up in a single
+ ** pass. Batches may be nested; only the outermost batch notifies.
+ **/
+class ShapeListBatch
+{
+public:
+    ShapeListBatch(const ShapeListControl &control)
+        :
+        control_(control),
+        isOwner_(!control.isBatching.Get())
+    {
+        if (this->isOwner_)
+        {
+            this->control_.isBatching.Set(true);
+        }
+    }
+
+    ~ShapeListBatch()
+    {
+        this->Commit();
+    }
+
+    ShapeListBatch(const ShapeListBatch &) = delete;
+    ShapeListBatch & operator=(const ShapeListBatch &) = delete;
+
+    void Append(const ShapeValueWrapper &shape)
+    {
+        this->control_.shapes.Append(shape);
+    }
+
+    void Erase(size_t unordered)
+    {
+        this->control_.shapes.Erase(unordered);
+    }
+
+    void Clear()
+    {
+        this->control_.shapes.count.Set(0);
+    }
+
+    // Replace every shape in the list.
+    void Replace(const std::vector<ShapeValueWrapper> &shapes)
+    {
+        this->Clear();
+
+        for (auto &shape: shapes)
+        {
+            this->Append(shape);
+        }
+    }
+
+    // Close the batch before it goes out of scope.
+    void Commit()
+    {
+        if (this->isOwner_)
+        {
+            this->isOwner_ = false;
+            this->control_.isBatching.Set(false);
+        }
+    }
+
+private:
+    ShapeListControl control_;
+    bool isOwner_;
+};
+
 template<typename Observer>
 using ShapesEndpoint = pex::Endpoint<Observer, ShapesControl>;
 
@@ -0,0 +1,574 @@
+#include "draw/shape_serializer.h"
+
+#include <cstring>
+#include <optional>
+#include <fmt/core.h>
+
+#include "draw/cross_shape.h"
+#include "draw/ellipse_shape.h"
+#include "draw/polygon_shape.h"
+#include "draw/quad_shape.h"
+#include "draw/regular_polygon_shape.h"
+
+
+namespace draw
+{
+
+
+static constexpr auto jsonFormatName = "draw.shapes";
+static constexpr int64_t jsonVersion = 1;
+static constexpr char binaryMagic[] = {'D', 'R', 'W', 'S', 'H', 'P', '0', '1'};
+
+
+double SerializeStats::GetShapesPerSecond() const
+{
+    if (this->seconds <= 0.0)
+    {
+        return 0.0;
+    }
+
+    return static_cast<double>(this->shapeCount) / this->seconds;
+}
+
+
+double SerializeStats::GetMegabytesPerSecond() const
+{
+    if (this->seconds <= 0.0)
+    {
+        return 0.0;
+    }
+
+    return static_cast<double>(this->byteCount) / (1.0e6 * this->seconds);
+}
+
+
+std::ostream & operator<<(std::ostream &output, const SerializeStats &stats)
+{
+    return output << fmt::format(
+        "{} shapes, {} bytes in {:.3f} ms ({:.0f} shapes/s, {:.1f} MB/s)",
+        stats.shapeCount,
+        stats.byteCount,
+        stats.seconds * 1000.0,
+        stats.GetShapesPerSecond(),
+        stats.GetMegabytesPerSecond());
+}
+
+
+const ShapeRegistry & ShapeRegistry::GetDefault()
+{
+    static const ShapeRegistry registry = []()
+    {
+        ShapeRegistry result;
+        result.Register<CrossShape>();
+        result.Register<EllipseShape>();
+        result.Register<PolygonShape>();
+        result.Register<QuadShape>();
+        result.Register<RegularPolygonShape>();
+
+        return result;
+    }();
+
+    return registry;
+}
+
+
+const ShapeCodec * ShapeRegistry::Find(const Shape &shape) const
+{
+    auto found = this->byType_.find(std::type_index(typeid(shape)));
+
+    if (found == this->byType_.end())
+    {
+        return nullptr;
+    }
+
+    return found->second.get();
+}
+
+
+const ShapeCodec * ShapeRegistry::Find(const std::string &typeName) const
+{
+    auto found = this->byName_.find(typeName);
+
+    if (found == this->byName_.end())
+    {
+        return nullptr;
+    }
+
+    return found->second.get();
+}
+
+
+ShapeWriter::ShapeWriter(
+    std::ostream &output,
+    ShapeFormat format,
+    const ShapeRegistry &registry)
+    :
+    output_(output),
+    format_(format),
+    registry_(registry),
+    jsonWriter_(output),
+    payload_(),
+    isFinished_(false),
+    stats_(),
+    start_(Clock::now()),
+    startPosition_(output.tellp())
+{
+    if (this->format_ == ShapeFormat::binary)
+    {
+        this->output_.write(binaryMagic, sizeof(binaryMagic));
+
+        return;
+    }
+
+    this->jsonWriter_.BeginObject();
+    this->jsonWriter_.Key("format");
+    this->jsonWriter_.String(jsonFormatName);
+    this->jsonWriter_.Key("version");
+    this->jsonWriter_.Number(jsonVersion);
+    this->jsonWriter_.Key("shapes");
+    this->jsonWriter_.BeginArray();
+}
+
+
+ShapeWriter::~ShapeWriter()
+{
+    if (!this->isFinished_)
+    {
+        this->Finish();
+    }
+}
+
+
+void ShapeWriter::Write(const Shape &shape)
+{
+    auto codec = this->registry_.Find(shape);
+
+    if (!codec)
+    {
+        throw DrawError("Unregistered shape: " + shape.GetName());
+    }
+
+    auto typeName = codec->GetTypeName();
+
+    if (this->format_ == ShapeFormat::json)
+    {
+        this->jsonWriter_.BeginObject();
+        this->jsonWriter_.Key("type");
+        this->jsonWriter_.String(typeName);
+        this->jsonWriter_.Key("value");
+        codec->WriteJson(this->jsonWriter_, shape);
+        this->jsonWriter_.EndObject();
+    }
+    else
+    {
+        // The payload is prefixed by its size, so the archive can step over
+        // it without reading it.
+        this->payload_.clear();
+        detail::BinaryWriter writer(this->payload_);
+        codec->WriteBinary(writer, shape);
+
+        auto nameSize = static_cast<uint16_t>(typeName.size());
+        auto payloadSize = static_cast<uint64_t>(this->payload_.size());
+
+        this->output_.write(
+            reinterpret_cast<const char *>(&nameSize),
+            sizeof(nameSize));
+
+        this->output_.write(typeName.data(), nameSize);
+
+        this->output_.write(
+            reinterpret_cast<const char *>(&payloadSize),
+            sizeof(payloadSize));
+
+        this->output_.write(
+            this->payload_.data(),
+            static_cast<std::streamsize>(this->payload_.size()));
+    }
+
+    ++this->stats_.shapeCount;
+}
+
+
+SerializeStats ShapeWriter::Finish()
+{
+    if (this->isFinished_)
+    {
+        return this->stats_;
+    }
+
+    this->isFinished_ = true;
+
+    if (this->format_ == ShapeFormat::json)
+    {
+        this->jsonWriter_.EndArray();
+        this->jsonWriter_.EndObject();
+    }
+
+    this->output_.flush();
+
+    std::chrono::duration<double> elapsed = Clock::now() - this->start_;
+    this->stats_.seconds = elapsed.count();
+
+    auto endPosition = this->output_.tellp();
+
+    if (endPosition != std::streampos(-1)
+            && this->startPosition_ != std::streampos(-1))
+    {
+        this->stats_.byteCount =
+            static_cast<uint64_t>(endPosition - this->startPosition_);
+    }
+
+    return this->stats_;
+}
+
+
+ShapeArchive::ShapeArchive(std::istream &input, const ShapeRegistry &registry)
+    :
+    input_(input),
+    registry_(registry),
+    format_(ShapeFormat::json),
+    jsonReader_(),
+    typeNames_(),
+    entries_(),
+    payload_(),
+    indexStats_()
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto startPosition = this->input_.tellg();
+
+    char magic[sizeof(binaryMagic)]{};
+    this->input_.read(magic, sizeof(magic));
+
+    if (this->input_.gcount() == sizeof(magic)
+            && std::memcmp(magic, binaryMagic, sizeof(magic)) == 0)
+    {
+        this->format_ = ShapeFormat::binary;
+        this->IndexBinary_();
+    }
+    else
+    {
+        this->input_.clear();
+        this->input_.seekg(startPosition);
+        this->jsonReader_ = std::make_unique<detail::JsonReader>(this->input_);
+        this->IndexJson_();
+    }
+
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    this->indexStats_.seconds = elapsed.count();
+    this->indexStats_.shapeCount = this->entries_.size();
+
+    uint64_t endPosition = 0;
+
+    if (this->format_ == ShapeFormat::json)
+    {
+        // The reader keeps its own position in the stream.
+        endPosition = this->jsonReader_->Tell();
+    }
+    else
+    {
+        this->input_.clear();
+        this->input_.seekg(0, std::ios::end);
+        endPosition = static_cast<uint64_t>(this->input_.tellg());
+    }
+
+    this->indexStats_.byteCount =
+        endPosition - static_cast<uint64_t>(startPosition);
+}
+
+
+ShapeFormat ShapeArchive::GetFormat() const
+{
+    return this->format_;
+}
+
+
+size_t ShapeArchive::GetCount() const
+{
+    return this->entries_.size();
+}
+
+
+const std::string & ShapeArchive::GetTypeName(size_t index) const
+{
+    return this->typeNames_.at(this->entries_.at(index).typeIndex);
+}
+
+
+ShapeValueWrapper ShapeArchive::Load(size_t index)
+{
+    const auto &entry = this->entries_.at(index);
+    const auto &typeName = this->typeNames_[entry.typeIndex];
+    auto codec = this->registry_.Find(typeName);
+
+    if (!codec)
+    {
+        throw DrawError("Unregistered shape: " + typeName);
+    }
+
+    if (this->format_ == ShapeFormat::json)
+    {
+        this->jsonReader_->Seek(entry.offset);
+
+        return codec->ReadJson(*this->jsonReader_);
+    }
+
+    this->payload_.resize(static_cast<size_t>(entry.size));
+    this->input_.clear();
+    this->input_.seekg(static_cast<std::streamoff>(entry.offset));
+
+    this->input_.read(
+        this->payload_.data(),
+        static_cast<std::streamsize>(entry.size));
+
+    if (static_cast<uint64_t>(this->input_.gcount()) != entry.size)
+    {
+        throw DrawError("Unexpected end of binary shapes");
+    }
+
+    detail::BinaryReader reader(this->payload_.data(), this->payload_.size());
+
+    return codec->ReadBinary(reader);
+}
+
+
+const SerializeStats & ShapeArchive::GetIndexStats() const
+{
+    return this->indexStats_;
+}
+
+
+SerializeStats ShapeArchive::LoadAll(ShapeListControl shapeList)
+{
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+
+    SerializeStats stats{};
+    stats.byteCount = this->indexStats_.byteCount;
+
+    std::vector<ShapeValueWrapper> loaded;
+    loaded.reserve(this->entries_.size());
+
+    // Parse every shape before the list is changed, so a malformed file
+    // leaves the list as it was.
+    for (size_t i = 0; i < this->entries_.size(); ++i)
+    {
+        loaded.push_back(this->Load(i));
+    }
+
+    // Displays and views catch up once, instead of once for each shape.
+    ShapeListBatch batch(shapeList);
+    batch.Replace(loaded);
+    batch.Commit();
+
+    std::chrono::duration<double> elapsed = Clock::now() - start;
+    stats.seconds = elapsed.count();
+    stats.shapeCount = loaded.size();
+
+    return stats;
+}
+
+
+size_t ShapeArchive::GetTypeIndex_(const std::string &typeName)
+{
+    // Files hold few types of shape, so a linear search is enough.
+    for (size_t i = 0; i < this->typeNames_.size(); ++i)
+    {
+        if (this->typeNames_[i] == typeName)
+        {
+            return i;
+        }
+    }
+
+    this->typeNames_.push_back(typeName);
+
+    return this->typeNames_.size() - 1;
+}
+
+
+void ShapeArchive::IndexJson_()
+{
+    auto &reader = *this->jsonReader_;
+    bool hasShapes = false;
+
+    reader.Expect('{');
+
+    if (reader.Consume('}'))
+    {
+        return;
+    }
+
+    do
+    {
+        std::string key(reader.ReadString());
+        reader.Expect(':');
+
+        if (key == "format")
+        {
+            if (reader.ReadString() != jsonFormatName)
+            {
+                throw DrawError("Not a shapes file");
+            }
+        }
+        else if (key == "version")
+        {
+            auto version = reader.ReadNumber<int64_t>();
+
+            if (version > jsonVersion)
+            {
+                throw DrawError(
+                    fmt::format("Unsupported shapes version: {}", version));
+            }
+        }
+        else if (key == "shapes" && !hasShapes)
+        {
+            hasShapes = true;
+            reader.Expect('[');
+
+            if (reader.Consume(']'))
+            {
+                continue;
+            }
+
+            do
+            {
+                reader.Expect('{');
+
+                std::string typeName;
+                std::optional<uint64_t> offset;
+
+                if (!reader.Consume('}'))
+                {
+                    do
+                    {
+                        std::string member(reader.ReadString());
+                        reader.Expect(':');
+
+                        if (member == "type")
+                        {
+                            typeName = reader.ReadString();
+                        }
+                        else if (member == "value")
+                        {
+                            // Record where the value begins, then step over
+                            // it without storing anything.
+                            reader.Peek();
+                            offset = reader.Tell();
+                            reader.SkipValue();
+                        }
+                        else
+                        {
+                            reader.SkipValue();
+                        }
+                    }
+                    while (reader.Consume(','));
+
+                    reader.Expect('}');
+                }
+
+                if (typeName.empty() || !offset)
+                {
+                    throw DrawError("Shape is missing its type or value");
+                }
+
+                uint64_t end = reader.Tell();
+
+                this->entries_.push_back(
+                    {*offset, end - *offset, this->GetTypeIndex_(typeName)});
+            }
+            while (reader.Consume(','));
+
+            reader.Expect(']');
+        }
+        else
+        {
+            reader.SkipValue();
+        }
+    }
+    while (reader.Consume(','));
+
+    reader.Expect('}');
+}
+
+
+void ShapeArchive::IndexBinary_()
+{
+    std::string typeName;
+
+    while (true)
+    {
+        uint16_t nameSize = 0;
+
+        this->input_.read(
+            reinterpret_cast<char *>(&nameSize),
+            sizeof(nameSize));
+
+        if (this->input_.gcount() == 0)
+        {
+            // The end of the file.
+            return;
+        }
+
+        uint64_t payloadSize = 0;
+        typeName.resize(nameSize);
+        this->input_.read(typeName.data(), nameSize);
+
+        this->input_.read(
+            reinterpret_cast<char *>(&payloadSize),
+            sizeof(payloadSize));
+
+        if (!this->input_)
+        {
+            throw DrawError("Unexpected end of binary shapes");
+        }
+
+        auto offset = static_cast<uint64_t>(this->input_.tellg());
+
+        this->entries_.push_back(
+            {offset, payloadSize, this->GetTypeIndex_(typeName)});
+
+        // Step over the payload. It is read when the shape is loaded.
+        this->input_.seekg(
+            static_cast<std::streamoff>(payloadSize),
+            std::ios::cur);
+
+        if (!this->input_)
+        {
+            throw DrawError("Unexpected end of binary shapes");
+        }
+    }
+}
+
+
+SerializeStats SaveShapes(
+    ShapesControl shapes,
+    std::ostream &output,
+    ShapeFormat format,
+    const ShapeRegistry &registry)
+{
+    ShapeWriter writer(output, format, registry);
+
+    auto count = shapes.count.Get();
+
+    for (size_t index = 0; index < count; ++index)
+    {
+        auto value = shapes.at(index).Get();
+        writer.Write(*value.GetValueBase());
+    }
+
+    return writer.Finish();
+}
+
+
+SerializeStats LoadShapes(
+    ShapeListControl shapeList,
+    std::istream &input,
+    const ShapeRegistry &registry)
+{
+    ShapeArchive archive(input, registry);
+
+    return archive.LoadAll(shapeList);
+}
+
+
+} // end namespace draw
@@ -0,0 +1,247 @@
+#pragma once
+
+
+#include <chrono>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+#include "draw/shapes.h"
+#include "draw/shape_list.h"
+#include "draw/field_serializer.h"
+
+
+namespace draw
+{
+
+
+enum class ShapeFormat
+{
+    // Keys are written, so files survive changes to the shapes.
+    json,
+
+    // Fields are written in order without keys, for speed.
+    binary
+};
+
+
+struct SerializeStats
+{
+    size_t shapeCount = 0;
+    uint64_t byteCount = 0;
+    double seconds = 0.0;
+
+    double GetShapesPerSecond() const;
+    double GetMegabytesPerSecond() const;
+};
+
+
+std::ostream & operator<<(std::ostream &output, const SerializeStats &stats);
+
+
+// Reads and writes one type of shape.
+class ShapeCodec
+{
+public:
+    virtual ~ShapeCodec() {}
+
+    virtual std::string GetTypeName() const = 0;
+
+    virtual void WriteJson(
+        detail::JsonWriter &writer,
+        const Shape &shape) const = 0;
+
+    virtual ShapeValueWrapper ReadJson(detail::JsonReader &reader) const = 0;
+
+    virtual void WriteBinary(
+        detail::BinaryWriter &writer,
+        const Shape &shape) const = 0;
+
+    virtual ShapeValueWrapper ReadBinary(
+        detail::BinaryReader &reader) const = 0;
+};
+
+
+template<typename Derived>
+class DerivedShapeCodec: public ShapeCodec
+{
+public:
+    std::string GetTypeName() const override
+    {
+        return Derived::fieldsTypeName;
+    }
+
+    void WriteJson(
+        detail::JsonWriter &writer,
+        const Shape &shape) const override
+    {
+        ::draw::WriteJson(writer, dynamic_cast<const Derived &>(shape));
+    }
+
+    ShapeValueWrapper ReadJson(detail::JsonReader &reader) const override
+    {
+        Derived value{};
+        ::draw::ReadJson(reader, value);
+
+        return ShapeValueWrapper::Create<Derived>(std::move(value));
+    }
+
+    void WriteBinary(
+        detail::BinaryWriter &writer,
+        const Shape &shape) const override
+    {
+        ::draw::WriteBinary(writer, dynamic_cast<const Derived &>(shape));
+    }
+
+    ShapeValueWrapper ReadBinary(detail::BinaryReader &reader) const override
+    {
+        Derived value{};
+        ::draw::ReadBinary(reader, value);
+
+        return ShapeValueWrapper::Create<Derived>(std::move(value));
+    }
+};
+
+
+/**
+ ** The shape types that can be saved, found by their fieldsTypeName.
+ **/
+class ShapeRegistry
+{
+public:
+    // A registry of the shapes defined by draw.
+    static const ShapeRegistry & GetDefault();
+
+    template<typename Derived>
+    void Register()
+    {
+        auto codec = std::make_shared<DerivedShapeCodec<Derived>>();
+        this->byType_[std::type_index(typeid(Derived))] = codec;
+        this->byName_[codec->GetTypeName()] = codec;
+    }
+
+    // @return nullptr if the type of shape is not registered.
+    const ShapeCodec * Find(const Shape &shape) const;
+
+    const ShapeCodec * Find(const std::string &typeName) const;
+
+private:
+    std::unordered_map<std::type_index, std::shared_ptr<ShapeCodec>> byType_;
+    std::unordered_map<std::string, std::shared_ptr<ShapeCodec>> byName_;
+};
+
+
+/**
+ ** Writes shapes to a stream as they are added, without building a
+ ** document.
+ **/
+class ShapeWriter
+{
+public:
+    ShapeWriter(
+        std::ostream &output,
+        ShapeFormat format,
+        const ShapeRegistry &registry = ShapeRegistry::GetDefault());
+
+    ~ShapeWriter();
+
+    ShapeWriter(const ShapeWriter &) = delete;
+    ShapeWriter & operator=(const ShapeWriter &) = delete;
+
+    // Throws DrawError if the type of shape is not registered.
+    void Write(const Shape &shape);
+
+    // Complete the file. Called by the destructor if necessary.
+    SerializeStats Finish();
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::ostream &output_;
+    ShapeFormat format_;
+    const ShapeRegistry &registry_;
+    detail::JsonWriter jsonWriter_;
+    std::string payload_;
+    bool isFinished_;
+
+    SerializeStats stats_;
+    Clock::time_point start_;
+    std::streampos startPosition_;
+};
+
+
+/**
+ ** Reads shapes on demand from a stream written by ShapeWriter.
+ **
+ ** Opening the archive reads only enough to find where each shape begins.
+ ** Shapes are parsed when they are loaded. The stream must remain valid and
+ ** seekable for the life of the archive.
+ **/
+class ShapeArchive
+{
+public:
+    ShapeArchive(
+        std::istream &input,
+        const ShapeRegistry &registry = ShapeRegistry::GetDefault());
+
+    ShapeFormat GetFormat() const;
+
+    size_t GetCount() const;
+
+    const std::string & GetTypeName(size_t index) const;
+
+    // Throws DrawError if the type of shape is not registered.
+    ShapeValueWrapper Load(size_t index);
+
+    // The cost of finding the shapes.
+    const SerializeStats & GetIndexStats() const;
+
+    // Replace the shapes in a list with every shape in the archive, in one
+    // ShapeListBatch.
+    SerializeStats LoadAll(ShapeListControl shapeList);
+
+private:
+    struct Entry
+    {
+        uint64_t offset;
+        uint64_t size;
+        size_t typeIndex;
+    };
+
+    size_t GetTypeIndex_(const std::string &typeName);
+
+    void IndexJson_();
+
+    void IndexBinary_();
+
+private:
+    std::istream &input_;
+    const ShapeRegistry &registry_;
+    ShapeFormat format_;
+    std::unique_ptr<detail::JsonReader> jsonReader_;
+    std::vector<std::string> typeNames_;
+    std::vector<Entry> entries_;
+    std::string payload_;
+    SerializeStats indexStats_;
+};
+
+
+SerializeStats SaveShapes(
+    ShapesControl shapes,
+    std::ostream &output,
+    ShapeFormat format,
+    const ShapeRegistry &registry = ShapeRegistry::GetDefault());
+
+
+SerializeStats LoadShapes(
+    ShapeListControl shapeList,
+    std::istream &input,
+    const ShapeRegistry &registry = ShapeRegistry::GetDefault());
+
+
+} // end namespace draw
@@ -0,0 +1,259 @@
+#include "draw/spline_tessellator.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "draw/detail/parallel.h"
+#include "draw/trace.h"
+
+
+namespace draw
+{
+
+
+using Point = PointDouble;
+
+
+std::vector<Point> GetDerivatives(
+    std::span<const Point> points,
+    const Point &firstDerivative,
+    const Point &lastDerivative)
+{
+    if (points.size() < 2)
+    {
+        return {};
+    }
+
+    std::vector<Point> result(points.size());
+
+    result.front() = firstDerivative;
+    result.back() = lastDerivative;
+
+    static constexpr double oneSixth = 1.0 / 6.0;
+
+    // For all intervening points, the tangent is average of the points that
+    // come before and after.
+    for (std::size_t i = 1; i + 1 < points.size(); ++i)
+    {
+        result[i] = oneSixth * (points[i + 1] - points[i - 1]);
+    }
+
+    return result;
+}
+
+
+std::vector<Point> GetDerivatives(std::span<const Point> points)
+{
+    if (points.size() < 2)
+    {
+        return {};
+    }
+
+    std::vector<Point> result(points.size());
+
+    // The first and last points define the tangent end points.
+    result.front() = points[1] - points[0];
+    result.back() = points.back() - points[points.size() - 2];
+
+    static constexpr double oneSixth = 1.0 / 6.0;
+
+    // For all intervening points, the tangent is average of the points that
+    // come before and after.
+    for (std::size_t i = 1; i + 1 < points.size(); ++i)
+    {
+        result[i] = oneSixth * (points[i + 1] - points[i - 1]);
+    }
+
+    return result;
+}
+
+
+namespace detail
+{
+
+
+// Segments are divided among threads in bands of at least this many.
+static constexpr size_t minimumSplineBand = 4096;
+
+// Guards against huge splines at extreme zoom.
+static constexpr size_t maximumLinesPerSegment = 1024;
+
+
+/**
+ ** The number of lines that keep a cubic within tolerance, by Wang's
+ ** formula.
+ **/
+inline size_t GetLineCount(
+    const Point &start,
+    const Point &startControl,
+    const Point &endControl,
+    const Point &end,
+    double tolerance)
+{
+    auto firstX = start.x - 2.0 * startControl.x + endControl.x;
+    auto firstY = start.y - 2.0 * startControl.y + endControl.y;
+    auto secondX = startControl.x - 2.0 * endControl.x + end.x;
+    auto secondY = startControl.y - 2.0 * endControl.y + end.y;
+
+    auto bend = std::sqrt(
+        std::max(
+            firstX * firstX + firstY * firstY,
+            secondX * secondX + secondY * secondY));
+
+    auto count = std::ceil(std::sqrt(0.75 * bend / tolerance));
+
+    // Also catches NaN.
+    if (!(count >= 1.0))
+    {
+        return 1;
+    }
+
+    return std::min(static_cast<size_t>(count), maximumLinesPerSegment);
+}
+
+
+} // end namespace detail
+
+
+SplineTessellation TessellateTangentSpline(
+    std::span<const Point> points,
+    std::span<const Point> derivatives,
+    double tolerance)
+{
+    DRAW_TRACE_SCOPE("spline.tessellate");
+
+    SplineTessellation result;
+    result.tolerance = tolerance;
+
+    if (points.size() < 2 || derivatives.size() != points.size())
+    {
+        return result;
+    }
+
+    auto segmentCount = points.size() - 1;
+    result.offsets.resize(segmentCount + 1);
+
+    // Count the lines of every segment, then place each segment's lines
+    // after those of the segments before it.
+    detail::ParallelBands(
+        segmentCount,
+        detail::minimumSplineBand,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                result.offsets[i + 1] = detail::GetLineCount(
+                    points[i],
+                    points[i] + derivatives[i],
+                    points[i + 1] - derivatives[i + 1],
+                    points[i + 1],
+                    tolerance);
+            }
+        });
+
+    result.offsets[0] = 0;
+
+    for (size_t i = 1; i <= segmentCount; ++i)
+    {
+        result.offsets[i] += result.offsets[i - 1];
+    }
+
+    result.points.resize(result.offsets.back() + 1);
+
+    detail::ParallelBands(
+        segmentCount,
+        detail::minimumSplineBand,
+        [&](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                Point start = points[i];
+                Point startControl = start + derivatives[i];
+                Point endControl = points[i + 1] - derivatives[i + 1];
+                Point finish = points[i + 1];
+
+                auto offset = result.offsets[i];
+                auto count = result.offsets[i + 1] - offset;
+                auto step = 1.0 / static_cast<double>(count);
+
+                // The last point of each segment is the first of the next.
+                for (size_t k = 0; k < count; ++k)
+                {
+                    auto t = step * static_cast<double>(k);
+                    auto s = 1.0 - t;
+
+                    auto a = s * s * s;
+                    auto b = 3.0 * s * s * t;
+                    auto c = 3.0 * s * t * t;
+                    auto d = t * t * t;
+
+                    result.points[offset + k] = Point(
+                        a * start.x + b * startControl.x
+                            + c * endControl.x + d * finish.x,
+                        a * start.y + b * startControl.y
+                            + c * endControl.y + d * finish.y);
+                }
+            }
+        });
+
+    result.points.back() = points.back();
+
+    return result;
+}
+
+
+SplineTessellator::SplineTessellator(double pixelTolerance)
+    :
+    pixelTolerance_(pixelTolerance),
+    points_(),
+    derivatives_(),
+    level_(),
+    tessellation_()
+{
+
+}
+
+
+void SplineTessellator::SetPoints(std::span<const Point> points)
+{
+    this->SetPoints(points, GetDerivatives(points));
+}
+
+
+void SplineTessellator::SetPoints(
+    std::span<const Point> points,
+    std::span<const Point> derivatives)
+{
+    this->points_.assign(points.begin(), points.end());
+    this->derivatives_.assign(derivatives.begin(), derivatives.end());
+    this->level_.reset();
+}
+
+
+const SplineTessellation & SplineTessellator::Get(double zoom)
+{
+    if (!(zoom > 0.0) || !std::isfinite(zoom))
+    {
+        zoom = 1.0;
+    }
+
+    // Round the tolerance down to a power of two, so that small changes in
+    // zoom reuse the tessellation without exceeding the pixel tolerance.
+    auto level = static_cast<int>(
+        std::floor(std::log2(this->pixelTolerance_ / zoom)));
+
+    if (this->level_ != level)
+    {
+        this->tessellation_ = TessellateTangentSpline(
+            this->points_,
+            this->derivatives_,
+            std::ldexp(1.0, level));
+
+        this->level_ = level;
+    }
+
+    return this->tessellation_;
+}
+
+
+} // end namespace draw
@@ -0,0 +1,106 @@
+#pragma once
+
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "draw/points.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** The tangent at each point of a spline, as the offset to the control
+ ** point that follows it.
+ **
+ ** The first and last tangents point along the first and last segments.
+ **/
+std::vector<PointDouble> GetDerivatives(std::span<const PointDouble> points);
+
+
+std::vector<PointDouble> GetDerivatives(
+    std::span<const PointDouble> points,
+    const PointDouble &firstDerivative,
+    const PointDouble &lastDerivative);
+
+
+// A tangent spline flattened into a polyline.
+struct SplineTessellation
+{
+    PointsDouble points;
+
+    // Segment i of the spline is drawn from points[offsets[i]] to
+    // points[offsets[i + 1]], inclusive.
+    std::vector<size_t> offsets;
+
+    // The furthest any point of the polyline is from the curve.
+    double tolerance = 0.0;
+
+    size_t GetSegmentCount() const
+    {
+        return this->offsets.empty() ? 0 : this->offsets.size() - 1;
+    }
+
+    std::span<const PointDouble> GetSegment(size_t index) const
+    {
+        auto begin = this->offsets.at(index);
+        auto end = this->offsets.at(index + 1);
+
+        return std::span<const PointDouble>(this->points).subspan(
+            begin,
+            end - begin + 1);
+    }
+};
+
+
+/**
+ ** Flatten the cubic segments drawn by DrawTangentSpline.
+ **
+ ** Each segment is divided evenly into the fewest lines that keep within
+ ** tolerance of the curve. Large splines are divided across threads.
+ **
+ ** @param tolerance In the units of the points.
+ **/
+SplineTessellation TessellateTangentSpline(
+    std::span<const PointDouble> points,
+    std::span<const PointDouble> derivatives,
+    double tolerance);
+
+
+/**
+ ** Keeps the tessellation of a spline for a range of zoom levels.
+ **
+ ** The tolerance is given in screen pixels. The spline is tessellated again
+ ** only when the zoom changes by more than a factor of two.
+ **/
+class SplineTessellator
+{
+public:
+    static constexpr double defaultPixelTolerance = 0.25;
+
+    SplineTessellator(double pixelTolerance = defaultPixelTolerance);
+
+    void SetPoints(std::span<const PointDouble> points);
+
+    void SetPoints(
+        std::span<const PointDouble> points,
+        std::span<const PointDouble> derivatives);
+
+    // @param zoom Screen pixels for each unit of the points.
+    const SplineTessellation & Get(double zoom);
+
+private:
+    double pixelTolerance_;
+    PointsDouble points_;
+    PointsDouble derivatives_;
+
+    // The tessellation is cached for a tolerance of 2^level.
+    std::optional<int> level_;
+    SplineTessellation tessellation_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,471 @@
+#include "draw/streaming_waveform.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstring>
+
+#include "draw/error.h"
+#include "draw/trace.h"
+
+
+namespace draw
+{
+
+
+// Fewer histogram columns than this are drawn on the calling thread.
+static constexpr Eigen::Index minimumDrawBand = 32;
+
+
+StreamingWaveform::StreamingWaveform(
+    const WaveformSettings &waveformSettings,
+    const Size &imageSize,
+    Eigen::Index dataColumnsPerColumn)
+    :
+    imageSize_(imageSize),
+    levelCount_(static_cast<Eigen::Index>(waveformSettings.levelCount)),
+    columnCount_(static_cast<Eigen::Index>(waveformSettings.columnCount)),
+    dataColumnsPerColumn_(dataColumnsPerColumn),
+    levelScale_(
+        static_cast<float>(waveformSettings.levelCount - 1)
+        / static_cast<float>(
+            std::max(waveformSettings.maximumValue, size_t{1}))),
+    colors_(
+        MakeWaveformColorRange(
+            waveformSettings.color,
+            waveformSettings.color.color)),
+    beginRows_(static_cast<size_t>(this->levelCount_)),
+    endRows_(static_cast<size_t>(this->levelCount_)),
+    counts_(),
+    columnMaximums_(),
+    fixedColorMaximum_(adaptiveColors),
+    colorMaximum_(0),
+    head_(0),
+    headDataCount_(0),
+    filledCount_(0),
+    pixels_(),
+    spares_()
+{
+    if (imageSize.width <= 0 || imageSize.height <= 0)
+    {
+        throw DrawError("StreamingWaveform requires an image");
+    }
+
+    if (this->levelCount_ < 1 || this->columnCount_ < 1)
+    {
+        throw DrawError("StreamingWaveform requires levels and columns");
+    }
+
+    if (this->dataColumnsPerColumn_ < 1)
+    {
+        throw DrawError("Each column must hold at least one column of data");
+    }
+
+    auto height = imageSize.height;
+
+    auto heightFactor = waveformSettings.verticalScale
+        * static_cast<double>(height)
+        / static_cast<double>(this->levelCount_);
+
+    for (Eigen::Index level = 0; level < this->levelCount_; ++level)
+    {
+        // Row zero of the counts is the highest level, drawn at the top.
+        auto logicalRow = this->levelCount_ - level - 1;
+
+        auto resultRow = static_cast<SizeType>(
+            FloatToIndex(static_cast<double>(logicalRow) * heightFactor));
+
+        auto nextRow = static_cast<SizeType>(
+            FloatToIndex(static_cast<double>(logicalRow + 1) * heightFactor));
+
+        nextRow = std::min(height, nextRow);
+        resultRow = std::min(resultRow, nextRow);
+
+        this->beginRows_[static_cast<size_t>(level)] = height - nextRow;
+        this->endRows_[static_cast<size_t>(level)] = height - resultRow;
+    }
+
+    this->Reset();
+}
+
+
+void StreamingWaveform::Reset()
+{
+    this->counts_ = Counts::Zero(this->levelCount_, this->columnCount_);
+
+    this->columnMaximums_.assign(
+        static_cast<size_t>(this->columnCount_),
+        0);
+
+    this->colorMaximum_ = this->fixedColorMaximum_;
+
+    // The first column of data moves the head to column zero.
+    this->head_ = this->columnCount_ - 1;
+    this->headDataCount_ = this->dataColumnsPerColumn_;
+    this->filledCount_ = 0;
+
+    this->pixels_ = Pixels::CreateShared(this->imageSize_);
+    this->pixels_->data.setZero();
+    this->spares_.clear();
+}
+
+
+void StreamingWaveform::Append(const DataMatrix &data)
+{
+    DRAW_TRACE_SCOPE("waveform.append");
+
+    std::vector<Eigen::Index> touched;
+    auto maximumLevel = this->levelCount_ - 1;
+
+    for (Eigen::Index dataColumn = 0; dataColumn < data.cols(); ++dataColumn)
+    {
+        if (this->headDataCount_ == this->dataColumnsPerColumn_)
+        {
+            this->head_ = (this->head_ + 1) % this->columnCount_;
+            this->headDataCount_ = 0;
+
+            if (this->filledCount_ == this->columnCount_)
+            {
+                // Retire the oldest column.
+                this->counts_.col(this->head_).setZero();
+                this->columnMaximums_[static_cast<size_t>(this->head_)] = 0;
+            }
+            else
+            {
+                ++this->filledCount_;
+            }
+
+            touched.push_back(this->head_);
+        }
+        else if (touched.empty())
+        {
+            // Continue filling the column from the last call.
+            touched.push_back(this->head_);
+        }
+
+        auto counts = this->counts_.col(this->head_);
+        auto &columnMaximum =
+            this->columnMaximums_[static_cast<size_t>(this->head_)];
+
+        for (Eigen::Index row = 0; row < data.rows(); ++row)
+        {
+            auto level = std::clamp(
+                FloatToIndex(
+                    static_cast<float>(data(row, dataColumn))
+                    * this->levelScale_),
+                Eigen::Index{0},
+                maximumLevel);
+
+            auto &count = counts(maximumLevel - level);
+            ++count;
+            columnMaximum = std::max(columnMaximum, count);
+        }
+
+        ++this->headDataCount_;
+    }
+
+    if (touched.empty())
+    {
+        return;
+    }
+
+    bool isScaleChanged = this->AdaptColors_();
+
+    bool isDrawingAll = isScaleChanged
+        || static_cast<Eigen::Index>(touched.size()) >= this->columnCount_;
+
+    this->MakeWritable_(isDrawingAll);
+
+    if (isDrawingAll)
+    {
+        this->DrawAll_();
+
+        return;
+    }
+
+    DRAW_TRACE_SCOPE("waveform.drawColumns");
+
+    for (auto column: touched)
+    {
+        this->Draw_(column);
+    }
+}
+
+
+Eigen::Index StreamingWaveform::GetColumnCount() const
+{
+    return this->filledCount_;
+}
+
+
+const Pixels & StreamingWaveform::GetPixels() const
+{
+    return *this->pixels_;
+}
+
+
+SizeType StreamingWaveform::GetOffset() const
+{
+    if (this->filledCount_ < this->columnCount_)
+    {
+        return 0;
+    }
+
+    return this->GetBeginColumn_((this->head_ + 1) % this->columnCount_);
+}
+
+
+std::vector<View<SizeType>> StreamingWaveform::GetViews() const
+{
+    using Point = tau::Point2d<SizeType>;
+    using Region = tau::Region<SizeType>;
+
+    auto offset = this->GetOffset();
+    auto height = this->imageSize_.height;
+    auto right = this->imageSize_.width - offset;
+
+    View<SizeType> oldest;
+    oldest.source = Region{{Point(offset, 0), Size(right, height)}};
+    oldest.target = Region{{Point(0, 0), Size(right, height)}};
+    oldest.scale = tau::Scale<double>(1.0, 1.0);
+
+    if (offset == 0)
+    {
+        return {oldest};
+    }
+
+    View<SizeType> newest;
+    newest.source = Region{{Point(0, 0), Size(offset, height)}};
+    newest.target = Region{{Point(right, 0), Size(offset, height)}};
+    newest.scale = tau::Scale<double>(1.0, 1.0);
+
+    return {oldest, newest};
+}
+
+
+std::shared_ptr<PixelRing> StreamingWaveform::GetRing() const
+{
+    return std::make_shared<PixelRing>(
+        PixelRing{this->pixels_, this->GetOffset()});
+}
+
+
+std::shared_ptr<Pixels> StreamingWaveform::Unroll() const
+{
+    auto result = Pixels::CreateShared(this->imageSize_);
+
+    auto width = static_cast<size_t>(this->imageSize_.width);
+    auto offset = static_cast<size_t>(this->GetOffset());
+    auto rowBytes = 3 * width;
+    auto leftBytes = 3 * offset;
+
+    const uint8_t *source = this->pixels_->data.data();
+    uint8_t *target = result->data.data();
+
+    for (SizeType row = 0; row < this->imageSize_.height; ++row)
+    {
+        std::memcpy(target, source + leftBytes, rowBytes - leftBytes);
+        std::memcpy(target + rowBytes - leftBytes, source, leftBytes);
+
+        source += rowBytes;
+        target += rowBytes;
+    }
+
+    return result;
+}
+
+
+void StreamingWaveform::SetColorMaximum(uint32_t colorMaximum)
+{
+    this->fixedColorMaximum_ = colorMaximum;
+    this->colorMaximum_ = colorMaximum;
+    this->AdaptColors_();
+    this->MakeWritable_(true);
+    this->DrawAll_();
+}
+
+
+uint32_t StreamingWaveform::GetColorMaximum() const
+{
+    return this->colorMaximum_;
+}
+
+
+SizeType StreamingWaveform::GetBeginColumn_(Eigen::Index column) const
+{
+    auto widthFactor = static_cast<double>(this->imageSize_.width)
+        / static_cast<double>(this->columnCount_);
+
+    return std::min(
+        this->imageSize_.width,
+        static_cast<SizeType>(
+            FloatToIndex(static_cast<double>(column) * widthFactor)));
+}
+
+
+void StreamingWaveform::Draw_(Eigen::Index column)
+{
+    auto beginColumn = this->GetBeginColumn_(column);
+    auto endColumn = this->GetBeginColumn_(column + 1);
+
+    if (beginColumn >= endColumn)
+    {
+        return;
+    }
+
+    auto width = static_cast<ptrdiff_t>(this->imageSize_.width);
+    auto counts = this->counts_.col(column);
+    auto colorCount = this->colors_.rows();
+
+    auto colorScale = this->colorMaximum_ == 0
+        ? 0.0
+        : static_cast<double>(colorCount - 1)
+            / static_cast<double>(this->colorMaximum_);
+
+    for (auto &spare: this->spares_)
+    {
+        spare.isStale[static_cast<size_t>(column)] = 1;
+    }
+
+    uint8_t *data = this->pixels_->data.data();
+
+    for (Eigen::Index level = 0; level < this->levelCount_; ++level)
+    {
+        auto colorIndex = std::min(
+            FloatToIndex(static_cast<double>(counts(level)) * colorScale),
+            colorCount - 1);
+
+        const uint8_t *color = &this->colors_(colorIndex, 0);
+        auto endRow = this->endRows_[static_cast<size_t>(level)];
+
+        for (
+            auto row = this->beginRows_[static_cast<size_t>(level)];
+            row < endRow;
+            ++row)
+        {
+            uint8_t *pixel = data + 3 * (row * width + beginColumn);
+
+            for (auto x = beginColumn; x < endColumn; ++x)
+            {
+                pixel[0] = color[0];
+                pixel[1] = color[1];
+                pixel[2] = color[2];
+                pixel += 3;
+            }
+        }
+    }
+}
+
+
+bool StreamingWaveform::AdaptColors_()
+{
+    if (this->fixedColorMaximum_ != adaptiveColors)
+    {
+        return false;
+    }
+
+    auto windowMaximum = *std::max_element(
+        this->columnMaximums_.begin(),
+        this->columnMaximums_.end());
+
+    // The color maximum is a power of two, so slowly growing counts redraw
+    // the window a few times, and only a large drop shrinks it.
+    bool isTooSmall = windowMaximum > this->colorMaximum_;
+    bool isTooLarge = uint64_t{4} * windowMaximum <= this->colorMaximum_;
+
+    if (!isTooSmall && !isTooLarge)
+    {
+        return false;
+    }
+
+    auto colorMaximum = std::bit_ceil(windowMaximum);
+
+    if (colorMaximum == this->colorMaximum_)
+    {
+        return false;
+    }
+
+    this->colorMaximum_ = colorMaximum;
+
+    return true;
+}
+
+
+void StreamingWaveform::DrawAll_()
+{
+    DRAW_TRACE_SCOPE("waveform.drawAll");
+
+    // Columns cover separate pixels, so they can be drawn at once.
+    detail::ParallelBands(
+        this->columnCount_,
+        minimumDrawBand,
+        [this](Eigen::Index begin, Eigen::Index end)
+        {
+            for (auto column = begin; column < end; ++column)
+            {
+                this->Draw_(column);
+            }
+        });
+}
+
+
+void StreamingWaveform::MakeWritable_(bool isDrawingAll)
+{
+    if (this->pixels_.use_count() == 1)
+    {
+        return;
+    }
+
+    auto spare = std::find_if(
+        this->spares_.begin(),
+        this->spares_.end(),
+        [](const SpareRing &ring)
+        {
+            return ring.pixels.use_count() == 1;
+        });
+
+    if (spare == this->spares_.end())
+    {
+        // Every ring is still held. Continue in a copy, and keep the held
+        // pixels as a spare for when they are released.
+        auto copy = std::make_shared<Pixels>(*this->pixels_);
+
+        if (this->spares_.size() < maximumSpareCount)
+        {
+            this->spares_.push_back(
+                SpareRing{
+                    std::move(this->pixels_),
+                    std::vector<uint8_t>(
+                        static_cast<size_t>(this->columnCount_),
+                        0)});
+        }
+
+        this->pixels_ = std::move(copy);
+
+        return;
+    }
+
+    DRAW_TRACE_SCOPE("waveform.swapRing");
+
+    std::swap(this->pixels_, spare->pixels);
+
+    std::vector<uint8_t> isStale(static_cast<size_t>(this->columnCount_), 0);
+    std::swap(isStale, spare->isStale);
+
+    if (!isDrawingAll)
+    {
+        for (Eigen::Index column = 0; column < this->columnCount_; ++column)
+        {
+            if (isStale[static_cast<size_t>(column)])
+            {
+                this->Draw_(column);
+            }
+        }
+    }
+
+    // The pixels that were swapped out are current.
+    std::fill(spare->isStale.begin(), spare->isStale.end(), uint8_t{0});
+}
+
+
+} // end namespace draw
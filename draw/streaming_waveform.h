@@ -0,0 +1,153 @@
+#pragma once
+
+
+#include <memory>
+#include <vector>
+
+#include "draw/waveform_engine.h"
+#include "draw/view.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** A scrolling waveform of the most recent columns of data.
+ **
+ ** Each call to Append adds columns of data to the right of the window. The
+ ** histogram is kept in a ring of settings.columnCount columns, and every
+ ** dataColumnsPerColumn columns of data are counted into one histogram
+ ** column. When the window is full, the oldest histogram column is retired
+ ** and its counts subtracted before the column is reused.
+ **
+ ** Histogram columns are drawn into a ring of pixels in the same order, so
+ ** only the columns touched by new data are drawn again. The oldest column
+ ** starts at GetOffset(). To display the window without copying it, publish
+ ** GetRing() to the pixelRing of a PixelView, which draws the ring in two
+ ** parts at its wrap point. GetViews() describes the same parts for other
+ ** targets. Unroll copies the whole image in time order, and is meant for
+ ** export and tests. Columns are drawn with equal widths when the width of
+ ** the image is a multiple of columnCount.
+ **
+ ** Pixels are not drawn while a published ring holds them. Drawing moves to
+ ** a spare ring that has been released, after the columns it missed are
+ ** drawn again, or to a copy when every ring is still held.
+ **
+ ** Counts of GetColorMaximum() and above are drawn with the brightest color.
+ ** By default the color maximum adapts to the largest count in the window:
+ ** it grows to the next power of two when a count exceeds it, and shrinks
+ ** when the largest count falls to a quarter of it. Every column is drawn
+ ** again only when it changes, which happens a few times as data starts
+ ** arriving and rarely after. Otherwise each Append draws only the columns
+ ** it touched. SetColorMaximum fixes the color maximum instead.
+ ** Highlights are not supported.
+ **/
+class StreamingWaveform
+{
+public:
+    StreamingWaveform(
+        const WaveformSettings &waveformSettings,
+        const Size &imageSize,
+        Eigen::Index dataColumnsPerColumn = 1);
+
+    // Remove all data from the window.
+    void Reset();
+
+    /**
+     ** @param data One column for each new column of data, oldest first.
+     ** Values greater than maximumValue are counted as maximumValue.
+     **/
+    void Append(const DataMatrix &data);
+
+    // The number of histogram columns holding data.
+    Eigen::Index GetColumnCount() const;
+
+    const Pixels & GetPixels() const;
+
+    // The first column of pixels drawn from the oldest histogram column.
+    SizeType GetOffset() const;
+
+    /**
+     ** The regions of GetPixels() to draw, with their targets in time
+     ** order. There are two views once the ring has wrapped, and one before.
+     **/
+    std::vector<View<SizeType>> GetViews() const;
+
+    // Share the pixels and their offset without copying them.
+    std::shared_ptr<PixelRing> GetRing() const;
+
+    // A copy of the pixels with the oldest column on the left.
+    std::shared_ptr<Pixels> Unroll() const;
+
+    // Use adaptiveColors to follow the largest count in the window.
+    static constexpr uint32_t adaptiveColors = 0;
+
+    /**
+     ** Draw counts of colorMaximum and above with the brightest color, and
+     ** draw every column again.
+     **/
+    void SetColorMaximum(uint32_t colorMaximum);
+
+    uint32_t GetColorMaximum() const;
+
+private:
+    using Counts =
+        Eigen::Matrix<uint32_t, Eigen::Dynamic, Eigen::Dynamic>;
+
+    // The pixel columns of one histogram column.
+    SizeType GetBeginColumn_(Eigen::Index column) const;
+
+    void Draw_(Eigen::Index column);
+
+    // @return true when the color maximum has changed.
+    bool AdaptColors_();
+
+    void DrawAll_();
+
+    // Move drawing away from pixels held by a published ring.
+    // The columns a spare missed are not drawn when isDrawingAll is set.
+    void MakeWritable_(bool isDrawingAll);
+
+    struct SpareRing
+    {
+        std::shared_ptr<Pixels> pixels;
+
+        // One flag for each histogram column drawn since the spare was
+        // current. Bytes, so that columns can be drawn at once.
+        std::vector<uint8_t> isStale;
+    };
+
+    // A displayed ring and one waiting to be displayed are usually held.
+    static constexpr size_t maximumSpareCount = 2;
+
+private:
+    Size imageSize_;
+    Eigen::Index levelCount_;
+    Eigen::Index columnCount_;
+    Eigen::Index dataColumnsPerColumn_;
+    float levelScale_;
+    PixelMatrix colors_;
+
+    // The rows of pixels covered by each level, as in Resize.
+    std::vector<SizeType> beginRows_;
+    std::vector<SizeType> endRows_;
+
+    // One column of counts per histogram column, with the highest level in
+    // row zero.
+    Counts counts_;
+    std::vector<uint32_t> columnMaximums_;
+    uint32_t fixedColorMaximum_;
+    uint32_t colorMaximum_;
+
+    // The histogram column receiving new data.
+    Eigen::Index head_;
+    Eigen::Index headDataCount_;
+    Eigen::Index filledCount_;
+
+    std::shared_ptr<Pixels> pixels_;
+    std::vector<SpareRing> spares_;
+};
+
+
+} // end namespace draw
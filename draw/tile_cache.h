@@ -0,0 +1,137 @@
+#pragma once
+
+#include <list>
+#include <map>
+#include <utility>
+
+#include "draw/tile_source.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** A least-recently-used cache of tiles with a memory budget.
+ **
+ ** Not synchronized. It belongs to the GUI thread, which receives tiles from
+ ** the loader and paints them.
+ **/
+template<typename Value>
+class TileCache
+{
+public:
+    TileCache(size_t byteBudget)
+        :
+        byteBudget_(byteBudget),
+        byteCount_(0),
+        entries_(),
+        entriesByKey_()
+    {
+
+    }
+
+    TileCache(const TileCache &) = delete;
+    TileCache & operator=(const TileCache &) = delete;
+
+    /**
+     ** @return The cached value, or nullptr. A found tile becomes the most
+     ** recently used.
+     **/
+    Value * Find(const TileKey &key)
+    {
+        auto found = this->entriesByKey_.find(key);
+
+        if (found == this->entriesByKey_.end())
+        {
+            return nullptr;
+        }
+
+        // Move the entry to the front without invalidating iterators.
+        this->entries_.splice(
+            this->entries_.begin(),
+            this->entries_,
+            found->second);
+
+        return &found->second->value;
+    }
+
+    bool Contains(const TileKey &key) const
+    {
+        return this->entriesByKey_.count(key) > 0;
+    }
+
+    /**
+     ** Insert or replace a tile, then evict the least recently used tiles
+     ** until the cache fits its budget. The newest tile is always kept.
+     **/
+    void Insert(const TileKey &key, Value value, size_t byteCount)
+    {
+        this->Erase(key);
+
+        this->entries_.push_front(Entry{key, std::move(value), byteCount});
+        this->entriesByKey_[key] = this->entries_.begin();
+        this->byteCount_ += byteCount;
+
+        while (
+            this->byteCount_ > this->byteBudget_
+            && this->entries_.size() > 1)
+        {
+            this->Erase(this->entries_.back().key);
+        }
+    }
+
+    void Erase(const TileKey &key)
+    {
+        auto found = this->entriesByKey_.find(key);
+
+        if (found == this->entriesByKey_.end())
+        {
+            return;
+        }
+
+        this->byteCount_ -= found->second->byteCount;
+        this->entries_.erase(found->second);
+        this->entriesByKey_.erase(found);
+    }
+
+    void Clear()
+    {
+        this->entriesByKey_.clear();
+        this->entries_.clear();
+        this->byteCount_ = 0;
+    }
+
+    size_t GetByteCount() const
+    {
+        return this->byteCount_;
+    }
+
+    size_t GetByteBudget() const
+    {
+        return this->byteBudget_;
+    }
+
+    size_t GetCount() const
+    {
+        return this->entries_.size();
+    }
+
+private:
+    struct Entry
+    {
+        TileKey key;
+        Value value;
+        size_t byteCount;
+    };
+
+    using Entries = std::list<Entry>;
+
+    size_t byteBudget_;
+    size_t byteCount_;
+    Entries entries_;
+    std::map<TileKey, typename Entries::iterator> entriesByKey_;
+};
+
+
+} // end namespace draw
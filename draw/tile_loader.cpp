@@ -0,0 +1,259 @@
+#include "draw/tile_loader.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+
+namespace draw
+{
+
+
+TileLoader::TileLoader(
+    std::shared_ptr<TileSource> tileSource,
+    Notify notify,
+    size_t threadCount,
+    Clock::duration retryDelay)
+    :
+    mutex_(),
+    tileSource_(tileSource),
+    notify_(notify),
+    retryDelay_(retryDelay),
+    isRunning_(true),
+    queue_(),
+    prefetch_(),
+    loading_(),
+    loaded_(),
+    failed_(),
+    hasRequestCondition_(),
+    threads_()
+{
+    threadCount = std::max(threadCount, size_t{1});
+
+    for (size_t i = 0; i < threadCount; ++i)
+    {
+        this->threads_.emplace_back(std::bind(&TileLoader::Run_, this));
+    }
+}
+
+
+TileLoader::~TileLoader()
+{
+    this->Shutdown();
+}
+
+
+void TileLoader::Request(std::vector<TileRequest> requests)
+{
+    pex::WriteLock lock(this->mutex_);
+    this->ExpireFailures_(requests);
+    this->Enqueue_(this->queue_, std::move(requests));
+}
+
+
+void TileLoader::Prefetch(std::vector<TileRequest> requests)
+{
+    pex::WriteLock lock(this->mutex_);
+    this->Enqueue_(this->prefetch_, std::move(requests));
+}
+
+
+void TileLoader::CancelPrefetch()
+{
+    pex::WriteLock lock(this->mutex_);
+    this->prefetch_.clear();
+}
+
+
+void TileLoader::ClearFailures()
+{
+    pex::WriteLock lock(this->mutex_);
+    this->failed_.clear();
+}
+
+
+void TileLoader::ExpireFailures_(const std::vector<TileRequest> &requests)
+{
+    if (this->failed_.empty())
+    {
+        return;
+    }
+
+    std::set<size_t> levels;
+
+    for (auto &request: requests)
+    {
+        levels.insert(request.key.level);
+    }
+
+    auto now = Clock::now();
+    auto failed = this->failed_.begin();
+
+    while (failed != this->failed_.end())
+    {
+        if (failed->second <= now || !levels.count(failed->first.level))
+        {
+            failed = this->failed_.erase(failed);
+        }
+        else
+        {
+            ++failed;
+        }
+    }
+}
+
+
+void TileLoader::Enqueue_(
+    std::vector<TileRequest> &queue,
+    std::vector<TileRequest> requests)
+{
+    requests.erase(
+        std::remove_if(
+            requests.begin(),
+            requests.end(),
+            [this](const TileRequest &request)
+            {
+                return this->IsPending_(request.key);
+            }),
+        requests.end());
+
+    std::sort(
+        requests.begin(),
+        requests.end(),
+        [](const TileRequest &left, const TileRequest &right)
+        {
+            return left.priority > right.priority;
+        });
+
+    queue = std::move(requests);
+
+    if (!queue.empty())
+    {
+        this->hasRequestCondition_.notify_all();
+    }
+}
+
+
+std::vector<LoadedTile> TileLoader::TakeLoaded()
+{
+    pex::WriteLock lock(this->mutex_);
+
+    return std::exchange(this->loaded_, {});
+}
+
+
+void TileLoader::Shutdown()
+{
+    {
+        pex::WriteLock lock(this->mutex_);
+        this->isRunning_ = false;
+
+        // Wake up workers so they will exit.
+        this->hasRequestCondition_.notify_all();
+    }
+
+    for (auto &thread: this->threads_)
+    {
+        if (thread.joinable())
+        {
+            thread.join();
+        }
+    }
+}
+
+
+bool TileLoader::IsPending_(const TileKey &key) const
+{
+    if (this->loading_.count(key) || this->failed_.count(key))
+    {
+        return true;
+    }
+
+    return std::any_of(
+        this->loaded_.begin(),
+        this->loaded_.end(),
+        [&key](const LoadedTile &loaded)
+        {
+            return loaded.key == key;
+        });
+}
+
+
+void TileLoader::Run_()
+{
+    while (true)
+    {
+        TileKey key;
+
+        {
+            pex::WriteLock lock(this->mutex_);
+
+            this->hasRequestCondition_.wait(
+                lock,
+                [this]
+                {
+                    return !this->queue_.empty()
+                        || !this->prefetch_.empty()
+                        || !this->isRunning_;
+                });
+
+            if (!this->isRunning_)
+            {
+                return;
+            }
+
+            // Visible tiles are loaded before prefetched tiles.
+            auto &queue =
+                this->queue_.empty() ? this->prefetch_ : this->queue_;
+
+            key = queue.back().key;
+            queue.pop_back();
+
+            if (this->IsPending_(key))
+            {
+                // The tile was in both queues.
+                continue;
+            }
+
+            this->loading_.insert(key);
+        }
+
+        std::shared_ptr<Pixels> pixels;
+
+        try
+        {
+            pixels = this->tileSource_->LoadTile(key);
+        }
+        catch (const std::exception &error)
+        {
+            std::cerr << "Failed to load tile: " << error.what() << std::endl;
+        }
+
+        bool wasEmpty;
+
+        {
+            pex::WriteLock lock(this->mutex_);
+            this->loading_.erase(key);
+
+            if (!pixels)
+            {
+                // Do not try again until the retry delay has passed.
+                this->failed_[key] = Clock::now() + this->retryDelay_;
+
+                continue;
+            }
+
+            wasEmpty = this->loaded_.empty();
+            this->loaded_.push_back(LoadedTile{key, pixels});
+        }
+
+        if (wasEmpty)
+        {
+            // The previous notification has been handled.
+            this->notify_();
+        }
+    }
+}
+
+
+} // end namespace draw
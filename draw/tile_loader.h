@@ -0,0 +1,120 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include <pex/locks.h>
+
+#include "draw/tile_source.h"
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+struct TileRequest
+{
+    TileKey key;
+
+    // Lower values are loaded first.
+    double priority;
+};
+
+
+struct LoadedTile
+{
+    TileKey key;
+    std::shared_ptr<Pixels> pixels;
+};
+
+
+/**
+ ** Loads tiles from a TileSource on a pool of worker threads.
+ **
+ ** Each call to Request replaces the queued requests, so tiles that have
+ ** scrolled out of view are never loaded. Prefetch requests are loaded only
+ ** when no visible tiles are waiting. Finished tiles are collected with
+ ** TakeLoaded. notify is called from a worker thread when finished tiles
+ ** become available, and must only schedule the call to TakeLoaded.
+ **
+ ** A tile that fails to load is not requested again until retryDelay has
+ ** passed, or until a call to Request moves to other pyramid levels.
+ **/
+class TileLoader
+{
+public:
+    using Notify = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr auto defaultRetryDelay = std::chrono::seconds(2);
+
+    TileLoader(
+        std::shared_ptr<TileSource> tileSource,
+        Notify notify,
+        size_t threadCount = detail::GetThreadCount(),
+        Clock::duration retryDelay = defaultRetryDelay);
+
+    ~TileLoader();
+
+    TileLoader(const TileLoader &) = delete;
+    TileLoader & operator=(const TileLoader &) = delete;
+
+    void Request(std::vector<TileRequest> requests);
+
+    // Replace the queued prefetch requests.
+    void Prefetch(std::vector<TileRequest> requests);
+
+    // Drop the queued prefetch requests, e.g. when the scroll reverses.
+    void CancelPrefetch();
+
+    std::vector<LoadedTile> TakeLoaded();
+
+    // Allow every failed tile to be requested again, e.g. when the files
+    // behind the source have changed.
+    void ClearFailures();
+
+    void Shutdown();
+
+private:
+    bool IsPending_(const TileKey &key) const;
+
+    // Forget failures that have waited retryDelay, and failures on levels
+    // that are not requested.
+    void ExpireFailures_(const std::vector<TileRequest> &requests);
+
+    void Enqueue_(
+        std::vector<TileRequest> &queue,
+        std::vector<TileRequest> requests);
+
+    void Run_();
+
+private:
+    mutable pex::Mutex mutex_;
+    std::shared_ptr<TileSource> tileSource_;
+    Notify notify_;
+    Clock::duration retryDelay_;
+    bool isRunning_;
+
+    // Sorted so that the most urgent request is last.
+    std::vector<TileRequest> queue_;
+    std::vector<TileRequest> prefetch_;
+
+    std::set<TileKey> loading_;
+    std::vector<LoadedTile> loaded_;
+
+    // When each failed tile may be loaded again.
+    std::map<TileKey, Clock::time_point> failed_;
+
+    std::condition_variable_any hasRequestCondition_;
+    std::vector<std::thread> threads_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,207 @@
+#include "draw/tile_source.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace draw
+{
+
+
+Size GetLevelSize(const Size &size, size_t level)
+{
+    auto result = size;
+
+    for (size_t i = 0; i < level; ++i)
+    {
+        result.width = (result.width + 1) / 2;
+        result.height = (result.height + 1) / 2;
+    }
+
+    return result;
+}
+
+
+Size TileSource::GetLevelSize(size_t level) const
+{
+    return draw::GetLevelSize(this->GetSize(), level);
+}
+
+
+Size TileSource::GetTileCount(size_t level) const
+{
+    auto levelSize = this->GetLevelSize(level);
+    auto tileSize = this->GetTileSize();
+
+    return Size(
+        (levelSize.width + tileSize - 1) / tileSize,
+        (levelSize.height + tileSize - 1) / tileSize);
+}
+
+
+tau::Region<SizeType> TileSource::GetTileRegion(const TileKey &key) const
+{
+    auto levelSize = this->GetLevelSize(key.level);
+    auto tileSize = this->GetTileSize();
+
+    auto left = key.column * tileSize;
+    auto top = key.row * tileSize;
+
+    return tau::Region<SizeType>{{
+        tau::Point2d<SizeType>(left, top),
+        tau::Size<SizeType>(
+            std::min(tileSize, levelSize.width - left),
+            std::min(tileSize, levelSize.height - top))}};
+}
+
+
+PixelsTileSource::PixelsTileSource(
+    std::shared_ptr<const PixelPyramid> pyramid,
+    SizeType tileSize)
+    :
+    pyramid_(pyramid),
+    tileSize_(tileSize)
+{
+    if (!this->pyramid_ || this->pyramid_->levels.empty())
+    {
+        throw std::invalid_argument("pyramid must not be empty");
+    }
+
+    if (this->tileSize_ <= 0)
+    {
+        throw std::invalid_argument("tileSize must be positive");
+    }
+}
+
+
+Size PixelsTileSource::GetSize() const
+{
+    auto &source = *this->pyramid_->GetSource();
+
+    return Size(
+        static_cast<SizeType>(source.size.width),
+        static_cast<SizeType>(source.size.height));
+}
+
+
+size_t PixelsTileSource::GetLevelCount() const
+{
+    return this->pyramid_->GetLevelCount();
+}
+
+
+SizeType PixelsTileSource::GetTileSize() const
+{
+    return this->tileSize_;
+}
+
+
+std::shared_ptr<Pixels> PixelsTileSource::LoadTile(const TileKey &key)
+{
+    auto &level = *this->pyramid_->levels.at(key.level);
+    auto region = this->GetTileRegion(key);
+
+    if (!region.size.HasArea())
+    {
+        throw std::out_of_range("Tile is outside of the image");
+    }
+
+    auto result = Pixels::CreateShared(region.size);
+
+    auto rowBytes = static_cast<size_t>(region.size.width) * 3;
+    auto levelStride = static_cast<size_t>(level.size.width) * 3;
+
+    const uint8_t *input = level.data.data()
+        + static_cast<size_t>(region.topLeft.y) * levelStride
+        + static_cast<size_t>(region.topLeft.x) * 3;
+
+    uint8_t *output = result->data.data();
+
+    for (SizeType row = 0; row < region.size.height; ++row)
+    {
+        std::memcpy(output, input, rowBytes);
+        input += levelStride;
+        output += rowBytes;
+    }
+
+    return result;
+}
+
+
+CallbackTileSource::CallbackTileSource(
+    const Size &size,
+    size_t levelCount,
+    SizeType tileSize,
+    ReadTile readTile)
+    :
+    size_(size),
+    levelCount_(levelCount),
+    tileSize_(tileSize),
+    readTile_(readTile)
+{
+    if (!this->size_.HasArea() || this->levelCount_ == 0)
+    {
+        throw std::invalid_argument("source must not be empty");
+    }
+
+    if (this->tileSize_ <= 0)
+    {
+        throw std::invalid_argument("tileSize must be positive");
+    }
+
+    if (!this->readTile_)
+    {
+        throw std::invalid_argument("readTile must not be empty");
+    }
+}
+
+
+Size CallbackTileSource::GetSize() const
+{
+    return this->size_;
+}
+
+
+size_t CallbackTileSource::GetLevelCount() const
+{
+    return this->levelCount_;
+}
+
+
+SizeType CallbackTileSource::GetTileSize() const
+{
+    return this->tileSize_;
+}
+
+
+std::shared_ptr<Pixels> CallbackTileSource::LoadTile(const TileKey &key)
+{
+    if (key.level >= this->levelCount_)
+    {
+        throw std::out_of_range("Tile level is outside of the source");
+    }
+
+    auto region = this->GetTileRegion(key);
+
+    if (!region.size.HasArea())
+    {
+        throw std::out_of_range("Tile is outside of the image");
+    }
+
+    auto result = this->readTile_(key, region);
+
+    if (
+        result
+        && (static_cast<SizeType>(result->size.width) != region.size.width
+            || static_cast<SizeType>(result->size.height)
+                != region.size.height))
+    {
+        throw std::runtime_error("Tile does not match its region");
+    }
+
+    return result;
+}
+
+
+} // end namespace draw
@@ -0,0 +1,146 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <tuple>
+#include <tau/region.h>
+
+#include "draw/size.h"
+#include "draw/pixels.h"
+#include "draw/pixel_pyramid.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** Identifies one tile of one pyramid level.
+ **
+ ** column and row count tiles, not pixels.
+ **/
+struct TileKey
+{
+    size_t level;
+    SizeType column;
+    SizeType row;
+
+    bool operator<(const TileKey &other) const
+    {
+        return std::tie(this->level, this->row, this->column)
+            < std::tie(other.level, other.row, other.column);
+    }
+
+    bool operator==(const TileKey &other) const
+    {
+        return this->level == other.level
+            && this->column == other.column
+            && this->row == other.row;
+    }
+};
+
+
+// The size of a pyramid level, following the rounding of Downsample.
+Size GetLevelSize(const Size &size, size_t level);
+
+
+/**
+ ** Provides an image one tile at a time, so the whole image never needs to
+ ** be in memory.
+ **
+ ** Each level is half the size of the level before it. Tiles are square,
+ ** except at the right and bottom edges of a level.
+ **/
+class TileSource
+{
+public:
+    virtual ~TileSource() = default;
+
+    // The size of level 0, in pixels.
+    virtual Size GetSize() const = 0;
+
+    virtual size_t GetLevelCount() const = 0;
+
+    virtual SizeType GetTileSize() const = 0;
+
+    /**
+     ** Called from the loader threads, possibly for several tiles at once.
+     ** May throw if the tile cannot be read.
+     **/
+    virtual std::shared_ptr<Pixels> LoadTile(const TileKey &key) = 0;
+
+    Size GetLevelSize(size_t level) const;
+
+    // The number of tile columns and rows in a level.
+    Size GetTileCount(size_t level) const;
+
+    // The pixels covered by a tile, in the coordinates of its level.
+    tau::Region<SizeType> GetTileRegion(const TileKey &key) const;
+};
+
+
+/**
+ ** Serves tiles from a PixelPyramid in memory.
+ **/
+class PixelsTileSource: public TileSource
+{
+public:
+    static constexpr SizeType defaultTileSize = 256;
+
+    PixelsTileSource(
+        std::shared_ptr<const PixelPyramid> pyramid,
+        SizeType tileSize = defaultTileSize);
+
+    Size GetSize() const override;
+
+    size_t GetLevelCount() const override;
+
+    SizeType GetTileSize() const override;
+
+    std::shared_ptr<Pixels> LoadTile(const TileKey &key) override;
+
+private:
+    std::shared_ptr<const PixelPyramid> pyramid_;
+    SizeType tileSize_;
+};
+
+
+/**
+ ** Serves tiles read by a callback, e.g. from a tiled file on disk or a
+ ** pyramid stored by another library.
+ **
+ ** The callback receives the key and the region of the tile within its
+ ** level, and returns pixels of the region's size. It is called from the
+ ** loader threads, possibly for several tiles at once, and may throw.
+ **/
+class CallbackTileSource: public TileSource
+{
+public:
+    using ReadTile = std::function<
+        std::shared_ptr<Pixels>(
+            const TileKey &key,
+            const tau::Region<SizeType> &region)>;
+
+    CallbackTileSource(
+        const Size &size,
+        size_t levelCount,
+        SizeType tileSize,
+        ReadTile readTile);
+
+    Size GetSize() const override;
+
+    size_t GetLevelCount() const override;
+
+    SizeType GetTileSize() const override;
+
+    std::shared_ptr<Pixels> LoadTile(const TileKey &key) override;
+
+private:
+    Size size_;
+    size_t levelCount_;
+    SizeType tileSize_;
+    ReadTile readTile_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,281 @@
+#include "draw/trace.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "draw/detail/json_stream.h"
+
+
+namespace draw
+{
+
+
+Tracer & Tracer::Get()
+{
+    static Tracer tracer;
+
+    return tracer;
+}
+
+
+Tracer::Tracer()
+    :
+    epoch_(std::chrono::steady_clock::now()),
+    ringsMutex_(),
+    rings_(),
+    collectMutex_(),
+    history_(),
+    windows_()
+{
+
+}
+
+
+namespace
+{
+
+
+// Releases the ring of a thread when the thread exits.
+struct TraceRingOwner
+{
+    detail::TraceRing *ring = nullptr;
+
+    ~TraceRingOwner()
+    {
+        if (this->ring)
+        {
+            this->ring->Release();
+        }
+    }
+};
+
+
+} // end anonymous namespace
+
+
+detail::TraceRing & Tracer::GetRing_()
+{
+    // Each thread takes a ring once. Rings are kept after their threads
+    // exit, so their events can still be collected, and are then reused.
+    thread_local TraceRingOwner owner;
+
+    if (!owner.ring)
+    {
+        std::lock_guard lock(this->ringsMutex_);
+
+        for (auto &ring: this->rings_)
+        {
+            if (ring->Acquire())
+            {
+                owner.ring = ring.get();
+
+                return *owner.ring;
+            }
+        }
+
+        this->rings_.push_back(
+            std::make_unique<detail::TraceRing>(
+                static_cast<uint32_t>(this->rings_.size())));
+
+        owner.ring = this->rings_.back().get();
+    }
+
+    return *owner.ring;
+}
+
+
+void Tracer::Count(const char *name, double value)
+{
+    this->Record({name, this->Now(), 0, value, 0, true});
+}
+
+
+void Tracer::Collect()
+{
+    std::vector<detail::TraceRing *> rings;
+
+    {
+        std::lock_guard lock(this->ringsMutex_);
+
+        for (auto &ring: this->rings_)
+        {
+            rings.push_back(ring.get());
+        }
+    }
+
+    std::lock_guard lock(this->collectMutex_);
+
+    for (auto ring: rings)
+    {
+        auto threadIndex = ring->GetThreadIndex();
+
+        ring->Drain(
+            [this, threadIndex](TraceEvent event)
+            {
+                event.threadIndex = threadIndex;
+                this->Accumulate_(event);
+            });
+    }
+
+    while (this->history_.size() > maximumHistory)
+    {
+        this->history_.pop_front();
+    }
+}
+
+
+void Tracer::Accumulate_(const TraceEvent &event)
+{
+    this->history_.push_back(event);
+
+    auto &window = this->windows_[event.name];
+
+    double sample = (event.isCounter)
+        ? event.value
+        : static_cast<double>(event.duration) / 1.0e6;
+
+    if (window.samples.size() < windowSize)
+    {
+        window.samples.push_back(sample);
+    }
+    else
+    {
+        window.samples[window.next] = sample;
+        window.next = (window.next + 1) % windowSize;
+    }
+
+    ++window.count;
+    window.last = sample;
+    window.isCounter = event.isCounter;
+}
+
+
+static double GetPercentile(std::vector<double> &samples, double fraction)
+{
+    if (samples.empty())
+    {
+        return 0.0;
+    }
+
+    auto index = static_cast<size_t>(
+        std::round(fraction * static_cast<double>(samples.size() - 1)));
+
+    std::nth_element(
+        samples.begin(),
+        std::next(samples.begin(), static_cast<std::ptrdiff_t>(index)),
+        samples.end());
+
+    return samples[index];
+}
+
+
+std::vector<TraceStat> Tracer::GetStats() const
+{
+    std::lock_guard lock(this->collectMutex_);
+
+    std::vector<TraceStat> result;
+    result.reserve(this->windows_.size());
+
+    for (auto &[name, window]: this->windows_)
+    {
+        auto samples = window.samples;
+
+        result.push_back(
+            {
+                name,
+                window.count,
+                GetPercentile(samples, 0.5),
+                GetPercentile(samples, 0.99),
+                window.last,
+                window.isCounter});
+    }
+
+    return result;
+}
+
+
+uint64_t Tracer::GetDropped() const
+{
+    std::lock_guard lock(this->ringsMutex_);
+
+    uint64_t result = 0;
+
+    for (auto &ring: this->rings_)
+    {
+        result += ring->GetDropped();
+    }
+
+    return result;
+}
+
+
+size_t Tracer::GetRingCount() const
+{
+    std::lock_guard lock(this->ringsMutex_);
+
+    return this->rings_.size();
+}
+
+
+void Tracer::WriteChromeTrace(std::ostream &output) const
+{
+    std::lock_guard lock(this->collectMutex_);
+
+    detail::JsonWriter writer(output);
+
+    writer.BeginObject();
+    writer.Key("displayTimeUnit");
+    writer.String("ms");
+    writer.Key("traceEvents");
+    writer.BeginArray();
+
+    for (auto &event: this->history_)
+    {
+        writer.BeginObject();
+        writer.Key("name");
+        writer.String(event.name);
+        writer.Key("pid");
+        writer.Number(1);
+        writer.Key("tid");
+        writer.Number(event.threadIndex);
+
+        // Chrome expects microseconds.
+        writer.Key("ts");
+        writer.Number(static_cast<double>(event.start) / 1000.0);
+
+        if (event.isCounter)
+        {
+            writer.Key("ph");
+            writer.String("C");
+            writer.Key("args");
+            writer.BeginObject();
+            writer.Key("value");
+            writer.Number(event.value);
+            writer.EndObject();
+        }
+        else
+        {
+            writer.Key("ph");
+            writer.String("X");
+            writer.Key("dur");
+            writer.Number(static_cast<double>(event.duration) / 1000.0);
+        }
+
+        writer.EndObject();
+    }
+
+    writer.EndArray();
+    writer.EndObject();
+}
+
+
+void Tracer::Clear()
+{
+    std::lock_guard lock(this->collectMutex_);
+
+    this->history_.clear();
+    this->windows_.clear();
+}
+
+
+} // end namespace draw
@@ -0,0 +1,323 @@
+#pragma once
+
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <fields/fields.h>
+
+
+/**
+ ** Scoped timings and counters for the drawing pipeline.
+ **
+ ** Build with DRAW_ENABLE_TRACE defined to record them. Otherwise the macros
+ ** expand to nothing, and instrumented code is unchanged.
+ **
+ **     void Stage()
+ **     {
+ **         DRAW_TRACE_SCOPE("waveform.resize");
+ **         ...
+ **         DRAW_TRACE_COUNTER("waveform.columns", columnCount);
+ **     }
+ **
+ ** Names must be string literals, or otherwise live for the whole program.
+ **/
+
+
+namespace draw
+{
+
+
+struct TraceEvent
+{
+    const char *name;
+
+    // Nanoseconds since the tracer was created.
+    int64_t start;
+
+    // Nanoseconds. Zero for counters.
+    int64_t duration;
+
+    // The value of a counter.
+    double value;
+
+    uint32_t threadIndex;
+    bool isCounter;
+};
+
+
+namespace detail
+{
+
+
+/**
+ ** A ring of events written by one thread and read by the collector.
+ **
+ ** Neither side takes a lock. When the collector falls behind, new events
+ ** are dropped and counted.
+ **
+ ** When its thread exits, the ring is released. Once its events have been
+ ** collected, it is reused by the next thread that needs one.
+ **/
+class TraceRing
+{
+public:
+    static constexpr size_t capacity = 4096;
+
+    static_assert((capacity & (capacity - 1)) == 0);
+
+    TraceRing(uint32_t threadIndex)
+        :
+        events_(),
+        head_(0),
+        tail_(0),
+        dropped_(0),
+        threadIndex_(threadIndex),
+        isOwned_(true)
+    {
+
+    }
+
+    // Called only by the thread that owns the ring.
+    void Push(const TraceEvent &event)
+    {
+        auto head = this->head_.load(std::memory_order_relaxed);
+
+        if (head - this->tail_.load(std::memory_order_acquire) >= capacity)
+        {
+            this->dropped_.fetch_add(1, std::memory_order_relaxed);
+
+            return;
+        }
+
+        this->events_[head & (capacity - 1)] = event;
+        this->head_.store(head + 1, std::memory_order_release);
+    }
+
+    // Called only by the collector.
+    template<typename Function>
+    void Drain(Function &&function)
+    {
+        auto tail = this->tail_.load(std::memory_order_relaxed);
+        auto head = this->head_.load(std::memory_order_acquire);
+
+        while (tail != head)
+        {
+            function(this->events_[tail & (capacity - 1)]);
+            ++tail;
+        }
+
+        this->tail_.store(tail, std::memory_order_release);
+    }
+
+    uint32_t GetThreadIndex() const
+    {
+        return this->threadIndex_;
+    }
+
+    uint64_t GetDropped() const
+    {
+        return this->dropped_.load(std::memory_order_relaxed);
+    }
+
+    // Called by the owning thread after its last event.
+    void Release()
+    {
+        this->isOwned_.store(false, std::memory_order_release);
+    }
+
+    // Called with the tracer's list of rings locked.
+    bool Acquire()
+    {
+        if (this->isOwned_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        if (
+            this->head_.load(std::memory_order_relaxed)
+            != this->tail_.load(std::memory_order_acquire))
+        {
+            // Wait for the collector to drain the last thread's events.
+            return false;
+        }
+
+        this->isOwned_.store(true, std::memory_order_relaxed);
+
+        return true;
+    }
+
+private:
+    std::array<TraceEvent, capacity> events_;
+
+    // Keep the producer's and consumer's indices on separate cache lines.
+    alignas(64) std::atomic<uint64_t> head_;
+    alignas(64) std::atomic<uint64_t> tail_;
+    std::atomic<uint64_t> dropped_;
+    uint32_t threadIndex_;
+    std::atomic<bool> isOwned_;
+};
+
+
+} // end namespace detail
+
+
+struct TraceStat
+{
+    std::string name;
+    uint64_t count;
+
+    // Milliseconds for scopes, values for counters.
+    double p50;
+    double p99;
+    double last;
+
+    bool isCounter;
+
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&TraceStat::name, "name"),
+        fields::Field(&TraceStat::count, "count"),
+        fields::Field(&TraceStat::p50, "p50"),
+        fields::Field(&TraceStat::p99, "p99"),
+        fields::Field(&TraceStat::last, "last"),
+        fields::Field(&TraceStat::isCounter, "isCounter"));
+
+    static constexpr auto fieldsTypeName = "TraceStat";
+
+    bool operator==(const TraceStat &) const = default;
+};
+
+
+class Tracer
+{
+public:
+    // Samples of each name used for the rolling percentiles.
+    static constexpr size_t windowSize = 512;
+
+    // Events kept for WriteChromeTrace.
+    static constexpr size_t maximumHistory = 1 << 18;
+
+    static Tracer & Get();
+
+    // Nanoseconds since the tracer was created.
+    int64_t Now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - this->epoch_).count();
+    }
+
+    void Record(const TraceEvent &event)
+    {
+        this->GetRing_().Push(event);
+    }
+
+    void Count(const char *name, double value);
+
+    // Move events from every thread's ring into the history and statistics.
+    void Collect();
+
+    // Statistics as of the last Collect, sorted by name.
+    std::vector<TraceStat> GetStats() const;
+
+    // Events lost because a ring was full.
+    uint64_t GetDropped() const;
+
+    // Rings created so far. Rings of exited threads are reused.
+    size_t GetRingCount() const;
+
+    // Write the collected history in the Chrome trace event format, for
+    // chrome://tracing or Perfetto.
+    void WriteChromeTrace(std::ostream &output) const;
+
+    void Clear();
+
+private:
+    Tracer();
+
+    detail::TraceRing & GetRing_();
+
+    struct Window
+    {
+        std::vector<double> samples;
+        size_t next = 0;
+        uint64_t count = 0;
+        double last = 0.0;
+        bool isCounter = false;
+    };
+
+    void Accumulate_(const TraceEvent &event);
+
+private:
+    std::chrono::steady_clock::time_point epoch_;
+
+    // Protects the list of rings.
+    mutable std::mutex ringsMutex_;
+    std::vector<std::unique_ptr<detail::TraceRing>> rings_;
+
+    // Protects the collected events and statistics.
+    mutable std::mutex collectMutex_;
+    std::deque<TraceEvent> history_;
+    std::map<std::string, Window> windows_;
+};
+
+
+class TraceScope
+{
+public:
+    TraceScope(const char *name)
+        :
+        name_(name),
+        start_(Tracer::Get().Now())
+    {
+
+    }
+
+    ~TraceScope()
+    {
+        auto &tracer = Tracer::Get();
+
+        tracer.Record(
+            {this->name_, this->start_, tracer.Now() - this->start_, 0.0, 0,
+                false});
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope & operator=(const TraceScope &) = delete;
+
+private:
+    const char *name_;
+    int64_t start_;
+};
+
+
+} // end namespace draw
+
+
+#ifdef DRAW_ENABLE_TRACE
+
+#define DRAW_TRACE_CONCATENATE_(first, second) first##second
+
+#define DRAW_TRACE_VARIABLE_(line) \
+    DRAW_TRACE_CONCATENATE_(drawTraceScope_, line)
+
+#define DRAW_TRACE_SCOPE(name) \
+    ::draw::TraceScope DRAW_TRACE_VARIABLE_(__LINE__)(name)
+
+#define DRAW_TRACE_COUNTER(name, value) \
+    ::draw::Tracer::Get().Count(name, static_cast<double>(value))
+
+#else
+
+#define DRAW_TRACE_SCOPE(name)
+#define DRAW_TRACE_COUNTER(name, value)
+
+#endif
@@ -0,0 +1,18 @@
+#include "draw/trace_stats.h"
+
+
+namespace draw
+{
+
+
+void PublishTraceStats(TraceStatsControl control)
+{
+    auto &tracer = Tracer::Get();
+    tracer.Collect();
+
+    control.stats.Set(tracer.GetStats());
+    control.dropped.Set(tracer.GetDropped());
+}
+
+
+} // end namespace draw
@@ -0,0 +1,45 @@
+#pragma once
+
+
+#include <vector>
+#include <fields/fields.h>
+#include <pex/group.h>
+
+#include "draw/trace.h"
+
+
+namespace draw
+{
+
+
+template<typename T>
+struct TraceStatsFields
+{
+    static constexpr auto fields = std::make_tuple(
+        fields::Field(&T::stats, "stats"),
+        fields::Field(&T::dropped, "dropped"));
+};
+
+
+template<template<typename> typename T>
+struct TraceStatsTemplate
+{
+    T<std::vector<TraceStat>> stats;
+    T<uint64_t> dropped;
+
+    static constexpr auto fields = TraceStatsFields<TraceStatsTemplate>::fields;
+    static constexpr auto fieldsTypeName = "TraceStats";
+};
+
+
+using TraceStatsGroup = pex::Group<TraceStatsFields, TraceStatsTemplate>;
+using TraceStatsModel = typename TraceStatsGroup::Model;
+using TraceStatsControl = typename TraceStatsGroup::DefaultControl;
+
+
+// Collect the tracer's events and publish its statistics.
+// Call from the thread that owns the model.
+void PublishTraceStats(TraceStatsControl control);
+
+
+} // end namespace draw
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <cmath>
+#include <vector>
 #include <tau/vector2d.h>
 #include <tau/region.h>
 #include <tau/scale.h>
@@ -177,6 +179,151 @@ struct View
 };
 
 
+/*
+ * Create a view of the source pixels that cover a clipping region.
+ *
+ * The source is expanded to whole pixels, and the target is placed on the
+ * scaled pixel grid, so the views of adjacent clipping regions join without
+ * seams. Only the exposed part of a scrolled window needs to be painted.
+ *
+ * @param viewPosition The position of the window on the scaled source.
+ * @param clip The region to paint, relative to the window.
+ * @param sourceSize The unscaled size of the source image.
+ * @param scale The scale applied to the source image.
+ */
+template<typename T, typename ScaleType>
+View<T, ScaleType> MakeAlignedView(
+    const tau::Point2d<T> &viewPosition,
+    const tau::Region<T> &clip,
+    const tau::Size<T> &sourceSize,
+    const tau::Scale<ScaleType> &scale)
+{
+    static_assert(std::is_integral_v<T>, "Pixels have integral indices");
+
+    View<T, ScaleType> result{};
+    result.scale = scale;
+
+    auto left = static_cast<ScaleType>(viewPosition.x + clip.topLeft.x);
+    auto top = static_cast<ScaleType>(viewPosition.y + clip.topLeft.y);
+    auto right = left + static_cast<ScaleType>(clip.size.width);
+    auto bottom = top + static_cast<ScaleType>(clip.size.height);
+
+    auto firstColumn = std::clamp(
+        static_cast<T>(std::floor(left / scale.horizontal)),
+        T{0},
+        sourceSize.width);
+
+    auto firstRow = std::clamp(
+        static_cast<T>(std::floor(top / scale.vertical)),
+        T{0},
+        sourceSize.height);
+
+    auto endColumn = std::clamp(
+        static_cast<T>(std::ceil(right / scale.horizontal)),
+        T{0},
+        sourceSize.width);
+
+    auto endRow = std::clamp(
+        static_cast<T>(std::ceil(bottom / scale.vertical)),
+        T{0},
+        sourceSize.height);
+
+    if (endColumn <= firstColumn || endRow <= firstRow)
+    {
+        return result;
+    }
+
+    result.source = tau::Region<T>{{
+        tau::Point2d<T>(firstColumn, firstRow),
+        tau::Size<T>(endColumn - firstColumn, endRow - firstRow)}};
+
+    auto toTarget = [](T index, ScaleType factor, T offset) -> T
+    {
+        return static_cast<T>(
+            std::round(static_cast<ScaleType>(index) * factor)) - offset;
+    };
+
+    auto targetLeft = toTarget(firstColumn, scale.horizontal, viewPosition.x);
+    auto targetTop = toTarget(firstRow, scale.vertical, viewPosition.y);
+    auto targetRight = toTarget(endColumn, scale.horizontal, viewPosition.x);
+    auto targetBottom = toTarget(endRow, scale.vertical, viewPosition.y);
+
+    result.target = tau::Region<T>{{
+        tau::Point2d<T>(targetLeft, targetTop),
+        tau::Size<T>(targetRight - targetLeft, targetBottom - targetTop)}};
+
+    return result;
+}
+
+
+/*
+ * Split a view of an image that is stored as a ring of columns.
+ *
+ * Column `offset` of the ring is the first column of the image, and the
+ * columns before it follow the last one. The sources of the returned views
+ * are ring columns, and their targets join where the ring wraps.
+ *
+ * @param view A view of the unrolled image.
+ * @param width The width of the ring.
+ * @param offset The ring column that is displayed first.
+ */
+template<typename T, typename ScaleType>
+std::vector<View<T, ScaleType>> SplitRingView(
+    const View<T, ScaleType> &view,
+    T width,
+    T offset)
+{
+    static_assert(std::is_integral_v<T>, "Pixels have integral indices");
+
+    if (offset == 0 || !view.HasArea())
+    {
+        return {view};
+    }
+
+    auto left = view.source.topLeft.x;
+    auto right = left + view.source.size.width;
+    auto targetRight = view.target.topLeft.x + view.target.size.width;
+
+    // The first image column that is stored in ring column 0.
+    auto wrap = width - offset;
+
+    auto toTarget = [&view, left](T column) -> T
+    {
+        auto fraction =
+            static_cast<ScaleType>(column - left)
+            / static_cast<ScaleType>(view.source.size.width);
+
+        return view.target.topLeft.x + static_cast<T>(std::round(
+            fraction * static_cast<ScaleType>(view.target.size.width)));
+    };
+
+    std::vector<View<T, ScaleType>> result;
+
+    if (left < wrap)
+    {
+        auto end = std::min(right, wrap);
+        auto part = view;
+        part.source.topLeft.x = left + offset;
+        part.source.size.width = end - left;
+        part.target.size.width = toTarget(end) - view.target.topLeft.x;
+        result.push_back(part);
+    }
+
+    if (right > wrap)
+    {
+        auto begin = std::max(left, wrap);
+        auto part = view;
+        part.source.topLeft.x = begin - wrap;
+        part.source.size.width = right - begin;
+        part.target.topLeft.x = toTarget(begin);
+        part.target.size.width = targetRight - part.target.topLeft.x;
+        result.push_back(part);
+    }
+
+    return result;
+}
+
+
 template<typename T>
 std::ostream & operator<<(std::ostream &outputStream, const View<T> &view)
 {
@@ -30,7 +30,10 @@ Canvas::Canvas(
 
     cursorEndpoint_(this, control.cursor),
     imagePivot_(control.viewSettings.imagePivot),
-    control_(control)
+    control_(control),
+    virtualSize_(),
+    motionTimer_(this),
+    pendingMousePosition_()
 {
 
 #ifdef __WXMSW__
@@ -47,6 +50,12 @@ Canvas::Canvas(
         &Canvas::OnMouseMotion_,
         this);
 
+    this->Bind(
+        wxEVT_TIMER,
+        &Canvas::OnMotionTimer_,
+        this,
+        this->motionTimer_.GetId());
+
     this->Bind(
         wxEVT_LEFT_DOWN,
         &Canvas::OnLeftDown_,
@@ -225,14 +234,57 @@ void Canvas::OnMouseMotion_(wxMouseEvent &event)
 {
     event.Skip();
 
-    this->control_.mousePosition.Set(
-        wxpex::ToPoint<double>(event.GetPosition()));
+    // High rate mice deliver many more motion events than can be painted.
+    // Each published position fans out to the logical position, the shape
+    // editor's hit-test, and any active drag, so only the latest position is
+    // kept until the motion timer expires.
+    this->pendingMousePosition_ = wxpex::ToPoint<double>(event.GetPosition());
+
+    if (this->motionTimer_.IsRunning())
+    {
+        return;
+    }
+
+    this->FlushMousePosition_();
+    this->motionTimer_.StartOnce(motionIntervalMilliseconds);
+}
+
+
+void Canvas::OnMotionTimer_(wxTimerEvent &)
+{
+    if (!this->pendingMousePosition_)
+    {
+        // The mouse has stopped moving.
+        return;
+    }
+
+    this->FlushMousePosition_();
+
+    // Continue throttling while the mouse is in motion.
+    this->motionTimer_.StartOnce(motionIntervalMilliseconds);
+}
+
+
+void Canvas::FlushMousePosition_()
+{
+    if (!this->pendingMousePosition_)
+    {
+        return;
+    }
+
+    auto position = *this->pendingMousePosition_;
+    this->pendingMousePosition_.reset();
+    this->control_.mousePosition.Set(position);
 }
 
 
 void Canvas::OnLeftDown_(wxMouseEvent &event)
 {
     event.Skip();
+
+    // The click position supersedes any pending motion.
+    this->pendingMousePosition_.reset();
+
     auto defer = pex::MakeDefer(this->control_);
     defer.mousePosition.Set(wxpex::ToPoint<double>(event.GetPosition()));
     defer.mouseDown.Set(true);
@@ -242,6 +294,9 @@ void Canvas::OnLeftDown_(wxMouseEvent &event)
 void Canvas::OnLeftUp_(wxMouseEvent &event)
 {
     event.Skip();
+
+    // Finish any drag at the last reported position.
+    this->FlushMousePosition_();
     this->control_.mouseDown.Set(false);
 }
 
@@ -249,6 +304,8 @@ void Canvas::OnLeftUp_(wxMouseEvent &event)
 void Canvas::OnRightDown_(wxMouseEvent &event)
 {
     event.Skip();
+    this->pendingMousePosition_.reset();
+
     auto defer = pex::MakeDefer(this->control_);
     defer.mousePosition.Set(wxpex::ToPoint<double>(event.GetPosition()));
     defer.rightMouseDown.Set(true);
@@ -258,6 +315,9 @@ void Canvas::OnRightDown_(wxMouseEvent &event)
 void Canvas::OnRightUp_(wxMouseEvent &event)
 {
     event.Skip();
+
+    // Finish any drag at the last reported position.
+    this->FlushMousePosition_();
     this->control_.rightMouseDown.Set(false);
 }
 
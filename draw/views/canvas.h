@@ -1,6 +1,8 @@
 #pragma once
 
 
+#include <optional>
+
 #include <jive/scope_flag.h>
 #include <pex/value.h>
 #include <pex/endpoint.h>
@@ -11,6 +13,7 @@
 
 WXSHIM_PUSH_IGNORES
 #include <wx/scrolwin.h>
+#include <wx/timer.h>
 
 #ifdef __WXMSW__
 #include <wx/dcbuffer.h>
@@ -39,6 +42,9 @@ public:
     static constexpr auto observerName = "Canvas";
     static constexpr int pixelsPerScrollUnit = 10;
 
+    // Mouse motion is published at most once per interval (~120 Hz).
+    static constexpr int motionIntervalMilliseconds = 8;
+
     Canvas(
         wxWindow *parent,
         const CanvasControl &control);
@@ -56,6 +62,15 @@ protected:
 
     void OnMouseMotion_(wxMouseEvent &event);
 
+    void OnMotionTimer_(wxTimerEvent &event);
+
+    /**
+     ** Publish the most recent motion position, if there is one.
+     ** Intermediate positions received since the last publication are
+     ** discarded.
+     **/
+    void FlushMousePosition_();
+
     void OnLeftDown_(wxMouseEvent &event);
 
     void OnLeftUp_(wxMouseEvent &event);
@@ -115,6 +130,9 @@ protected:
     CanvasControl control_;
 
     Size virtualSize_;
+
+    wxTimer motionTimer_;
+    std::optional<Point> pendingMousePosition_;
 };
 
 
@@ -1,4 +1,5 @@
 #include "draw/views/pixel_canvas.h"
+#include "draw/bitmap.h"
 
 #include <wxpex/ignores.h>
 
@@ -31,20 +32,166 @@ PixelCanvas::PixelCanvas(
         this->imageSizeEndpoint_.Get().height,
         true),
 
+    bitmap_(),
+    bitmapSource_(),
+    isBitmapStale_(true),
+
     pixelsEndpoint_(this, control.pixels, &PixelCanvas::OnPixels_),
     pixelData_(),
+
+    pixelRingEndpoint_(
+        this,
+        control.pixelRing,
+        &PixelCanvas::OnPixelRing_),
+
+    isRing_(false),
+    ringOffset_(0),
+
+    packedPixelsEndpoint_(
+        this,
+        control.packedPixels,
+        &PixelCanvas::OnPackedPixels_),
+
+    packedData_(),
+
+    pyramidModel_(),
+
+    pyramidEndpoint_(
+        this,
+        PyramidControl(this->pyramidModel_),
+        &PixelCanvas::OnPyramid_),
+
+    pyramid_(),
+    levelBitmaps_(),
+    levelSource_(),
+    levelSourceIndex_(0),
+
     shapesEndpoint_(this, control.shapes, &PixelCanvas::OnShapes_),
-    shapesById_()
+    shapesById_(),
+    pyramidGenerator_(this->pyramidModel_.GetWorkerControl())
 {
     this->Bind(wxEVT_PAINT, &PixelCanvas::OnPaint_, this);
 }
 
 
+void PixelCanvas::UpdateBitmap_()
+{
+    this->isBitmapStale_ = false;
+
+    // Release the current bitmap before replacing it.
+    this->bitmapSource_.SelectObject(wxNullBitmap);
+
+    if (this->packedData_)
+    {
+        this->bitmap_ = GetBitmap(*this->packedData_);
+        this->bitmapSource_.SelectObjectAsSource(this->bitmap_);
+
+        return;
+    }
+
+    if (!this->image_.IsOk())
+    {
+        this->bitmap_ = wxBitmap();
+
+        return;
+    }
+
+    this->bitmap_ = wxBitmap(this->image_);
+    this->bitmapSource_.SelectObjectAsSource(this->bitmap_);
+}
+
+
+size_t PixelCanvas::SelectLevel_([[maybe_unused]] const Scale &scale) const
+{
+#ifdef CORRECT_PIXEL_CANVAS
+    // The center pixel correction is computed at full resolution.
+    return 0;
+#else
+    if (!this->pyramid_)
+    {
+        return 0;
+    }
+
+    return this->pyramid_->SelectLevel(scale);
+#endif
+}
+
+
+wxMemoryDC & PixelCanvas::GetLevelSource_(size_t level)
+{
+    if (level == 0)
+    {
+        if (this->isBitmapStale_)
+        {
+            this->UpdateBitmap_();
+        }
+
+        return this->bitmapSource_;
+    }
+
+    if (level != this->levelSourceIndex_)
+    {
+        this->levelSource_.SelectObject(wxNullBitmap);
+
+        auto &bitmap = this->levelBitmaps_.at(level);
+
+        if (!bitmap.IsOk())
+        {
+            bitmap = GetBitmap(*this->pyramid_->levels.at(level));
+        }
+
+        this->levelSource_.SelectObjectAsSource(bitmap);
+        this->levelSourceIndex_ = level;
+    }
+
+    return this->levelSource_;
+}
+
+
+void PixelCanvas::OnPyramid_(const std::shared_ptr<PixelPyramid> &pyramid)
+{
+    if (!pyramid || !this->pixelData_ || this->isRing_)
+    {
+        return;
+    }
+
+    if (pyramid->GetSource()->size != this->pixelData_->size)
+    {
+        // The image size changed while the pyramid was being built.
+        return;
+    }
+
+    // When frames arrive faster than pyramids can be built, the pyramid may
+    // be older than pixelData_. It is still the newest frame available at
+    // this scale.
+    this->ResetPyramid_();
+    this->pyramid_ = pyramid;
+    this->levelBitmaps_.resize(pyramid->GetLevelCount());
+
+    if (this->SelectLevel_(this->scaleEndpoint_.Get()) > 0)
+    {
+        this->Refresh(false);
+        this->Update();
+    }
+}
+
+
+void PixelCanvas::ResetPyramid_()
+{
+    this->levelSource_.SelectObject(wxNullBitmap);
+    this->levelSourceIndex_ = 0;
+    this->levelBitmaps_.clear();
+    this->pyramid_.reset();
+}
+
+
 void PixelCanvas::OnImageSize_(const Size &imageSize)
 {
     if (!this->image_.IsOk())
     {
         this->image_ = wxImage(imageSize.width, imageSize.height, true);
+        this->isBitmapStale_ = true;
+        this->ResetPyramid_();
 
         return;
     }
@@ -61,18 +208,82 @@ void PixelCanvas::OnImageSize_(const Size &imageSize)
     }
 
     this->image_ = wxImage(imageSize.width, imageSize.height, true);
+    this->isBitmapStale_ = true;
+    this->ResetPyramid_();
 }
 
 
 void PixelCanvas::OnPixels_(const std::shared_ptr<Pixels> &pixels)
 {
+    DRAW_TRACE_SCOPE("pixelCanvas.onPixels");
+
+    this->isRing_ = false;
+    this->ringOffset_ = 0;
+
     if (!pixels)
     {
         this->pixelData_ = pixels;
+        this->ResetPyramid_();
+
+        return;
+    }
+
+    if (!this->SetPixels_(pixels))
+    {
+        this->ResetPyramid_();
+    }
+
+    auto dataSize = pixels->size;
+
+    if (dataSize.width > PixelPyramid::minimumLevelSize
+            || dataSize.height > PixelPyramid::minimumLevelSize)
+    {
+        this->pyramidGenerator_(pixels);
+
+        if (this->SelectLevel_(this->scaleEndpoint_.Get()) > 0)
+        {
+            // This frame will be painted when its pyramid is published.
+            return;
+        }
+    }
+
+    this->Refresh(false);
+    this->Update();
+}
+
+
+void PixelCanvas::OnPixelRing_(const std::shared_ptr<PixelRing> &pixelRing)
+{
+    DRAW_TRACE_SCOPE("pixelCanvas.onPixelRing");
+
+    if (!pixelRing || !pixelRing->pixels)
+    {
+        this->OnPixels_({});
 
         return;
     }
 
+    auto ringWidth = static_cast<int>(pixelRing->pixels->size.width);
+
+    if (pixelRing->offset < 0 || pixelRing->offset >= ringWidth)
+    {
+        throw std::logic_error("ring offset must be within the pixels");
+    }
+
+    // The ring is displayed from the full resolution bitmap, and any
+    // pyramid built from earlier pixels is discarded.
+    this->isRing_ = true;
+    this->ringOffset_ = pixelRing->offset;
+    this->SetPixels_(pixelRing->pixels);
+    this->ResetPyramid_();
+
+    this->Refresh(false);
+    this->Update();
+}
+
+
+bool PixelCanvas::SetPixels_(const std::shared_ptr<Pixels> &pixels)
+{
     auto dataSize = pixels->size;
 
     if (dataSize.width == 0 || dataSize.height == 0)
@@ -81,6 +292,7 @@ void PixelCanvas::OnPixels_(const std::shared_ptr<Pixels> &pixels)
     }
 
     this->pixelData_ = pixels;
+    this->packedData_.reset();
 
     auto imageSize = wxpex::ToSize<Pixels::Index>(this->image_.GetSize());
 
@@ -91,11 +303,47 @@ void PixelCanvas::OnPixels_(const std::shared_ptr<Pixels> &pixels)
 
     this->image_.SetData(this->pixelData_->data.data(), true);
 
+    // Conversion is deferred until the full resolution image is painted.
+    this->isBitmapStale_ = true;
+
+    return imageSize == dataSize;
+}
+
+
+void PixelCanvas::OnPackedPixels_(
+    const std::shared_ptr<PackedPixels> &packedPixels)
+{
+    if (!packedPixels)
+    {
+        this->packedData_ = packedPixels;
+
+        return;
+    }
+
+    if (packedPixels->size.width == 0 || packedPixels->size.height == 0)
+    {
+        throw std::logic_error("pixels must not be empty");
+    }
+
+    // Packed pixels replace the RGB pixels, and the pyramid built from them.
+    this->packedData_ = packedPixels;
+    this->pixelData_.reset();
+    this->isRing_ = false;
+    this->ringOffset_ = 0;
+    this->ResetPyramid_();
+    this->isBitmapStale_ = true;
+
     this->Refresh(false);
     this->Update();
 }
 
 
+bool PixelCanvas::HasPixels_() const
+{
+    return this->pixelData_ || this->packedData_;
+}
+
+
 void PixelCanvas::OnShapes_(const Shapes &shapes)
 {
     if (shapes.IsResetter())
@@ -143,7 +391,13 @@ void PixelCanvas::OnPaint_(wxPaintEvent &)
     wxPaintDC dc(this);
 #endif
 
-    this->Draw_(dc);
+    auto updateBox = this->GetUpdateRegion().GetBox();
+
+    auto clip = tau::Region<int>{{
+        wxpex::ToPoint<int>(updateBox.GetPosition()),
+        wxpex::ToSize<int>(updateBox.GetSize())}};
+
+    this->Draw_(dc, clip);
 }
 
 
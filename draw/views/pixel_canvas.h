@@ -1,8 +1,12 @@
 #pragma once
 
 #include <cstdint>
+#include <vector>
 #include "draw/views/canvas.h"
 #include "draw/pixels.h"
+#include "draw/packed_pixels.h"
+#include "draw/pixel_pyramid.h"
+#include "draw/trace.h"
 #include "draw/views/pixel_view_settings.h"
 
 
@@ -24,15 +28,48 @@ private:
 
     void OnPixels_(const std::shared_ptr<Pixels> &pixels);
 
+    void OnPixelRing_(const std::shared_ptr<PixelRing> &pixelRing);
+
+    // Display pixels from either input.
+    // Returns false when the size of the image has changed.
+    bool SetPixels_(const std::shared_ptr<Pixels> &pixels);
+
+    void OnPackedPixels_(const std::shared_ptr<PackedPixels> &packedPixels);
+
+    bool HasPixels_() const;
+
+    void OnPyramid_(const std::shared_ptr<PixelPyramid> &pyramid);
+
+    void ResetPyramid_();
+
     void OnShapes_(const Shapes &shapes);
 
     bool HasShapes_() const;
 
     void OnPaint_(wxPaintEvent &);
 
+    // Convert image_ or packedData_ to the bitmap used as the blit source.
+    void UpdateBitmap_();
+
+    // Choose the pyramid level to display at scale.
+    size_t SelectLevel_(const Scale &scale) const;
+
+    // The blit source for a pyramid level, converted on first use.
+    wxMemoryDC & GetLevelSource_(size_t level);
+
+    /**
+     ** Paint the pixels and shapes that intersect the clip region.
+     **
+     ** @param clip The damaged region in window coordinates. After a scroll,
+     ** only the newly exposed strip is painted; the rest of the window has
+     ** been moved by ScrollWindow.
+     **/
     template<typename Context>
-    bool Draw_(Context &&context)
+    bool Draw_(
+        Context &&context,
+        [[maybe_unused]] const tau::Region<int> &clip)
     {
+        DRAW_TRACE_SCOPE("pixelCanvas.draw");
 
 #ifdef __WXMSW__
         context.SetBrush(wxBrush(*wxBLACK));
@@ -46,9 +83,32 @@ private:
             this->control_.viewSettings.viewSize.Get()}};
 
         auto imageSize = this->imageSizeEndpoint_.Get();
+        auto level = this->SelectLevel_(scale);
+        auto blitSize = imageSize;
+        auto blitScale = scale;
 
+        if (level > 0)
+        {
+            // Blit from a smaller copy of the image.
+            auto &levelPixels = *this->pyramid_->levels[level];
+
+            blitScale = this->pyramid_->GetLevelScale(level, scale);
+            blitSize.width = static_cast<SizeType>(levelPixels.size.width);
+            blitSize.height = static_cast<SizeType>(levelPixels.size.height);
+        }
+
+#ifdef CORRECT_PIXEL_CANVAS
+        // The center pixel correction shifts the whole view off of the
+        // scaled pixel grid, so the view cannot be split by the clip region.
         auto view =
-            draw::View<int>(viewRegion, imageSize, scale);
+            draw::View<int>(viewRegion, blitSize, blitScale);
+#else
+        auto view = MakeAlignedView(
+            viewRegion.topLeft,
+            clip,
+            blitSize,
+            blitScale);
+#endif
 
         bool hasShapes = this->HasShapes_();
 
@@ -63,7 +123,7 @@ private:
 
         if (view.HasArea())
         {
-            if (!this->pixelData_)
+            if (!this->HasPixels_())
             {
                 // Clear the view
                 // On MSW, it has already been cleared.
@@ -78,19 +138,28 @@ private:
 #ifdef CORRECT_PIXEL_CANVAS
                 correction = this->CorrectCenterPixel_(view);
 #endif
-                auto bitmap = wxBitmap(this->image_);
-                auto source = wxMemoryDC(bitmap);
-
-                context.StretchBlit(
-                    view.target.topLeft.x,
-                    view.target.topLeft.y,
-                    view.target.size.width,
-                    view.target.size.height,
-                    &source,
-                    view.source.topLeft.x,
-                    view.source.topLeft.y,
-                    view.source.size.width,
-                    view.source.size.height);
+                DRAW_TRACE_SCOPE("pixelCanvas.blit");
+
+                // A ring is blitted in two parts, either side of its wrap
+                // point. Rings are always displayed at level 0.
+                auto parts = SplitRingView(
+                    view,
+                    blitSize.width,
+                    this->ringOffset_);
+
+                for (auto &part: parts)
+                {
+                    context.StretchBlit(
+                        part.target.topLeft.x,
+                        part.target.topLeft.y,
+                        part.target.size.width,
+                        part.target.size.height,
+                        &this->GetLevelSource_(level),
+                        part.source.topLeft.x,
+                        part.source.topLeft.y,
+                        part.source.size.width,
+                        part.source.size.height);
+                }
             }
         }
 
@@ -113,6 +182,8 @@ private:
         gc->Translate(-viewPosition.x, -viewPosition.y);
         gc->Scale(scale.horizontal, scale.vertical);
 
+        DRAW_TRACE_SCOPE("pixelCanvas.shapes");
+
         for (auto &it: this->shapesById_)
         {
             for (auto &shape: it.second.GetShapes())
@@ -130,11 +201,39 @@ private:
 
     wxImage image_;
 
+    // Converted from image_ only when the pixels or the image size change.
+    wxBitmap bitmap_;
+    wxMemoryDC bitmapSource_;
+    bool isBitmapStale_;
+
     pex::Endpoint<PixelCanvas, PixelsControl> pixelsEndpoint_;
     std::shared_ptr<Pixels> pixelData_;
 
+    // The pixels of a ring are held in pixelData_. They are not reduced to a
+    // pyramid, because a new ring arrives with each change.
+    pex::Endpoint<PixelCanvas, PixelRingControl> pixelRingEndpoint_;
+    bool isRing_;
+    int ringOffset_;
+
+    // Copied directly to bitmap_, without passing through image_.
+    pex::Endpoint<PixelCanvas, PackedPixelsControl> packedPixelsEndpoint_;
+    std::shared_ptr<PackedPixels> packedData_;
+
+    AsyncPyramidModel pyramidModel_;
+    pex::Endpoint<PixelCanvas, PyramidControl> pyramidEndpoint_;
+    std::shared_ptr<PixelPyramid> pyramid_;
+
+    // Converted on first use. Level 0 is bitmap_.
+    std::vector<wxBitmap> levelBitmaps_;
+    wxMemoryDC levelSource_;
+    size_t levelSourceIndex_;
+
     AsyncShapesEndpoint<PixelCanvas> shapesEndpoint_;
     std::map<int64_t, Shapes> shapesById_;
+
+    // Declared last, so the worker stops before the members it publishes to
+    // are destroyed.
+    PyramidGenerator pyramidGenerator_;
 };
 
 
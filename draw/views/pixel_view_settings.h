@@ -6,6 +6,7 @@
 #include <wxpex/modifier.h>
 #include <wxpex/cursor.h>
 #include <draw/pixels.h>
+#include <draw/packed_pixels.h>
 #include <draw/shapes.h>
 #include <draw/views/canvas_settings.h>
 #include <draw/pixels.h>
@@ -21,6 +22,8 @@ struct PixelViewFields
     static constexpr auto fields = std::make_tuple(
         fields::Field(&T::canvas, "canvas"),
         fields::Field(&T::pixels, "pixels"),
+        fields::Field(&T::packedPixels, "packedPixels"),
+        fields::Field(&T::pixelRing, "pixelRing"),
         fields::Field(&T::shapes, "shapes"));
 };
 
@@ -33,6 +36,15 @@ struct PixelViewTemplate
 
     T<CanvasGroup> canvas;
     T<AsyncPixels> pixels;
+
+    // An alternative to pixels, in the layout of the platform's bitmaps.
+    // The view displays whichever was published last.
+    T<AsyncPackedPixels> packedPixels;
+
+    // Pixels that are drawn at the wrap point of a ring, like the window of
+    // a StreamingWaveform.
+    T<AsyncPixelRing> pixelRing;
+
     T<AsyncShapes> shapes;
 
     static constexpr auto fields = PixelViewFields<PixelViewTemplate>::fields;
@@ -62,6 +74,8 @@ struct PixelViewTemplates
             typename Base::AsyncShapes::DefaultControl;
 
         AsyncPixelsControl asyncPixels;
+        AsyncPackedPixelsControl asyncPackedPixels;
+        AsyncPixelRingControl asyncPixelRing;
         AsyncShapesControl asyncShapes;
 
         using Base::Base;
@@ -70,10 +84,14 @@ struct PixelViewTemplates
             :
             Base(upstream),
             asyncPixels(upstream.pixels.GetWorkerControl()),
+            asyncPackedPixels(upstream.packedPixels.GetWorkerControl()),
+            asyncPixelRing(upstream.pixelRing.GetWorkerControl()),
             asyncShapes(upstream.shapes.GetWorkerControl())
         {
             PEX_NAME("PixelViewControl");
             PEX_MEMBER(asyncPixels);
+            PEX_MEMBER(asyncPackedPixels);
+            PEX_MEMBER(asyncPixelRing);
             PEX_MEMBER(asyncShapes);
         }
 
@@ -81,6 +99,13 @@ struct PixelViewTemplates
         {
             this->StandardEmplace_(upstream);
             this->asyncPixels.Emplace(upstream.pixels.GetWorkerControl());
+
+            this->asyncPackedPixels.Emplace(
+                upstream.packedPixels.GetWorkerControl());
+
+            this->asyncPixelRing.Emplace(
+                upstream.pixelRing.GetWorkerControl());
+
             this->asyncShapes.Emplace(upstream.shapes.GetWorkerControl());
         }
 
@@ -88,6 +113,8 @@ struct PixelViewTemplates
         {
             this->StandardEmplace_(other);
             this->asyncPixels.Emplace(other.asyncPixels);
+            this->asyncPackedPixels.Emplace(other.asyncPackedPixels);
+            this->asyncPixelRing.Emplace(other.asyncPixelRing);
             this->asyncShapes.Emplace(other.asyncShapes);
         }
     };
@@ -2,8 +2,18 @@
 
 
 #include <cstdint>
+#include <unordered_map>
+#include <vector>
 #include <pex/ordered_list.h>
+#include <wxpex/ignores.h>
 #include <wxpex/list_view.h>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/panel.h>
+#include <wx/sizer.h>
+#include <wx/weakref.h>
+WXSHIM_POP_IGNORES
+
 #include "draw/shape_list.h"
 #include "draw/views/shape_view.h"
 
@@ -115,6 +125,40 @@ private:
 };
 
 
+/**
+ ** Holds the place of a shape added during a ShapeListBatch.
+ **
+ ** The display of the shape is not created until the batch closes, so the
+ ** ShapeView is added then.
+ **/
+template<typename ListItem>
+class PendingShapeView: public wxPanel
+{
+public:
+    PendingShapeView(wxWindow *parent, ListItem &listItem)
+        :
+        wxPanel(parent, wxID_ANY),
+        adaptor_(listItem)
+    {
+        this->SetSizer(new wxBoxSizer(wxVERTICAL));
+    }
+
+    int64_t GetId() const
+    {
+        return this->adaptor_.GetId();
+    }
+
+    void Fill(const ShapeDisplayControl &displayControl)
+    {
+        auto view = new ShapeView(this, this->adaptor_, displayControl);
+        this->GetSizer()->Add(view, 1, wxEXPAND);
+    }
+
+private:
+    ShapeAdaptor<ListItem> adaptor_;
+};
+
+
 class ShapeListView: public wxpex::ListView<OrderedShapesControl>
 {
 public:
@@ -132,21 +176,109 @@ public:
             parent,
             control.shapes,
             control.shapesDisplay.reorder),
-        control_(control)
+        control_(control),
+        pendingViews_(),
+
+        isBatchingEndpoint_(
+            this,
+            control.isBatching,
+            &ShapeListView::OnIsBatching_)
     {
         this->Initialize_();
     }
 
     wxWindow * CreateView_(ListItem &listItem, size_t index) override
     {
+        if (this->control_.isBatching.Get())
+        {
+            // shapesDisplay does not grow until the batch closes.
+            auto pending = new PendingView(this, listItem);
+            this->pendingViews_.emplace_back(pending);
+
+            return pending;
+        }
+
         return new ShapeView(
             this,
             ShapeAdaptor(listItem),
             this->control_.shapesDisplay.at(index));
     }
 
+private:
+    using PendingView = PendingShapeView<ListItem>;
+
+    void OnIsBatching_(bool isBatching)
+    {
+        // The window is not laid out or painted until the batch closes.
+        if (isBatching)
+        {
+            if (!this->IsFrozen())
+            {
+                this->Freeze();
+            }
+
+            return;
+        }
+
+        // The model has added the displays, so build the rows that were
+        // created during the batch.
+        this->FillPendingViews_();
+
+        if (this->IsFrozen())
+        {
+            this->Thaw();
+        }
+
+        this->Layout();
+    }
+
+    void FillPendingViews_()
+    {
+        if (this->pendingViews_.empty())
+        {
+            return;
+        }
+
+        auto &shapes = this->control_.shapes;
+        auto count = shapes.count.Get();
+        std::unordered_map<int64_t, size_t> indexById;
+        indexById.reserve(count);
+
+        for (size_t index = 0; index < count; ++index)
+        {
+            indexById.emplace(ShapeAdaptor(shapes.at(index)).GetId(), index);
+        }
+
+        for (auto &pending: this->pendingViews_)
+        {
+            if (!pending)
+            {
+                // The shape was erased later in the batch.
+                continue;
+            }
+
+            auto found = indexById.find(pending->GetId());
+
+            if (found == indexById.end())
+            {
+                continue;
+            }
+
+            pending->Fill(this->control_.shapesDisplay.at(found->second));
+            pending->Layout();
+        }
+
+        this->pendingViews_.clear();
+    }
+
 private:
     Control control_;
+
+    // Views created while the batch was open.
+    std::vector<wxWeakRef<PendingView>> pendingViews_;
+
+    using IsBatchingEndpoint = pex::Endpoint<ShapeListView, IsBatchingControl>;
+    IsBatchingEndpoint isBatchingEndpoint_;
 };
 
 
@@ -0,0 +1,418 @@
+#include "draw/views/tiled_pixel_canvas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <set>
+#include <stdexcept>
+#include <wxpex/ignores.h>
+#include "draw/view.h"
+#include "draw/bitmap.h"
+
+#ifdef __WXMSW__
+
+WXSHIM_PUSH_IGNORES
+#include <wx/dcbuffer.h>
+WXSHIM_POP_IGNORES
+
+#endif
+
+
+namespace draw
+{
+
+
+TiledPixelCanvas::TiledPixelCanvas(
+    wxWindow *parent,
+    const TiledPixelViewControl &control)
+    :
+    Canvas(parent, control.canvas),
+    tileSource_(control.tileSource),
+    tiles_(defaultCacheBytes),
+
+    scrollEndpoint_(
+        this,
+        control.canvas.viewSettings.viewPosition,
+        &TiledPixelCanvas::OnViewPosition_),
+
+    scrollPredictor_(),
+    tileLoader_()
+{
+    if (!this->tileSource_)
+    {
+        throw std::invalid_argument("tileSource must not be null");
+    }
+
+    this->tileLoader_ = std::make_unique<TileLoader>(
+        this->tileSource_,
+        [this]()
+        {
+            // Called from a loader thread.
+            this->CallAfter(&TiledPixelCanvas::OnTilesLoaded_);
+        });
+
+    this->control_.viewSettings.imageSize.Set(this->tileSource_->GetSize());
+
+    this->Bind(wxEVT_PAINT, &TiledPixelCanvas::OnPaint_, this);
+}
+
+
+TiledPixelCanvas::~TiledPixelCanvas()
+{
+    // Stop the workers before they can queue any more calls to this window.
+    this->tileLoader_->Shutdown();
+}
+
+
+void TiledPixelCanvas::OnPaint_(wxPaintEvent &)
+{
+#ifdef __WXMSW__
+    wxAutoBufferedPaintDC dc(this);
+#else
+    wxPaintDC dc(this);
+#endif
+
+    dc.SetBackground(wxBrush(*wxBLACK));
+    dc.Clear();
+
+    auto updateBox = this->GetUpdateRegion().GetBox();
+
+    auto clip = tau::Region<int>{{
+        wxpex::ToPoint<int>(updateBox.GetPosition()),
+        wxpex::ToSize<int>(updateBox.GetSize())}};
+
+    auto level = this->GetLevel_();
+
+    for (auto &key: this->GetTiles_(level, clip))
+    {
+        this->DrawTile_(dc, key);
+    }
+
+    // Request every visible tile, not only the damaged ones, because each
+    // request replaces the last.
+    this->RequestTiles_(level, this->GetWindowRegion_());
+}
+
+
+void TiledPixelCanvas::OnTilesLoaded_()
+{
+    auto loaded = this->tileLoader_->TakeLoaded();
+
+    if (loaded.empty())
+    {
+        return;
+    }
+
+    auto windowRegion = this->GetWindowRegion_();
+    auto visible = this->GetTiles_(this->GetLevel_(), windowRegion);
+
+    auto placeholders = this->GetTiles_(
+        this->tileSource_->GetLevelCount() - 1,
+        windowRegion);
+
+    std::set<TileKey> visibleKeys(visible.begin(), visible.end());
+    visibleKeys.insert(placeholders.begin(), placeholders.end());
+
+    bool isVisible = false;
+
+    for (auto &tile: loaded)
+    {
+        // Bitmaps are stored with 32 bits per pixel.
+        auto byteCount = static_cast<size_t>(tile.pixels->size.GetArea()) * 4;
+
+        this->tiles_.Insert(tile.key, GetBitmap(*tile.pixels), byteCount);
+        isVisible = isVisible || visibleKeys.count(tile.key);
+    }
+
+    if (isVisible)
+    {
+        // Prefetched tiles wait in the cache until they are scrolled into
+        // view.
+        this->Refresh(false);
+    }
+}
+
+
+void TiledPixelCanvas::OnViewPosition_(const IntPoint &viewPosition)
+{
+    if (this->scrollPredictor_.Report(viewPosition))
+    {
+        // The tiles ahead of the old direction are no longer needed.
+        this->tileLoader_->CancelPrefetch();
+    }
+
+    this->PrefetchTiles_();
+}
+
+
+tau::Region<int> TiledPixelCanvas::GetWindowRegion_() const
+{
+    return tau::Region<int>{{
+        tau::Point2d<int>(0, 0),
+        this->control_.viewSettings.viewSize.Get()}};
+}
+
+
+size_t TiledPixelCanvas::GetLevel_() const
+{
+    return SelectPyramidLevel(
+        this->scaleEndpoint_.Get(),
+        this->tileSource_->GetLevelCount());
+}
+
+
+Scale TiledPixelCanvas::GetLevelScale_(size_t level) const
+{
+    auto size = this->tileSource_->GetSize();
+    auto levelSize = this->tileSource_->GetLevelSize(level);
+    auto result = this->scaleEndpoint_.Get();
+
+    result.horizontal *= static_cast<double>(size.width)
+        / static_cast<double>(levelSize.width);
+
+    result.vertical *= static_cast<double>(size.height)
+        / static_cast<double>(levelSize.height);
+
+    return result;
+}
+
+
+std::vector<TileKey> TiledPixelCanvas::GetTiles_(
+    size_t level,
+    const tau::Region<int> &windowRegion) const
+{
+    auto view = MakeAlignedView(
+        this->viewPositionEndpoint_.Get(),
+        windowRegion,
+        this->tileSource_->GetLevelSize(level),
+        this->GetLevelScale_(level));
+
+    if (!view.HasArea())
+    {
+        return {};
+    }
+
+    auto tileSize = this->tileSource_->GetTileSize();
+    auto bottomRight = view.source.GetBottomRight();
+
+    auto firstColumn = view.source.topLeft.x / tileSize;
+    auto firstRow = view.source.topLeft.y / tileSize;
+    auto lastColumn = (bottomRight.x - 1) / tileSize;
+    auto lastRow = (bottomRight.y - 1) / tileSize;
+
+    std::vector<TileKey> result;
+
+    for (auto row = firstRow; row <= lastRow; ++row)
+    {
+        for (auto column = firstColumn; column <= lastColumn; ++column)
+        {
+            result.push_back(TileKey{level, column, row});
+        }
+    }
+
+    return result;
+}
+
+
+void TiledPixelCanvas::RequestTiles_(
+    size_t level,
+    const tau::Region<int> &windowRegion)
+{
+    std::vector<TileRequest> requests;
+
+    auto coarsest = this->tileSource_->GetLevelCount() - 1;
+
+    if (coarsest != level)
+    {
+        // The coarsest level is small, and provides placeholders for every
+        // other level, so it is loaded first.
+        for (auto &key: this->GetTiles_(coarsest, windowRegion))
+        {
+            if (!this->tiles_.Contains(key))
+            {
+                requests.push_back(TileRequest{key, -1.0});
+            }
+        }
+    }
+
+    auto keys = this->GetTiles_(level, windowRegion);
+
+    if (keys.empty())
+    {
+        this->tileLoader_->Request(std::move(requests));
+
+        return;
+    }
+
+    // Load tiles from the center of the view outward.
+    auto centerColumn =
+        static_cast<double>(keys.front().column + keys.back().column) / 2.0;
+
+    auto centerRow =
+        static_cast<double>(keys.front().row + keys.back().row) / 2.0;
+
+    for (auto &key: keys)
+    {
+        if (this->tiles_.Contains(key))
+        {
+            continue;
+        }
+
+        auto x = static_cast<double>(key.column) - centerColumn;
+        auto y = static_cast<double>(key.row) - centerRow;
+
+        requests.push_back(TileRequest{key, x * x + y * y});
+    }
+
+    this->tileLoader_->Request(std::move(requests));
+}
+
+
+void TiledPixelCanvas::PrefetchTiles_()
+{
+    auto offset = this->scrollPredictor_.PredictOffset(prefetchSeconds);
+
+    if (offset.x == 0 && offset.y == 0)
+    {
+        return;
+    }
+
+    auto windowRegion = this->GetWindowRegion_();
+    auto viewSize = windowRegion.size;
+
+    // Look ahead by at most one window.
+    offset.x = std::clamp(offset.x, -viewSize.width, viewSize.width);
+    offset.y = std::clamp(offset.y, -viewSize.height, viewSize.height);
+
+    auto predicted = windowRegion;
+    predicted.topLeft = predicted.topLeft + offset;
+
+    auto level = this->GetLevel_();
+    auto visible = this->GetTiles_(level, windowRegion);
+    std::set<TileKey> visibleKeys(visible.begin(), visible.end());
+
+    auto tileSize = static_cast<double>(this->tileSource_->GetTileSize());
+    auto scale = this->GetLevelScale_(level);
+    auto viewPosition = this->viewPositionEndpoint_.Get();
+
+    // The center of the window, in tiles.
+    auto centerColumn =
+        (viewPosition.x + viewSize.width / 2) / scale.horizontal / tileSize;
+
+    auto centerRow =
+        (viewPosition.y + viewSize.height / 2) / scale.vertical / tileSize;
+
+    std::vector<TileRequest> requests;
+
+    for (auto &key: this->GetTiles_(level, predicted))
+    {
+        if (visibleKeys.count(key) || this->tiles_.Contains(key))
+        {
+            continue;
+        }
+
+        // The nearest tiles will be exposed first.
+        auto x = static_cast<double>(key.column) + 0.5 - centerColumn;
+        auto y = static_cast<double>(key.row) + 0.5 - centerRow;
+
+        requests.push_back(TileRequest{key, x * x + y * y});
+    }
+
+    this->tileLoader_->Prefetch(std::move(requests));
+}
+
+
+void TiledPixelCanvas::DrawTile_(wxDC &context, const TileKey &key)
+{
+    auto region = this->tileSource_->GetTileRegion(key);
+    auto bitmap = this->tiles_.Find(key);
+
+    if (bitmap)
+    {
+        this->Blit_(context, key, *bitmap, region);
+
+        return;
+    }
+
+    auto tileSize = this->tileSource_->GetTileSize();
+    auto levelCount = this->tileSource_->GetLevelCount();
+    auto bottomRight = region.GetBottomRight();
+
+    for (auto level = key.level + 1; level < levelCount; ++level)
+    {
+        auto shift = static_cast<int>(level - key.level);
+        auto roundUp = (1 << shift) - 1;
+
+        // The pixels of the coarser level that cover this tile.
+        auto left = region.topLeft.x >> shift;
+        auto top = region.topLeft.y >> shift;
+        auto right = (bottomRight.x + roundUp) >> shift;
+        auto bottom = (bottomRight.y + roundUp) >> shift;
+
+        auto coarserKey = TileKey{level, left / tileSize, top / tileSize};
+        auto coarser = this->tiles_.Find(coarserKey);
+
+        if (!coarser)
+        {
+            continue;
+        }
+
+        auto covered = tau::Region<int>{{
+            tau::Point2d<int>(left, top),
+            tau::Size<int>(right - left, bottom - top)}};
+
+        covered = covered.Intersect(
+            this->tileSource_->GetTileRegion(coarserKey));
+
+        this->Blit_(context, coarserKey, *coarser, covered);
+
+        return;
+    }
+
+    // Nothing has been loaded for this part of the image.
+}
+
+
+void TiledPixelCanvas::Blit_(
+    wxDC &context,
+    const TileKey &key,
+    const wxBitmap &bitmap,
+    const tau::Region<int> &region)
+{
+    if (!region.size.HasArea())
+    {
+        return;
+    }
+
+    auto tileRegion = this->tileSource_->GetTileRegion(key);
+    auto scale = this->GetLevelScale_(key.level);
+    auto viewPosition = this->viewPositionEndpoint_.Get();
+    auto bottomRight = region.GetBottomRight();
+
+    auto toWindow = [](int index, double factor, int offset) -> int
+    {
+        return static_cast<int>(
+            std::round(static_cast<double>(index) * factor)) - offset;
+    };
+
+    auto left = toWindow(region.topLeft.x, scale.horizontal, viewPosition.x);
+    auto top = toWindow(region.topLeft.y, scale.vertical, viewPosition.y);
+    auto right = toWindow(bottomRight.x, scale.horizontal, viewPosition.x);
+    auto bottom = toWindow(bottomRight.y, scale.vertical, viewPosition.y);
+
+    wxMemoryDC source;
+    source.SelectObjectAsSource(bitmap);
+
+    context.StretchBlit(
+        left,
+        top,
+        right - left,
+        bottom - top,
+        &source,
+        region.topLeft.x - tileRegion.topLeft.x,
+        region.topLeft.y - tileRegion.topLeft.y,
+        region.size.width,
+        region.size.height);
+}
+
+
+} // end namespace draw
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "draw/views/canvas.h"
+#include "draw/tile_source.h"
+#include "draw/tile_cache.h"
+#include "draw/tile_loader.h"
+#include "draw/scroll_predictor.h"
+
+
+namespace draw
+{
+
+
+struct TiledPixelViewControl
+{
+    CanvasControl canvas;
+    std::shared_ptr<TileSource> tileSource;
+};
+
+
+/**
+ ** Displays an image that is too large for one bitmap.
+ **
+ ** Only the tiles that intersect the view, at the pyramid level that suits
+ ** the current scale, are loaded. Tiles that have not arrived are covered by
+ ** the best available tile from a coarser level.
+ **
+ ** While scrolling, the tiles that will be exposed next are prefetched in
+ ** the direction of travel.
+ **/
+class TiledPixelCanvas: public Canvas
+{
+public:
+    static constexpr auto observerName = "TiledPixelCanvas";
+
+    static constexpr size_t defaultCacheBytes = size_t{512} * 1024 * 1024;
+
+    // How far ahead of the current scroll position to prefetch.
+    static constexpr double prefetchSeconds = 0.3;
+
+    TiledPixelCanvas(
+        wxWindow *parent,
+        const TiledPixelViewControl &control);
+
+    ~TiledPixelCanvas();
+
+private:
+    using TileBitmaps = TileCache<wxBitmap>;
+
+    void OnPaint_(wxPaintEvent &);
+
+    void OnTilesLoaded_();
+
+    void OnViewPosition_(const IntPoint &viewPosition);
+
+    // The window region.
+    tau::Region<int> GetWindowRegion_() const;
+
+    // The level used to display the current scale.
+    size_t GetLevel_() const;
+
+    // The scale that displays a level at the size of the full image.
+    Scale GetLevelScale_(size_t level) const;
+
+    // Tiles of a level that intersect a window region.
+    std::vector<TileKey> GetTiles_(
+        size_t level,
+        const tau::Region<int> &windowRegion) const;
+
+    // Queue the visible tiles, the most central first.
+    void RequestTiles_(size_t level, const tau::Region<int> &windowRegion);
+
+    // Queue the tiles that the predicted scroll will expose.
+    void PrefetchTiles_();
+
+    // Paint a tile, or the part of a coarser tile that covers it.
+    void DrawTile_(wxDC &context, const TileKey &key);
+
+    /**
+     ** Stretch part of a tile bitmap onto the pixel grid of its level.
+     **
+     ** @param region The pixels to draw, in the coordinates of the level.
+     **/
+    void Blit_(
+        wxDC &context,
+        const TileKey &key,
+        const wxBitmap &bitmap,
+        const tau::Region<int> &region);
+
+private:
+    std::shared_ptr<TileSource> tileSource_;
+    TileBitmaps tiles_;
+
+    pex::Endpoint<TiledPixelCanvas, IntPointControl> scrollEndpoint_;
+    ScrollPredictor scrollPredictor_;
+
+    // Declared last, so the workers stop before the canvas is destroyed.
+    std::unique_ptr<TileLoader> tileLoader_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,19 @@
+#include "draw/views/tiled_pixel_view.h"
+
+
+namespace draw
+{
+
+
+TiledPixelView::TiledPixelView(
+    wxWindow *parent,
+    const TiledPixelViewControl &control,
+    const CanvasViewOptions &options)
+    :
+    CanvasView<TiledPixelCanvas>(parent, control.canvas, control, options)
+{
+
+}
+
+
+} // end namespace draw
@@ -0,0 +1,27 @@
+#pragma once
+
+
+#include "draw/views/canvas_view.h"
+#include "draw/views/tiled_pixel_canvas.h"
+
+
+namespace draw
+{
+
+
+class TiledPixelView: public CanvasView<TiledPixelCanvas>
+{
+public:
+    static constexpr auto observerName = "TiledPixelView";
+
+    TiledPixelView(
+        wxWindow *parent,
+        const TiledPixelViewControl &control,
+        const CanvasViewOptions &options = CanvasViewOptions{});
+};
+
+
+using TiledPixelFrame = CanvasFrame<TiledPixelView, TiledPixelViewControl>;
+
+
+} // end namespace draw
@@ -0,0 +1,75 @@
+#include "draw/views/trace_stats_view.h"
+
+#include <fmt/core.h>
+#include <wxpex/ignores.h>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/sizer.h>
+WXSHIM_POP_IGNORES
+
+
+namespace draw
+{
+
+
+TraceStatsView::TraceStatsView(
+    wxWindow *parent,
+    const TraceStatsControl &control,
+    int intervalMilliseconds)
+    :
+    wxPanel(parent, wxID_ANY),
+    control_(control),
+    table_(new wxStaticText(this, wxID_ANY, "")),
+    timer_(this),
+    statsEndpoint_(this, control.stats, &TraceStatsView::OnStats_)
+{
+    this->table_->SetFont(
+        wxFont(wxFontInfo().Family(wxFONTFAMILY_TELETYPE)));
+
+    auto sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(this->table_, 1, wxEXPAND | wxALL, 5);
+    this->SetSizer(sizer);
+
+    this->OnStats_(control.stats.Get());
+
+    this->Bind(wxEVT_TIMER, &TraceStatsView::OnTimer_, this);
+    this->timer_.Start(intervalMilliseconds);
+}
+
+
+void TraceStatsView::OnTimer_(wxTimerEvent &)
+{
+    PublishTraceStats(this->control_);
+}
+
+
+void TraceStatsView::OnStats_(const std::vector<TraceStat> &stats)
+{
+    std::string text = fmt::format(
+        "{:<32} {:>10} {:>10} {:>10}\n",
+        "name",
+        "count",
+        "p50",
+        "p99");
+
+    for (auto &stat: stats)
+    {
+        // Scopes are in milliseconds.
+        auto unit = (stat.isCounter) ? "" : " ms";
+
+        text += fmt::format(
+            "{:<32} {:>10} {:>7.3f}{:<3} {:>7.3f}{:<3}\n",
+            stat.name,
+            stat.count,
+            stat.p50,
+            unit,
+            stat.p99,
+            unit);
+    }
+
+    this->table_->SetLabel(text);
+    this->Layout();
+}
+
+
+} // end namespace draw
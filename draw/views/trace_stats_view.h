@@ -0,0 +1,55 @@
+#pragma once
+
+
+#include <pex/endpoint.h>
+#include <wxpex/ignores.h>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/panel.h>
+#include <wx/stattext.h>
+#include <wx/timer.h>
+WXSHIM_POP_IGNORES
+
+#include "draw/trace_stats.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** Shows the rolling percentiles of each traced scope and counter.
+ **
+ ** While the view exists, it collects from the tracer at a fixed interval.
+ ** Without DRAW_ENABLE_TRACE nothing is recorded, and the table is empty.
+ **/
+class TraceStatsView: public wxPanel
+{
+public:
+    static constexpr auto observerName = "TraceStatsView";
+
+    static constexpr int defaultIntervalMilliseconds = 500;
+
+    TraceStatsView(
+        wxWindow *parent,
+        const TraceStatsControl &control,
+        int intervalMilliseconds = defaultIntervalMilliseconds);
+
+private:
+    void OnTimer_(wxTimerEvent &);
+
+    void OnStats_(const std::vector<TraceStat> &stats);
+
+private:
+    TraceStatsControl control_;
+    wxStaticText *table_;
+    wxTimer timer_;
+
+    using StatsEndpoint =
+        pex::Endpoint<TraceStatsView, decltype(TraceStatsControl::stats)>;
+
+    StatsEndpoint statsEndpoint_;
+};
+
+
+} // end namespace draw
@@ -1,5 +1,6 @@
 #include <draw/views/view_link.h>
 #include <functional>
+#include <utility>
 
 
 // #define ENABLE_VIEW_LINK_LOG
@@ -29,10 +30,6 @@ namespace draw
 {
 
 
-using TriggerFunction =
-    std::function<void(ViewSettingsControl &, const LinkOptions &)>;
-
-
 void TriggerResetZoom(
     ViewSettingsControl &viewSettings,
     const LinkOptions &linkOptions)
@@ -91,10 +88,7 @@ void TriggerRecenter(
 
 
 template<typename T, typename U>
-bool SetChanged(
-    T &control,
-    U value,
-    [[maybe_unused]] const std::string &name)
+bool SetChanged(T &control, U value)
 {
     if (value != control.Get())
     {
@@ -107,76 +101,126 @@ bool SetChanged(
 }
 
 
-void ApplyViewSettings(
-    const std::string &name,
+template<typename Defer>
+void SetLinked(
+    Defer &defer,
     const ViewSettings &source,
-    ViewSettingsControl &target,
     const LinkOptions &linkOptions)
 {
-    auto defer = pex::MakeDefer(target);
-
     if (linkOptions.scale == Link::both)
     {
-        SetChanged(defer.scale, source.scale, fmt::format("{} scale", name));
+        SetChanged(defer.scale, source.scale);
     }
     else if (linkOptions.scale == Link::horizontal)
     {
-        SetChanged(
-            defer.scale.horizontal,
-            source.scale.horizontal,
-            fmt::format("{} scale.horizontal", name));
+        SetChanged(defer.scale.horizontal, source.scale.horizontal);
     }
     else if (linkOptions.scale == Link::vertical)
     {
-        SetChanged(
-            defer.scale.vertical,
-            source.scale.vertical,
-            fmt::format("{} scale.vertical", name));
+        SetChanged(defer.scale.vertical, source.scale.vertical);
     }
 
     if (linkOptions.position == Link::both)
     {
-        SetChanged(
-            defer.viewPosition,
-            source.viewPosition,
-            fmt::format("{} viewPosition", name));
+        SetChanged(defer.viewPosition, source.viewPosition);
     }
     else if (linkOptions.position == Link::horizontal)
     {
-        SetChanged(
-            defer.viewPosition.x,
-            source.viewPosition.x,
-            fmt::format("{} viewPosition.x", name));
+        SetChanged(defer.viewPosition.x, source.viewPosition.x);
     }
     else if (linkOptions.position == Link::vertical)
     {
-        SetChanged(
-            defer.viewPosition.y,
-            source.viewPosition.y,
-            fmt::format("{} viewPosition.y", name));
+        SetChanged(defer.viewPosition.y, source.viewPosition.y);
     }
 
     if (linkOptions.size == Link::both)
     {
-        SetChanged(
-            defer.viewSize,
-            source.viewSize,
-            fmt::format("{} viewSize", name));
+        SetChanged(defer.viewSize, source.viewSize);
     }
     else if (linkOptions.size == Link::horizontal)
     {
-        SetChanged(
-            defer.viewSize.width,
-            source.viewSize.width,
-            fmt::format("{} viewSize.width", name));
+        SetChanged(defer.viewSize.width, source.viewSize.width);
     }
     else if (linkOptions.size == Link::vertical)
     {
-        SetChanged(
-            defer.viewSize.height,
-            source.viewSize.height,
-            fmt::format("{} viewSize.height", name));
+        SetChanged(defer.viewSize.height, source.viewSize.height);
+    }
+}
+
+
+void ApplyViewSettings(
+    [[maybe_unused]] const std::string &name,
+    const ViewSettings &source,
+    ViewSettingsControl &target,
+    const LinkOptions &linkOptions)
+{
+    auto defer = pex::MakeDefer(target);
+    SetLinked(defer, source, linkOptions);
+}
+
+
+// Whether two views agree on the settings that are linked.
+static bool IsLinkedEqual(
+    const ViewSettings &first,
+    const ViewSettings &second,
+    const LinkOptions &linkOptions)
+{
+    if (IsHorizontal(linkOptions.scale)
+        && first.scale.horizontal != second.scale.horizontal)
+    {
+        return false;
+    }
+
+    if (IsVertical(linkOptions.scale)
+        && first.scale.vertical != second.scale.vertical)
+    {
+        return false;
+    }
+
+    if (IsHorizontal(linkOptions.position)
+        && first.viewPosition.x != second.viewPosition.x)
+    {
+        return false;
+    }
+
+    if (IsVertical(linkOptions.position)
+        && first.viewPosition.y != second.viewPosition.y)
+    {
+        return false;
+    }
+
+    if (IsHorizontal(linkOptions.size)
+        && first.viewSize.width != second.viewSize.width)
+    {
+        return false;
+    }
+
+    if (IsVertical(linkOptions.size)
+        && first.viewSize.height != second.viewSize.height)
+    {
+        return false;
     }
+
+    return true;
+}
+
+
+// Signals are not linked along an axis whose settings are already linked.
+static LinkOptions MaskTriggers(LinkOptions options)
+{
+    options.resetZoom = static_cast<Link>(
+        static_cast<uint8_t>(options.resetZoom)
+            & ~static_cast<uint8_t>(options.scale));
+
+    options.fitZoom = static_cast<Link>(
+        static_cast<uint8_t>(options.fitZoom)
+            & ~static_cast<uint8_t>(options.scale));
+
+    options.recenter = static_cast<Link>(
+        static_cast<uint8_t>(options.recenter)
+            & ~static_cast<uint8_t>(options.position));
+
+    return options;
 }
 
 
@@ -227,18 +271,7 @@ ViewLink::ViewLink(
         second,
         &ViewLink::OnSecondViewSettings_)
 {
-    options.resetZoom = static_cast<Link>(
-        static_cast<uint8_t>(options.resetZoom)
-            & ~static_cast<uint8_t>(options.scale));
-
-    options.fitZoom = static_cast<Link>(
-        static_cast<uint8_t>(options.fitZoom)
-            & ~static_cast<uint8_t>(options.scale));
-
-    options.recenter = static_cast<Link>(
-        static_cast<uint8_t>(options.recenter)
-            & ~static_cast<uint8_t>(options.position));
-
+    options = MaskTriggers(options);
     this->options_ = options;
 
     if (IsLinked(options.resetZoom))
@@ -285,7 +318,7 @@ ViewLink::ViewLink(
 void ViewLink::OnFirstViewSettings_(const ViewSettings &firstViewSettings)
 {
     ApplyViewSettings(
-        fmt::format("{} firstViewSettings", this->name_),
+        this->name_,
         firstViewSettings,
         this->secondViewControl_,
         this->options_);
@@ -295,7 +328,7 @@ void ViewLink::OnFirstViewSettings_(const ViewSettings &firstViewSettings)
 void ViewLink::OnSecondViewSettings_(const ViewSettings &secondViewSettings)
 {
     ApplyViewSettings(
-        fmt::format("{} secondViewSettings", this->name_),
+        this->name_,
         secondViewSettings,
         this->firstViewControl_,
         this->options_);
@@ -322,7 +355,7 @@ void ProcessTrigger_(
 void ViewLink::OnFirstResetZoom_()
 {
     ProcessTrigger_(
-        fmt::format("{} firstResetZoom", name_),
+        this->name_,
         this->ignoreSignal_,
         TriggerResetZoom,
         this->secondViewControl_,
@@ -332,7 +365,7 @@ void ViewLink::OnFirstResetZoom_()
 void ViewLink::OnSecondResetZoom_()
 {
     ProcessTrigger_(
-        fmt::format("{} secondResetZoom", name_),
+        this->name_,
         this->ignoreSignal_,
         TriggerResetZoom,
         this->firstViewControl_,
@@ -342,7 +375,7 @@ void ViewLink::OnSecondResetZoom_()
 void ViewLink::OnFirstFitZoom_()
 {
     ProcessTrigger_(
-        fmt::format("{} firstFitZoom", name_),
+        this->name_,
         this->ignoreSignal_,
         TriggerFitZoom,
         this->secondViewControl_,
@@ -352,7 +385,7 @@ void ViewLink::OnFirstFitZoom_()
 void ViewLink::OnSecondFitZoom_()
 {
     ProcessTrigger_(
-        fmt::format("{} secondFitZoom", name_),
+        this->name_,
         this->ignoreSignal_,
         TriggerFitZoom,
         this->firstViewControl_,
@@ -362,7 +395,7 @@ void ViewLink::OnSecondFitZoom_()
 void ViewLink::OnFirstRecenter_()
 {
     ProcessTrigger_(
-        fmt::format("{} firstRecenter", name_),
+        this->name_,
         this->ignoreSignal_,
         TriggerRecenter,
         this->secondViewControl_,
@@ -372,7 +405,7 @@ void ViewLink::OnFirstRecenter_()
 void ViewLink::OnSecondRecenter_()
 {
     ProcessTrigger_(
-        fmt::format("{} secondRecenter", name_),
+        this->name_,
         this->ignoreSignal_,
         TriggerRecenter,
         this->firstViewControl_,
@@ -380,4 +413,246 @@ void ViewLink::OnSecondRecenter_()
 }
 
 
+namespace detail
+{
+
+
+ViewLinkMember::ViewLinkMember(
+    ViewLinkGroup *group,
+    size_t index,
+    const ViewSettingsControl &control,
+    const LinkOptions &options)
+    :
+    control_(control),
+    group_(group),
+    index_(index),
+    viewSettingsEndpoint_(
+        this,
+        control,
+        &ViewLinkMember::OnViewSettings_),
+    resetZoom_(),
+    fitZoom_(),
+    recenter_()
+{
+    if (IsLinked(options.resetZoom))
+    {
+        this->resetZoom_ = SignalEndpoint(
+            this,
+            control.resetZoom,
+            &ViewLinkMember::OnResetZoom_);
+    }
+
+    if (IsLinked(options.fitZoom))
+    {
+        this->fitZoom_ = SignalEndpoint(
+            this,
+            control.fitZoom,
+            &ViewLinkMember::OnFitZoom_);
+    }
+
+    if (IsLinked(options.recenter))
+    {
+        this->recenter_ = SignalEndpoint(
+            this,
+            control.recenter,
+            &ViewLinkMember::OnRecenter_);
+    }
+}
+
+
+ViewSettingsControl & ViewLinkMember::GetControl()
+{
+    return this->control_;
+}
+
+
+void ViewLinkMember::OnViewSettings_(const ViewSettings &viewSettings)
+{
+    this->group_->OnViewSettings_(this->index_, viewSettings);
+}
+
+
+void ViewLinkMember::OnResetZoom_()
+{
+    this->group_->OnTrigger_(this->index_, TriggerResetZoom);
+}
+
+
+void ViewLinkMember::OnFitZoom_()
+{
+    this->group_->OnTrigger_(this->index_, TriggerFitZoom);
+}
+
+
+void ViewLinkMember::OnRecenter_()
+{
+    this->group_->OnTrigger_(this->index_, TriggerRecenter);
+}
+
+
+} // end namespace detail
+
+
+ViewLinkGroup::ViewLinkGroup(LinkOptions options)
+    :
+    name_(),
+    options_(MaskTriggers(options)),
+    isApplying_(false),
+    members_()
+{
+
+}
+
+
+ViewLinkGroup::ViewLinkGroup(
+    const std::vector<ViewSettingsControl> &controls,
+    LinkOptions options)
+    :
+    ViewLinkGroup(options)
+{
+    this->members_.reserve(controls.size());
+
+    for (auto &control: controls)
+    {
+        this->Add(control);
+    }
+}
+
+
+void ViewLinkGroup::Add(const ViewSettingsControl &control)
+{
+    this->members_.push_back(
+        std::make_unique<detail::ViewLinkMember>(
+            this,
+            this->members_.size(),
+            control,
+            this->options_));
+}
+
+
+void ViewLinkGroup::SetName(const std::string &name)
+{
+    this->name_ = name;
+}
+
+
+size_t ViewLinkGroup::GetCount() const
+{
+    return this->members_.size();
+}
+
+
+const LinkOptions & ViewLinkGroup::GetOptions() const
+{
+    return this->options_;
+}
+
+
+void ViewLinkGroup::OnViewSettings_(
+    size_t index,
+    const ViewSettings &viewSettings)
+{
+    if (this->isApplying_)
+    {
+        // This notification was caused by the group, and every member has
+        // already been given the source settings.
+        return;
+    }
+
+    auto applying = jive::ScopeFlag(this->isApplying_);
+
+    auto sourceIndex = index;
+    auto source = viewSettings;
+
+    // A member may clamp the settings it is given. The clamped settings are
+    // then given to the rest of the group, until every member agrees.
+    for (size_t pass = 0; pass < this->members_.size(); ++pass)
+    {
+        this->ApplyToMembers_(sourceIndex, source);
+
+        auto clamped = this->FindClamped_(sourceIndex, source);
+
+        if (!clamped)
+        {
+            return;
+        }
+
+        sourceIndex = *clamped;
+        source = this->members_[sourceIndex]->GetControl().Get();
+    }
+}
+
+
+void ViewLinkGroup::ApplyToMembers_(
+    size_t sourceIndex,
+    const ViewSettings &source)
+{
+    using Defer =
+        decltype(pex::MakeDefer(std::declval<ViewSettingsControl &>()));
+
+    std::vector<std::unique_ptr<Defer>> defers;
+    defers.reserve(this->members_.size());
+
+    for (auto &member: this->members_)
+    {
+        if (member->GetIndex() == sourceIndex)
+        {
+            continue;
+        }
+
+        defers.emplace_back(new Defer(pex::MakeDefer(member->GetControl())));
+        SetLinked(*defers.back(), source, this->options_);
+    }
+
+    // Every member has its new settings before any of them notifies.
+    defers.clear();
+}
+
+
+std::optional<size_t> ViewLinkGroup::FindClamped_(
+    size_t sourceIndex,
+    const ViewSettings &source) const
+{
+    for (auto &member: this->members_)
+    {
+        if (member->GetIndex() == sourceIndex)
+        {
+            continue;
+        }
+
+        auto settings = member->GetControl().Get();
+
+        if (!IsLinkedEqual(settings, source, this->options_))
+        {
+            return member->GetIndex();
+        }
+    }
+
+    return {};
+}
+
+
+void ViewLinkGroup::OnTrigger_(
+    size_t index,
+    TriggerFunction triggerFunction)
+{
+    if (this->isApplying_)
+    {
+        return;
+    }
+
+    auto applying = jive::ScopeFlag(this->isApplying_);
+
+    for (auto &member: this->members_)
+    {
+        if (member->GetIndex() == index)
+        {
+            continue;
+        }
+
+        triggerFunction(member->GetControl(), this->options_);
+    }
+}
+
+
 } // end namespace draw
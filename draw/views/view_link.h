@@ -1,7 +1,10 @@
 #pragma once
 
 
+#include <functional>
+#include <memory>
 #include <optional>
+#include <vector>
 #include <jive/scope_flag.h>
 #include "draw/views/view_settings.h"
 
@@ -131,6 +134,10 @@ void TriggerRecenter(
     const LinkOptions &linkOptions);
 
 
+using TriggerFunction =
+    std::function<void(ViewSettingsControl &, const LinkOptions &)>;
+
+
 void ApplyViewSettings(
     const std::string &name,
     const ViewSettings &source,
@@ -204,4 +211,112 @@ private:
 };
 
 
+class ViewLinkGroup;
+
+
+namespace detail
+{
+
+
+// Forwards the notifications of one member to its ViewLinkGroup.
+class ViewLinkMember
+{
+public:
+    ViewLinkMember(
+        ViewLinkGroup *group,
+        size_t index,
+        const ViewSettingsControl &control,
+        const LinkOptions &options);
+
+    size_t GetIndex() const
+    {
+        return this->index_;
+    }
+
+    ViewSettingsControl & GetControl();
+
+private:
+    void OnViewSettings_(const ViewSettings &viewSettings);
+
+    void OnResetZoom_();
+
+    void OnFitZoom_();
+
+    void OnRecenter_();
+
+private:
+    using ViewSettingsEndpoint =
+        pex::Endpoint<ViewLinkMember, ViewSettingsControl>;
+
+    using SignalEndpoint =
+        pex::Endpoint<ViewLinkMember, pex::control::DefaultSignal>;
+
+    ViewSettingsControl control_;
+    ViewLinkGroup *group_;
+    size_t index_;
+
+    ViewSettingsEndpoint viewSettingsEndpoint_;
+    SignalEndpoint resetZoom_;
+    SignalEndpoint fitZoom_;
+    SignalEndpoint recenter_;
+};
+
+
+} // end namespace detail
+
+
+/**
+ ** Links any number of views through one hub.
+ **
+ ** A change to one member is applied to every other member once. Every
+ ** member is given its new settings before any of them notifies, and the
+ ** notifications that this causes are not forwarded again, so linking N
+ ** views costs N - 1 updates instead of the cascade that pairwise or chained
+ ** ViewLinks produce. When a member clamps the settings it is given, the
+ ** clamped settings are applied to the rest of the group.
+ **/
+class ViewLinkGroup
+{
+public:
+    ViewLinkGroup(LinkOptions options = LinkOptions{});
+
+    ViewLinkGroup(
+        const std::vector<ViewSettingsControl> &controls,
+        LinkOptions options = LinkOptions{});
+
+    ViewLinkGroup(const ViewLinkGroup &) = delete;
+    ViewLinkGroup & operator=(const ViewLinkGroup &) = delete;
+
+    void Add(const ViewSettingsControl &control);
+
+    void SetName(const std::string &name);
+
+    size_t GetCount() const;
+
+    const LinkOptions & GetOptions() const;
+
+private:
+    friend class detail::ViewLinkMember;
+
+    void OnViewSettings_(size_t index, const ViewSettings &viewSettings);
+
+    void OnTrigger_(size_t index, TriggerFunction triggerFunction);
+
+    void ApplyToMembers_(size_t sourceIndex, const ViewSettings &source);
+
+    // @return The index of a member that does not agree with source.
+    std::optional<size_t> FindClamped_(
+        size_t sourceIndex,
+        const ViewSettings &source) const;
+
+private:
+    // Passed to ApplyViewSettings for logging.
+    std::string name_;
+
+    LinkOptions options_;
+    bool isApplying_;
+    std::vector<std::unique_ptr<detail::ViewLinkMember>> members_;
+};
+
+
 } // end namespace draw
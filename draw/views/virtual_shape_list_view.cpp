@@ -0,0 +1,725 @@
+#include "draw/views/virtual_shape_list_view.h"
+
+#include <algorithm>
+#include <numeric>
+#include <fmt/core.h>
+#include <wxpex/ignores.h>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/sizer.h>
+#include <wx/collpane.h>
+WXSHIM_POP_IGNORES
+
+#include "draw/views/order_view.h"
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+ShapeListRow::ShapeListRow(wxWindow *parent, OnEditorResize onEditorResize)
+    :
+    wxPanel(parent, wxID_ANY),
+    index_(0),
+
+    expand_(
+        new wxButton(
+            this,
+            wxID_ANY,
+            "+",
+            wxDefaultPosition,
+            wxDefaultSize,
+            wxBU_EXACTFIT)),
+
+    label_(new wxStaticText(this, wxID_ANY, "")),
+    editor_(nullptr),
+    onEditorResize_(onEditorResize),
+    lookDisplayEndpoint_()
+{
+    auto header = new wxBoxSizer(wxHORIZONTAL);
+    header->Add(this->expand_, 0, wxRIGHT | wxALIGN_CENTER_VERTICAL, 5);
+    header->Add(this->label_, 1, wxALIGN_CENTER_VERTICAL);
+
+    auto sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(header, 0, wxEXPAND | wxALL, 2);
+
+    this->SetSizer(sizer);
+
+    // Sections of the shape view collapse without changing the look display.
+    this->Bind(
+        wxEVT_COLLAPSIBLEPANE_CHANGED,
+        &ShapeListRow::OnPaneChanged_,
+        this);
+}
+
+
+void ShapeListRow::Assign(
+    size_t unordered,
+    const std::string &label,
+    bool isExpanded)
+{
+    this->index_ = unordered;
+    this->label_->SetLabel(label);
+    this->expand_->SetLabel(isExpanded ? "-" : "+");
+}
+
+
+size_t ShapeListRow::GetIndex() const
+{
+    return this->index_;
+}
+
+
+wxButton * ShapeListRow::GetExpandButton()
+{
+    return this->expand_;
+}
+
+
+void ShapeListRow::SetEditor(
+    wxWindow *editor,
+    const LookDisplayControl &lookDisplay)
+{
+    this->ClearEditor();
+
+    this->editor_ = editor;
+    this->GetSizer()->Add(editor, 0, wxEXPAND | wxLEFT | wxBOTTOM, 16);
+
+    this->lookDisplayEndpoint_ = std::make_unique<LookDisplayEndpoint>(
+        this,
+        lookDisplay,
+        &ShapeListRow::OnLookDisplay_);
+
+    this->Layout();
+}
+
+
+void ShapeListRow::ClearEditor()
+{
+    this->lookDisplayEndpoint_.reset();
+
+    if (this->editor_)
+    {
+        this->GetSizer()->Detach(this->editor_);
+        this->editor_->Destroy();
+        this->editor_ = nullptr;
+    }
+
+    this->Layout();
+}
+
+
+bool ShapeListRow::HasEditor() const
+{
+    return this->editor_ != nullptr;
+}
+
+
+int ShapeListRow::MeasureHeight()
+{
+    // The best size is cached, and the editor may have grown since.
+    this->InvalidateBestSize();
+
+    return this->GetBestSize().GetHeight();
+}
+
+
+void ShapeListRow::OnLookDisplay_(const LookDisplay &)
+{
+    this->onEditorResize_(this->index_);
+}
+
+
+void ShapeListRow::OnPaneChanged_(wxCommandEvent &event)
+{
+    event.Skip();
+    this->onEditorResize_(this->index_);
+}
+
+
+} // end namespace detail
+
+
+VirtualShapeListView::VirtualShapeListView(
+    wxWindow *parent,
+    const Control &control)
+    :
+    wxScrolled<wxPanel>(parent, wxID_ANY),
+    control_(control),
+
+    countEndpoint_(
+        this,
+        control.shapes.count,
+        &VirtualShapeListView::OnCount_),
+
+    memberAddedEndpoint_(
+        this,
+        control.shapes.memberAdded,
+        &VirtualShapeListView::OnMemberAdded_),
+
+    memberRemovedEndpoint_(
+        this,
+        control.shapes.memberRemoved,
+        &VirtualShapeListView::OnMemberRemoved_),
+
+    indicesEndpoint_(
+        this,
+        control.shapes.indices,
+        &VirtualShapeListView::OnIndices_),
+
+    isBatchingEndpoint_(
+        this,
+        control.isBatching,
+        &VirtualShapeListView::OnIsBatching_),
+
+    collapsedHeight_(0),
+    order_(),
+    positions_(),
+    tops_(),
+    expandedHeights_(),
+    visible_(),
+    pool_(),
+    isUpdatePending_(false),
+    needsRelayout_(false)
+{
+    // Every collapsed row has the height of the first one.
+    auto sample = this->AcquireRow_();
+    sample->Assign(0, "Shape (0)", false);
+    this->collapsedHeight_ = sample->GetBestSize().GetHeight();
+    sample->Hide();
+    this->pool_.push_back(sample);
+
+    this->SetScrollRate(0, std::max(1, this->collapsedHeight_ / 4));
+
+    this->Bind(wxEVT_SCROLLWIN_TOP, &VirtualShapeListView::OnScroll_, this);
+
+    this->Bind(
+        wxEVT_SCROLLWIN_BOTTOM,
+        &VirtualShapeListView::OnScroll_,
+        this);
+
+    this->Bind(
+        wxEVT_SCROLLWIN_LINEUP,
+        &VirtualShapeListView::OnScroll_,
+        this);
+
+    this->Bind(
+        wxEVT_SCROLLWIN_LINEDOWN,
+        &VirtualShapeListView::OnScroll_,
+        this);
+
+    this->Bind(
+        wxEVT_SCROLLWIN_PAGEUP,
+        &VirtualShapeListView::OnScroll_,
+        this);
+
+    this->Bind(
+        wxEVT_SCROLLWIN_PAGEDOWN,
+        &VirtualShapeListView::OnScroll_,
+        this);
+
+    this->Bind(
+        wxEVT_SCROLLWIN_THUMBTRACK,
+        &VirtualShapeListView::OnScroll_,
+        this);
+
+    this->Bind(
+        wxEVT_SCROLLWIN_THUMBRELEASE,
+        &VirtualShapeListView::OnScroll_,
+        this);
+
+    this->Bind(wxEVT_MOUSEWHEEL, &VirtualShapeListView::OnMouseWheel_, this);
+    this->Bind(wxEVT_SIZE, &VirtualShapeListView::OnSize_, this);
+
+    this->Relayout_();
+}
+
+
+void VirtualShapeListView::OnScroll_(wxScrollWinEvent &event)
+{
+    // Let wxScrolled move the view first.
+    event.Skip();
+    this->RequestUpdate_();
+}
+
+
+void VirtualShapeListView::OnMouseWheel_(wxMouseEvent &event)
+{
+    event.Skip();
+    this->RequestUpdate_();
+}
+
+
+void VirtualShapeListView::OnSize_(wxSizeEvent &event)
+{
+    event.Skip();
+    this->needsRelayout_ = true;
+    this->RequestUpdate_();
+}
+
+
+void VirtualShapeListView::OnCount_(size_t count)
+{
+    // The list may be cleared without removing each member.
+    this->ReleaseFrom_(count);
+
+    this->expandedHeights_.erase(
+        this->expandedHeights_.lower_bound(count),
+        this->expandedHeights_.end());
+
+    this->RequestRelayout_();
+}
+
+
+void VirtualShapeListView::OnMemberAdded_(
+    const std::optional<size_t> &unordered)
+{
+    if (!unordered)
+    {
+        return;
+    }
+
+    // The shapes after the new one have moved up in storage.
+    this->ReleaseFrom_(*unordered);
+
+    std::map<size_t, int> heights;
+
+    for (auto [index, height]: this->expandedHeights_)
+    {
+        heights.emplace((index < *unordered) ? index : index + 1, height);
+    }
+
+    this->expandedHeights_ = std::move(heights);
+    this->RequestRelayout_();
+}
+
+
+void VirtualShapeListView::OnMemberRemoved_(
+    const std::optional<size_t> &unordered)
+{
+    if (!unordered)
+    {
+        return;
+    }
+
+    // The shapes after the removed one have moved down in storage.
+    this->ReleaseFrom_(*unordered);
+
+    std::map<size_t, int> heights;
+
+    for (auto [index, height]: this->expandedHeights_)
+    {
+        if (index != *unordered)
+        {
+            heights.emplace((index < *unordered) ? index : index - 1, height);
+        }
+    }
+
+    this->expandedHeights_ = std::move(heights);
+    this->RequestRelayout_();
+}
+
+
+void VirtualShapeListView::OnIndices_(const std::vector<size_t> &)
+{
+    // The shapes have been reordered, so the rows move with them.
+    this->RequestRelayout_();
+}
+
+
+void VirtualShapeListView::OnIsBatching_(bool isBatching)
+{
+    if (!isBatching)
+    {
+        this->RequestRelayout_();
+    }
+}
+
+
+void VirtualShapeListView::ReleaseFrom_(size_t unordered)
+{
+    while (true)
+    {
+        auto found = this->visible_.lower_bound(unordered);
+
+        if (found == this->visible_.end())
+        {
+            return;
+        }
+
+        this->ReleaseRow_(found->first);
+    }
+}
+
+
+void VirtualShapeListView::RequestRelayout_()
+{
+    this->needsRelayout_ = true;
+
+    if (this->control_.isBatching.Get())
+    {
+        // Lay out once when the batch closes.
+        return;
+    }
+
+    this->RequestUpdate_();
+}
+
+
+void VirtualShapeListView::OnToggleExpand_(size_t unordered)
+{
+    if (unordered >= this->control_.shapesDisplay.count.Get())
+    {
+        return;
+    }
+
+    auto &shapeExpand =
+        pex::GetUnordered(this->control_.shapesDisplay, unordered)
+            .shapeExpand;
+
+    shapeExpand.Set(!shapeExpand.Get());
+
+    // The row is rebuilt with or without its editor.
+    this->ReleaseRow_(unordered);
+    this->RequestRelayout_();
+}
+
+
+void VirtualShapeListView::OnEditorResize_(size_t unordered)
+{
+    // The section has not been laid out yet, so measure after it has.
+    this->CallAfter(
+        [this, unordered]()
+        {
+            auto found = this->visible_.find(unordered);
+
+            if (found == this->visible_.end() || !found->second->HasEditor())
+            {
+                // The row was released or collapsed in the meantime.
+                return;
+            }
+
+            if (this->MeasureRow_(found->second, unordered))
+            {
+                this->RequestRelayout_();
+            }
+        });
+}
+
+
+bool VirtualShapeListView::MeasureRow_(
+    detail::ShapeListRow *row,
+    size_t unordered)
+{
+    auto height = row->MeasureHeight();
+    auto &expandedHeight = this->expandedHeights_[unordered];
+
+    if (expandedHeight == height)
+    {
+        return false;
+    }
+
+    expandedHeight = height;
+
+    return true;
+}
+
+
+void VirtualShapeListView::RequestUpdate_()
+{
+    if (this->isUpdatePending_)
+    {
+        return;
+    }
+
+    // Coalesce the events of one scroll or resize into a single update.
+    this->isUpdatePending_ = true;
+    this->CallAfter(&VirtualShapeListView::OnUpdate_);
+}
+
+
+void VirtualShapeListView::OnUpdate_()
+{
+    this->isUpdatePending_ = false;
+
+    if (this->needsRelayout_)
+    {
+        this->Relayout_();
+    }
+    else
+    {
+        this->UpdateRows_();
+    }
+}
+
+
+void VirtualShapeListView::Relayout_()
+{
+    this->needsRelayout_ = false;
+
+    auto count = this->control_.shapes.count.Get();
+    this->order_ = this->control_.shapes.indices.Get();
+
+    if (this->order_.size() != count)
+    {
+        // The indices have not caught up with the count.
+        this->order_.resize(count);
+        std::iota(this->order_.begin(), this->order_.end(), size_t{0});
+    }
+
+    this->positions_.resize(count);
+    this->tops_.resize(count + 1);
+
+    int top = 0;
+
+    for (size_t position = 0; position < count; ++position)
+    {
+        auto unordered = this->order_[position];
+        this->positions_[unordered] = position;
+        this->tops_[position] = top;
+        top += this->GetRowHeight_(unordered);
+    }
+
+    this->tops_[count] = top;
+
+    this->SetVirtualSize(this->GetClientSize().GetWidth(), top);
+    this->UpdateRows_();
+}
+
+
+void VirtualShapeListView::UpdateRows_()
+{
+    auto count = this->tops_.size() - 1;
+
+    int pixelsPerUnit = 1;
+    int viewTop = 0;
+    this->GetScrollPixelsPerUnit(nullptr, &pixelsPerUnit);
+    this->GetViewStart(nullptr, &viewTop);
+    viewTop *= pixelsPerUnit;
+
+    int viewBottom = viewTop + this->GetClientSize().GetHeight();
+
+    auto rowsEnd = std::prev(this->tops_.end());
+
+    // The first row that ends below the top of the view.
+    auto first = static_cast<size_t>(
+        std::distance(
+            this->tops_.begin(),
+            std::upper_bound(this->tops_.begin(), rowsEnd, viewTop)));
+
+    first = (first > 0) ? first - 1 : 0;
+
+    // The first row that begins below the bottom of the view.
+    auto last = static_cast<size_t>(
+        std::distance(
+            this->tops_.begin(),
+            std::lower_bound(this->tops_.begin(), rowsEnd, viewBottom)));
+
+    auto begin = (first > overscanRows) ? first - overscanRows : 0;
+    auto end = std::min(count, last + overscanRows);
+
+    for (auto it = this->visible_.begin(); it != this->visible_.end();)
+    {
+        auto unordered = (it++)->first;
+
+        if (unordered >= count)
+        {
+            this->ReleaseRow_(unordered);
+
+            continue;
+        }
+
+        auto position = this->positions_[unordered];
+
+        if (position < begin || position >= end)
+        {
+            this->ReleaseRow_(unordered);
+        }
+    }
+
+    for (size_t position = begin; position < end; ++position)
+    {
+        this->ShowRow_(position);
+    }
+
+    if (this->needsRelayout_)
+    {
+        // An editor was measured for the first time.
+        this->RequestUpdate_();
+    }
+}
+
+
+bool VirtualShapeListView::IsExpanded_(size_t unordered)
+{
+    // The displays catch up with the shapes after notifications settle.
+    if (unordered >= this->control_.shapesDisplay.count.Get())
+    {
+        return false;
+    }
+
+    return pex::GetUnordered(this->control_.shapesDisplay, unordered)
+        .shapeExpand.Get();
+}
+
+
+int VirtualShapeListView::GetRowHeight_(size_t unordered)
+{
+    if (!this->IsExpanded_(unordered))
+    {
+        return this->collapsedHeight_;
+    }
+
+    auto found = this->expandedHeights_.find(unordered);
+
+    if (found != this->expandedHeights_.end())
+    {
+        return found->second;
+    }
+
+    // Until the editor has been created and measured.
+    return 8 * this->collapsedHeight_;
+}
+
+
+detail::ShapeListRow * VirtualShapeListView::AcquireRow_()
+{
+    if (!this->pool_.empty())
+    {
+        auto row = this->pool_.back();
+        this->pool_.pop_back();
+
+        return row;
+    }
+
+    auto row = new detail::ShapeListRow(
+        this,
+        [this](size_t index)
+        {
+            this->OnEditorResize_(index);
+        });
+
+    row->GetExpandButton()->Bind(
+        wxEVT_BUTTON,
+        [this, row](wxCommandEvent &)
+        {
+            this->OnToggleExpand_(row->GetIndex());
+        });
+
+    return row;
+}
+
+
+void VirtualShapeListView::ReleaseRow_(size_t unordered)
+{
+    auto found = this->visible_.find(unordered);
+
+    if (found == this->visible_.end())
+    {
+        return;
+    }
+
+    auto row = found->second;
+    this->visible_.erase(found);
+
+    // Expanded editors are not kept for rows out of view.
+    row->ClearEditor();
+    row->Hide();
+    this->pool_.push_back(row);
+}
+
+
+void VirtualShapeListView::ShowRow_(size_t position)
+{
+    auto unordered = this->order_[position];
+    auto found = this->visible_.find(unordered);
+    detail::ShapeListRow *row = nullptr;
+
+    if (found != this->visible_.end())
+    {
+        row = found->second;
+    }
+    else
+    {
+        auto shape =
+            pex::GetUnordered(this->control_.shapes, unordered).GetVirtual();
+
+        if (!shape)
+        {
+            // This shape has not finished initializing.
+            return;
+        }
+
+        bool isExpanded = this->IsExpanded_(unordered);
+
+        row = this->AcquireRow_();
+
+        row->Assign(
+            unordered,
+            fmt::format("{} ({})", shape->GetName(), shape->GetId()),
+            isExpanded);
+
+        this->visible_[unordered] = row;
+
+        if (isExpanded)
+        {
+            auto &display =
+                pex::GetUnordered(this->control_.shapesDisplay, unordered);
+
+            row->SetEditor(
+                this->CreateEditor_(row, unordered),
+                display.lookExpand);
+
+            if (this->MeasureRow_(row, unordered))
+            {
+                this->needsRelayout_ = true;
+            }
+        }
+    }
+
+    int y = 0;
+    this->CalcScrolledPosition(0, this->tops_[position], nullptr, &y);
+
+    row->SetSize(
+        0,
+        y,
+        this->GetClientSize().GetWidth(),
+        this->GetRowHeight_(unordered));
+
+    row->Show();
+}
+
+
+wxWindow * VirtualShapeListView::CreateEditor_(
+    detail::ShapeListRow *row,
+    size_t unordered)
+{
+    auto shape =
+        pex::GetUnordered(this->control_.shapes, unordered).GetVirtual();
+
+    auto editor = new wxPanel(row, wxID_ANY);
+
+    auto shapeView = shape->CreateShapeView(editor);
+
+    auto lookView = shape->CreateLookView(
+        editor,
+        pex::GetUnordered(this->control_.shapesDisplay, unordered)
+            .lookExpand);
+
+    auto orderView = new OrderView(editor, shape->GetOrder());
+
+    auto sizer = new wxBoxSizer(wxVERTICAL);
+    sizer->Add(shapeView, 0, wxEXPAND);
+    sizer->Add(lookView, 0, wxEXPAND | wxTOP, 5);
+    sizer->Add(orderView, 0, wxTOP, 5);
+    editor->SetSizerAndFit(sizer);
+
+    return editor;
+}
+
+
+} // end namespace draw
@@ -0,0 +1,209 @@
+#pragma once
+
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <pex/endpoint.h>
+#include <wxpex/ignores.h>
+
+WXSHIM_PUSH_IGNORES
+#include <wx/scrolwin.h>
+#include <wx/stattext.h>
+#include <wx/button.h>
+WXSHIM_POP_IGNORES
+
+#include "draw/shape_list.h"
+#include "draw/views/look_view.h"
+
+
+namespace draw
+{
+
+
+namespace detail
+{
+
+
+// One row of a VirtualShapeListView, reused for whichever shape is shown.
+class ShapeListRow: public wxPanel
+{
+public:
+    // Called with the unordered index of the shape when a section of its
+    // editor expands or collapses.
+    using OnEditorResize = std::function<void(size_t unordered)>;
+
+    ShapeListRow(wxWindow *parent, OnEditorResize onEditorResize);
+
+    void Assign(size_t unordered, const std::string &label, bool isExpanded);
+
+    // The unordered index of the shape in the list.
+    size_t GetIndex() const;
+
+    wxButton * GetExpandButton();
+
+    // Replaces the editor below the header, and watches the sections of the
+    // shape's look as they expand and collapse.
+    void SetEditor(wxWindow *editor, const LookDisplayControl &lookDisplay);
+
+    void ClearEditor();
+
+    bool HasEditor() const;
+
+    // The height of the row with its editor as it is now laid out.
+    int MeasureHeight();
+
+private:
+    using LookDisplay = typename LookDisplayGroup::Plain;
+
+    void OnLookDisplay_(const LookDisplay &);
+
+    void OnPaneChanged_(wxCommandEvent &event);
+
+private:
+    using LookDisplayEndpoint =
+        pex::EndpointGroup<ShapeListRow, LookDisplayControl>;
+
+    size_t index_;
+    wxButton *expand_;
+    wxStaticText *label_;
+    wxWindow *editor_;
+    OnEditorResize onEditorResize_;
+    std::unique_ptr<LookDisplayEndpoint> lookDisplayEndpoint_;
+};
+
+
+} // end namespace detail
+
+
+/**
+ ** A shape list that creates widgets only for the rows in view.
+ **
+ ** Collapsed rows show the name and id of the shape. Rows are drawn from a
+ ** small pool and reassigned as the list scrolls. The editors of expanded
+ ** rows are created when they scroll into view and destroyed when they
+ ** scroll out of it. Whether a row is expanded is kept in shapesDisplay.
+ ** Expanded rows are measured again when sections of their editors expand
+ ** or collapse.
+ **
+ ** Rows are shown in the order of the list's indices, and move when the
+ ** shapes are reordered. Rows and measured heights are kept by the unordered
+ ** index of their shapes, so adding or removing a shape only releases the
+ ** rows of the shapes that moved in storage.
+ **/
+class VirtualShapeListView: public wxScrolled<wxPanel>
+{
+public:
+    static constexpr auto observerName = "VirtualShapeListView";
+
+    using Control = ShapeListControl;
+
+    // Rows kept beyond the edges of the view, to hide creation while
+    // scrolling.
+    static constexpr size_t overscanRows = 4;
+
+    VirtualShapeListView(wxWindow *parent, const Control &control);
+
+private:
+    void OnScroll_(wxScrollWinEvent &event);
+
+    void OnMouseWheel_(wxMouseEvent &event);
+
+    void OnSize_(wxSizeEvent &event);
+
+    void OnCount_(size_t count);
+
+    void OnMemberAdded_(const std::optional<size_t> &unordered);
+
+    void OnMemberRemoved_(const std::optional<size_t> &unordered);
+
+    void OnIndices_(const std::vector<size_t> &);
+
+    void OnIsBatching_(bool isBatching);
+
+    // Release the rows of the shapes at and after unordered, which have
+    // moved in storage.
+    void ReleaseFrom_(size_t unordered);
+
+    void RequestRelayout_();
+
+    void OnToggleExpand_(size_t unordered);
+
+    // Measure an expanded row again once its editor has been laid out.
+    void OnEditorResize_(size_t unordered);
+
+    // @return true when the height of the expanded row has changed.
+    bool MeasureRow_(detail::ShapeListRow *row, size_t unordered);
+
+    void RequestUpdate_();
+
+    void OnUpdate_();
+
+    // Recompute the position of every row after the list has changed.
+    void Relayout_();
+
+    // Show the rows that are in view, and recycle the rest.
+    void UpdateRows_();
+
+    bool IsExpanded_(size_t unordered);
+
+    int GetRowHeight_(size_t unordered);
+
+    detail::ShapeListRow * AcquireRow_();
+
+    void ReleaseRow_(size_t unordered);
+
+    void ShowRow_(size_t position);
+
+    wxWindow * CreateEditor_(detail::ShapeListRow *row, size_t unordered);
+
+private:
+    Control control_;
+
+    using CountEndpoint =
+        pex::Endpoint<VirtualShapeListView, decltype(ShapesControl::count)>;
+
+    using IndexEndpoint =
+        pex::Endpoint<VirtualShapeListView, pex::control::ListOptionalIndex>;
+
+    using IndicesEndpoint =
+        pex::Endpoint<VirtualShapeListView, decltype(ShapesControl::indices)>;
+
+    using IsBatchingEndpoint =
+        pex::Endpoint<VirtualShapeListView, IsBatchingControl>;
+
+    CountEndpoint countEndpoint_;
+    IndexEndpoint memberAddedEndpoint_;
+    IndexEndpoint memberRemovedEndpoint_;
+    IndicesEndpoint indicesEndpoint_;
+    IsBatchingEndpoint isBatchingEndpoint_;
+
+    int collapsedHeight_;
+
+    // The unordered index of the shape in each row, in display order.
+    std::vector<size_t> order_;
+
+    // The row of each unordered index.
+    std::vector<size_t> positions_;
+
+    // The top of each row, with the total height at the end.
+    std::vector<int> tops_;
+
+    // Measured heights of expanded rows, by unordered index.
+    std::map<size_t, int> expandedHeights_;
+
+    // Rows in use, by unordered index.
+    std::map<size_t, detail::ShapeListRow *> visible_;
+    std::vector<detail::ShapeListRow *> pool_;
+
+    bool isUpdatePending_;
+    bool needsRelayout_;
+};
+
+
+} // end namespace draw
@@ -0,0 +1,200 @@
+#include "draw/warp.h"
+
+#include "draw/error.h"
+#include "draw/detail/cpu.h"
+#include "draw/trace.h"
+
+
+namespace draw
+{
+
+
+Homography MakeHomography(const QuadMatrix &from, const QuadMatrix &to)
+{
+    // With the last element fixed at 1, each pair of corners gives two
+    // equations in the remaining eight.
+    Eigen::Matrix<double, 8, 8> equations;
+    Eigen::Matrix<double, 8, 1> targets;
+
+    for (Eigen::Index i = 0; i < 4; ++i)
+    {
+        auto x = from(0, i) / from(2, i);
+        auto y = from(1, i) / from(2, i);
+        auto u = to(0, i) / to(2, i);
+        auto v = to(1, i) / to(2, i);
+
+        equations.row(2 * i) << x, y, 1.0, 0.0, 0.0, 0.0, -x * u, -y * u;
+        equations.row(2 * i + 1) << 0.0, 0.0, 0.0, x, y, 1.0, -x * v, -y * v;
+
+        targets(2 * i) = u;
+        targets(2 * i + 1) = v;
+    }
+
+    auto decomposition = equations.fullPivLu();
+
+    if (!decomposition.isInvertible())
+    {
+        throw DrawError("Three or more quad corners are collinear");
+    }
+
+    Eigen::Matrix<double, 8, 1> solution = decomposition.solve(targets);
+
+    Homography result;
+
+    result <<
+        solution(0), solution(1), solution(2),
+        solution(3), solution(4), solution(5),
+        solution(6), solution(7), 1.0;
+
+    return result;
+}
+
+
+Homography MakeRectifyingHomography(const Quad &quad, const Size &outputSize)
+{
+    auto width = static_cast<double>(outputSize.width);
+    auto height = static_cast<double>(outputSize.height);
+
+    auto output = PointsToMatrix(
+        QuadPoint(0.0, 0.0),
+        QuadPoint(width, 0.0),
+        QuadPoint(width, height),
+        QuadPoint(0.0, height));
+
+    return MakeHomography(output, PointsToMatrix(quad.GetPoints()));
+}
+
+
+namespace detail
+{
+
+
+#ifdef DRAW_X86_TARGETS
+
+// Eight pixels at a time, from the first pixel that is a multiple of eight.
+__attribute__((target("avx2")))
+Eigen::Index ProjectRowAvx2(
+    const float *start,
+    const float *step,
+    Eigen::Index width,
+    float *x,
+    float *y)
+{
+    auto startU = _mm256_set1_ps(start[0]);
+    auto startV = _mm256_set1_ps(start[1]);
+    auto startW = _mm256_set1_ps(start[2]);
+    auto stepU = _mm256_set1_ps(step[0]);
+    auto stepV = _mm256_set1_ps(step[1]);
+    auto stepW = _mm256_set1_ps(step[2]);
+
+    // The column of each lane advances by eight, and is exact as a float.
+    auto column = _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7);
+    auto eight = _mm256_set1_ps(8.0f);
+
+    Eigen::Index i = 0;
+
+    for (; i + 8 <= width; i += 8)
+    {
+        auto u = _mm256_add_ps(startU, _mm256_mul_ps(column, stepU));
+        auto v = _mm256_add_ps(startV, _mm256_mul_ps(column, stepV));
+        auto w = _mm256_add_ps(startW, _mm256_mul_ps(column, stepW));
+
+        _mm256_storeu_ps(x + i, _mm256_div_ps(u, w));
+        _mm256_storeu_ps(y + i, _mm256_div_ps(v, w));
+
+        column = _mm256_add_ps(column, eight);
+    }
+
+    return i;
+}
+
+#endif
+
+
+void ProjectRow(
+    const Homography &homography,
+    Eigen::Index row,
+    Eigen::Index width,
+    float *x,
+    float *y)
+{
+    // Homogeneous coordinates of the first pixel center, and the change from
+    // one pixel to the next. The start is found in double precision, so
+    // rows far from the origin keep their accuracy.
+    Eigen::Vector3d first =
+        homography * Eigen::Vector3d(0.5, static_cast<double>(row) + 0.5, 1.0);
+
+    float start[3] = {
+        static_cast<float>(first(0)),
+        static_cast<float>(first(1)),
+        static_cast<float>(first(2))};
+
+    float step[3] = {
+        static_cast<float>(homography(0, 0)),
+        static_cast<float>(homography(1, 0)),
+        static_cast<float>(homography(2, 0))};
+
+    Eigen::Index i = 0;
+
+#ifdef DRAW_X86_TARGETS
+    if (HasAvx2())
+    {
+        i = ProjectRowAvx2(start, step, width, x, y);
+    }
+#endif
+
+    for (; i < width; ++i)
+    {
+        auto column = static_cast<float>(i);
+        auto w = start[2] + column * step[2];
+
+        x[i] = (start[0] + column * step[0]) / w;
+        y[i] = (start[1] + column * step[1]) / w;
+    }
+}
+
+
+} // end namespace detail
+
+
+std::shared_ptr<Pixels> Warp(
+    const Pixels &source,
+    const Homography &homography,
+    const Size &outputSize,
+    Interpolation interpolation)
+{
+    DRAW_TRACE_SCOPE("warp.pixels");
+
+    static_assert(
+        Pixels::Data::IsRowMajor,
+        "Expected interleaved color channels");
+
+    auto result = Pixels::CreateShared(outputSize);
+
+    if (source.data.size() == 0)
+    {
+        result->data.setZero();
+
+        return result;
+    }
+
+    const uint8_t *input = source.data.data();
+    uint8_t *output = result->data.data();
+
+    detail::Warp(
+        detail::WarpPlanes<uint8_t, 3>{
+            {input, input + 1, input + 2},
+            {output, output + 1, output + 2},
+            3,
+            static_cast<Eigen::Index>(source.size.width),
+            static_cast<Eigen::Index>(source.size.height),
+            static_cast<Eigen::Index>(outputSize.width),
+            static_cast<Eigen::Index>(outputSize.height)},
+        homography,
+        interpolation);
+
+    return result;
+}
+
+
+} // end namespace draw
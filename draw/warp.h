@@ -0,0 +1,339 @@
+#pragma once
+
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include <tau/eigen.h>
+#include "draw/gray.h"
+#include "draw/planar.h"
+#include "draw/pixels.h"
+#include "draw/quad.h"
+#include "draw/size.h"
+#include "draw/detail/parallel.h"
+
+
+/**
+ ** Perspective resampling of images through the corners of a Quad.
+ **
+ ** A homography maps each output pixel to a point in the source image.
+ **
+ **     // Rectify the region under a quad into a 640 x 480 image.
+ **     auto rectified = draw::Rectify(frame, quad, draw::Size(640, 480));
+ **
+ ** Pixels that map outside of the source are black.
+ **/
+
+
+namespace draw
+{
+
+
+enum class Interpolation
+{
+    nearest,
+    bilinear
+};
+
+
+// Maps homogeneous output coordinates to source coordinates.
+using Homography = Eigen::Matrix<double, 3, 3>;
+
+
+/**
+ ** The homography that maps each corner of `from` to the matching corner of
+ ** `to`.
+ **
+ ** Corners are ordered top left, top right, bottom right, bottom left, as in
+ ** PointsToMatrix.
+ **/
+Homography MakeHomography(const QuadMatrix &from, const QuadMatrix &to);
+
+
+// Maps a rectangle of outputSize onto the corners of the quad.
+Homography MakeRectifyingHomography(const Quad &quad, const Size &outputSize);
+
+
+namespace detail
+{
+
+
+/**
+ ** The source coordinates of the centers of one row of output pixels.
+ **
+ ** Coordinates are in pixels, with 0.0 at the left or top edge of the source.
+ **/
+void ProjectRow(
+    const Homography &homography,
+    Eigen::Index row,
+    Eigen::Index width,
+    float *x,
+    float *y);
+
+
+// Fewer output rows than this are warped on the calling thread.
+static constexpr Eigen::Index minimumWarpBand = 16;
+
+
+/**
+ ** Channels are read from sources[c] and written to targets[c], with
+ ** pixelStride values between horizontally adjacent pixels.
+ **/
+template<typename Pixel, size_t channelCount>
+struct WarpPlanes
+{
+    std::array<const Pixel *, channelCount> sources;
+    std::array<Pixel *, channelCount> targets;
+    Eigen::Index pixelStride;
+    Eigen::Index sourceWidth;
+    Eigen::Index sourceHeight;
+    Eigen::Index targetWidth;
+    Eigen::Index targetHeight;
+};
+
+
+template<typename Pixel>
+Pixel RoundSample(float value)
+{
+    if constexpr (std::is_integral_v<Pixel>)
+    {
+        return static_cast<Pixel>(value + 0.5f);
+    }
+    else
+    {
+        return static_cast<Pixel>(value);
+    }
+}
+
+
+template<typename Pixel, size_t channelCount>
+void WarpRows(
+    const WarpPlanes<Pixel, channelCount> &planes,
+    const Homography &homography,
+    Interpolation interpolation,
+    Eigen::Index beginRow,
+    Eigen::Index endRow)
+{
+    auto width = planes.targetWidth;
+    auto stride = planes.pixelStride;
+    auto sourceRowStride = planes.sourceWidth * stride;
+    auto sourceWidth = static_cast<float>(planes.sourceWidth);
+    auto sourceHeight = static_cast<float>(planes.sourceHeight);
+    auto lastColumn = planes.sourceWidth - 1;
+    auto lastRow = planes.sourceHeight - 1;
+
+    std::vector<float> xs(static_cast<size_t>(width));
+    std::vector<float> ys(static_cast<size_t>(width));
+
+    for (Eigen::Index row = beginRow; row < endRow; ++row)
+    {
+        ProjectRow(homography, row, width, xs.data(), ys.data());
+
+        auto targetOffset = row * width * stride;
+
+        for (Eigen::Index column = 0; column < width; ++column)
+        {
+            auto target = targetOffset + column * stride;
+            auto x = xs[static_cast<size_t>(column)];
+            auto y = ys[static_cast<size_t>(column)];
+
+            // Also rejects NaN, from points behind the horizon.
+            bool isInside = x >= 0.0f && x < sourceWidth
+                && y >= 0.0f && y < sourceHeight;
+
+            if (!isInside)
+            {
+                for (size_t c = 0; c < channelCount; ++c)
+                {
+                    planes.targets[c][target] = Pixel{};
+                }
+
+                continue;
+            }
+
+            if (interpolation == Interpolation::nearest)
+            {
+                auto source = static_cast<Eigen::Index>(y) * sourceRowStride
+                    + static_cast<Eigen::Index>(x) * stride;
+
+                for (size_t c = 0; c < channelCount; ++c)
+                {
+                    planes.targets[c][target] = planes.sources[c][source];
+                }
+
+                continue;
+            }
+
+            // Sample between the centers of the source pixels.
+            auto sampleX = std::max(x - 0.5f, 0.0f);
+            auto sampleY = std::max(y - 0.5f, 0.0f);
+
+            auto left =
+                std::min(static_cast<Eigen::Index>(sampleX), lastColumn);
+
+            auto top = std::min(static_cast<Eigen::Index>(sampleY), lastRow);
+            auto right = std::min(left + 1, lastColumn);
+            auto bottom = std::min(top + 1, lastRow);
+
+            auto fractionX = sampleX - static_cast<float>(left);
+            auto fractionY = sampleY - static_cast<float>(top);
+
+            auto topLeft = top * sourceRowStride + left * stride;
+            auto topRight = top * sourceRowStride + right * stride;
+            auto bottomLeft = bottom * sourceRowStride + left * stride;
+            auto bottomRight = bottom * sourceRowStride + right * stride;
+
+            for (size_t c = 0; c < channelCount; ++c)
+            {
+                auto source = planes.sources[c];
+
+                auto upper = static_cast<float>(source[topLeft])
+                    + fractionX * (
+                        static_cast<float>(source[topRight])
+                        - static_cast<float>(source[topLeft]));
+
+                auto lower = static_cast<float>(source[bottomLeft])
+                    + fractionX * (
+                        static_cast<float>(source[bottomRight])
+                        - static_cast<float>(source[bottomLeft]));
+
+                planes.targets[c][target] =
+                    RoundSample<Pixel>(upper + fractionY * (lower - upper));
+            }
+        }
+    }
+}
+
+
+template<typename Pixel, size_t channelCount>
+void Warp(
+    const WarpPlanes<Pixel, channelCount> &planes,
+    const Homography &homography,
+    Interpolation interpolation)
+{
+    if (planes.targetWidth <= 0 || planes.targetHeight <= 0)
+    {
+        return;
+    }
+
+    detail::ParallelBands(
+        planes.targetHeight,
+        minimumWarpBand,
+        [&](Eigen::Index beginRow, Eigen::Index endRow)
+        {
+            WarpRows(planes, homography, interpolation, beginRow, endRow);
+        });
+}
+
+
+} // end namespace detail
+
+
+template<typename Pixel>
+Gray<Pixel> Warp(
+    const Gray<Pixel> &source,
+    const Homography &homography,
+    const Size &outputSize,
+    Interpolation interpolation = Interpolation::bilinear)
+{
+    Gray<Pixel> result(outputSize.height, outputSize.width);
+
+    if (source.size() == 0)
+    {
+        result.setZero();
+
+        return result;
+    }
+
+    detail::Warp(
+        detail::WarpPlanes<Pixel, 1>{
+            {source.data()},
+            {result.data()},
+            1,
+            source.cols(),
+            source.rows(),
+            result.cols(),
+            result.rows()},
+        homography,
+        interpolation);
+
+    return result;
+}
+
+
+template<typename Pixel>
+PlanarRgb<Pixel> Warp(
+    const PlanarRgb<Pixel> &source,
+    const Homography &homography,
+    const Size &outputSize,
+    Interpolation interpolation = Interpolation::bilinear)
+{
+    PlanarRgb<Pixel> result;
+
+    auto &red = tau::GetRed(result);
+    auto &green = tau::GetGreen(result);
+    auto &blue = tau::GetBlue(result);
+
+    red.setZero(outputSize.height, outputSize.width);
+    green.setZero(outputSize.height, outputSize.width);
+    blue.setZero(outputSize.height, outputSize.width);
+
+    const auto &sourceRed = tau::GetRed(source);
+
+    if (sourceRed.size() == 0)
+    {
+        return result;
+    }
+
+    // The three planes share one projection of each row.
+    detail::Warp(
+        detail::WarpPlanes<Pixel, 3>{
+            {
+                sourceRed.data(),
+                tau::GetGreen(source).data(),
+                tau::GetBlue(source).data()},
+            {red.data(), green.data(), blue.data()},
+            1,
+            sourceRed.cols(),
+            sourceRed.rows(),
+            red.cols(),
+            red.rows()},
+        homography,
+        interpolation);
+
+    return result;
+}
+
+
+std::shared_ptr<Pixels> Warp(
+    const Pixels &source,
+    const Homography &homography,
+    const Size &outputSize,
+    Interpolation interpolation = Interpolation::bilinear);
+
+
+/**
+ ** Resample the region under the quad into an image of outputSize.
+ **
+ ** The top left corner of the quad becomes the top left of the result.
+ **/
+template<typename Image>
+auto Rectify(
+    const Image &source,
+    const Quad &quad,
+    const Size &outputSize,
+    Interpolation interpolation = Interpolation::bilinear)
+{
+    return Warp(
+        source,
+        MakeRectifyingHomography(quad, outputSize),
+        outputSize,
+        interpolation);
+}
+
+
+} // end namespace draw
@@ -10,6 +10,8 @@ Waveform Resize(
     const Size &displaySize,
     double verticalScale)
 {
+    DRAW_TRACE_SCOPE("waveform.resize");
+
     Waveform result = Waveform::Zero(displaySize.height, displaySize.width);
 
     double widthFactor = static_cast<double>(result.cols())
@@ -3,6 +3,7 @@
 
 #include <tau/eigen.h>
 #include "draw/waveform_settings.h"
+#include "draw/trace.h"
 
 
 namespace draw
@@ -37,6 +38,8 @@ Waveform DoGenerateWaveform(
     size_t levelCount,
     size_t columnCount)
 {
+    DRAW_TRACE_SCOPE("waveform.histogram");
+
     auto maximum = tau::Index(levelCount) - 1;
 
     auto columnDivisor = static_cast<float>(data.cols() - 1)
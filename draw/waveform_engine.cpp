@@ -0,0 +1,267 @@
+#include "draw/waveform_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+
+#include <tau/stack.h>
+#include "draw/trace.h"
+
+
+namespace draw
+{
+
+
+PixelMatrix MakeWaveformColorRange(
+    const WaveformColor &waveformColor,
+    const tau::Hsv<double> &hsv)
+{
+    auto first = hsv;
+    auto last = hsv;
+
+    first.value = waveformColor.range.low;
+    last.value = waveformColor.range.high;
+
+    auto gradient = tau::gradient::MakeColormap<uint8_t>(
+        waveformColor.count,
+        first.ToVector(),
+        last.ToVector());
+
+    // Zero will be black
+    gradient.row(0) = tau::RowVector<3, uint8_t>(0, 0, 0);
+
+    return gradient;
+}
+
+
+PixelMatrix MakeWaveformColors(const WaveformColor &waveformColor)
+{
+    PixelMatrix normalValues =
+        MakeWaveformColorRange(waveformColor, waveformColor.color);
+
+    PixelMatrix highlightValues =
+        MakeWaveformColorRange(waveformColor, waveformColor.highlightColor);
+
+    return tau::VerticalStack(normalValues, highlightValues);
+}
+
+
+WaveformColormap::WaveformColormap(const WaveformColor &waveformColor)
+    :
+    palette_(MakeWaveformColors(waveformColor)),
+    rescale_(0, waveformColor.count - 1)
+{
+
+}
+
+
+void WaveformColormap::Filter(
+    const WaveformSettings &waveformSettings,
+    const Size &displayedSize,
+    const DataMatrix &data,
+    const Highlights *highlights,
+    PixelMatrix *output) const
+{
+    Waveform levelMap = DoGenerateWaveform(
+        data,
+        waveformSettings.maximumValue,
+        waveformSettings.levelCount,
+        waveformSettings.columnCount);
+
+    Waveform rescaled = this->rescale_(levelMap);
+
+    if (!highlights)
+    {
+        auto resized = Resize(
+            rescaled,
+            displayedSize,
+            waveformSettings.verticalScale);
+
+        this->palette_.Apply(resized, output);
+
+        return;
+    }
+
+    if (highlights->any())
+    {
+        DRAW_TRACE_SCOPE("waveform.highlight");
+
+        auto highlightsPerColumn =
+            static_cast<float>(highlights->cols())
+            / static_cast<float>(waveformSettings.columnCount);
+
+        for (
+            Eigen::Index column = 0;
+            column < rescaled.cols();
+            ++column)
+        {
+            auto beginHighlight = FloatToIndex(
+                std::round(
+                    highlightsPerColumn
+                    * static_cast<float>(column)));
+
+            auto endHighlight = FloatToIndex(
+                std::round(
+                    highlightsPerColumn
+                    * static_cast<float>(column + 1)));
+
+            endHighlight = std::min(endHighlight, highlights->cols());
+            auto width = endHighlight - beginHighlight;
+
+            if (highlights->middleCols(beginHighlight, width).any())
+            {
+                // Change this column to the highlight color.
+                rescaled.col(column).array()
+                    += static_cast<uint16_t>(waveformSettings.color.count);
+            }
+        }
+    }
+
+    auto resized = Resize(
+        rescaled,
+        displayedSize,
+        waveformSettings.verticalScale);
+
+    this->palette_.Apply(resized, output);
+}
+
+
+WaveformEngine::WaveformEngine(size_t threadCount)
+    :
+    threadCount_(std::max(threadCount, size_t{1})),
+    mutex_(),
+    color_(),
+    colormap_()
+{
+
+}
+
+
+void WaveformEngine::Render(
+    const WaveformSettings &waveformSettings,
+    const Size &imageSize,
+    const DataMatrix &data,
+    const Highlights *highlights,
+    PixelMatrix *output) const
+{
+    auto colormap = this->GetColormap(waveformSettings.color);
+
+    colormap->Filter(waveformSettings, imageSize, data, highlights, output);
+}
+
+
+std::shared_ptr<Pixels> WaveformEngine::Render(
+    const WaveformInput &input) const
+{
+    if (input.imageSize.width == 0 || input.imageSize.height == 0)
+    {
+        return {};
+    }
+
+    DRAW_TRACE_SCOPE("waveform.frame");
+
+    auto waveformPixels = Pixels::CreateShared(input.imageSize);
+
+    this->Render(
+        input.waveformSettings,
+        input.imageSize,
+        *input.data,
+        input.highlights.get(),
+        &waveformPixels->data);
+
+    if (waveformPixels->data.rows() == 0 || waveformPixels->data.cols() == 0)
+    {
+        throw std::logic_error("Must not be empty");
+    }
+
+    return waveformPixels;
+}
+
+
+std::vector<std::shared_ptr<Pixels>> WaveformEngine::RenderBatch(
+    const std::vector<WaveformInput> &inputs) const
+{
+    std::vector<std::shared_ptr<Pixels>> result(inputs.size());
+
+    // Each worker takes the next channel until none are left, so channels
+    // of different sizes keep every worker busy.
+    std::atomic<size_t> next{0};
+    std::exception_ptr error;
+    std::mutex errorMutex;
+
+    auto work = [&]()
+    {
+        while (true)
+        {
+            auto index = next.fetch_add(1);
+
+            if (index >= inputs.size())
+            {
+                return;
+            }
+
+            try
+            {
+                result[index] = this->Render(inputs[index]);
+            }
+            catch (...)
+            {
+                std::lock_guard lock(errorMutex);
+
+                if (!error)
+                {
+                    error = std::current_exception();
+                }
+
+                // Skip the remaining channels.
+                next.store(inputs.size());
+
+                return;
+            }
+        }
+    };
+
+    // The workers run on the shared pool, with the calling thread, instead
+    // of starting threads for every batch.
+    detail::BandPool::GetDefault().Run(
+        std::min(this->threadCount_, inputs.size()),
+        [&work](size_t)
+        {
+            work();
+        });
+
+    if (error)
+    {
+        std::rethrow_exception(error);
+    }
+
+    return result;
+}
+
+
+std::shared_ptr<const WaveformColormap> WaveformEngine::GetColormap(
+    const WaveformColor &waveformColor) const
+{
+    {
+        pex::ReadLock lock(this->mutex_);
+
+        if (this->color_ == waveformColor)
+        {
+            return this->colormap_;
+        }
+    }
+
+    // Build outside of the lock, so other colors are not kept waiting.
+    auto colormap = std::make_shared<const WaveformColormap>(waveformColor);
+
+    pex::WriteLock lock(this->mutex_);
+    this->color_ = waveformColor;
+    this->colormap_ = colormap;
+
+    return colormap;
+}
+
+
+} // end namespace draw
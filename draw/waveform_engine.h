@@ -0,0 +1,145 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <tau/color_map.h>
+#include <tau/color_maps/gradient.h>
+#include <pex/locks.h>
+
+#include "draw/waveform.h"
+#include "draw/palette.h"
+#include "draw/pixels.h"
+#include "draw/detail/parallel.h"
+
+
+namespace draw
+{
+
+
+using DataMatrix =
+    Eigen::Matrix<int32_t, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+
+PixelMatrix MakeWaveformColorRange(
+    const WaveformColor &waveformColor,
+    const tau::Hsv<double> &hsv);
+
+
+PixelMatrix MakeWaveformColors(const WaveformColor &waveformColor);
+
+
+using Highlights = Eigen::RowVector<bool, Eigen::Dynamic>;
+
+
+class WaveformColormap
+{
+public:
+    using Rescale = tau::Rescale<size_t>;
+
+    WaveformColormap(const WaveformColor &waveformColor);
+
+    void Filter(
+        const WaveformSettings &waveformSettings,
+        const Size &displayedSize,
+        const DataMatrix &data,
+        const Highlights *highlights, // may be NULL
+        PixelMatrix *output) const;
+
+private:
+    Palette palette_;
+    Rescale rescale_;
+};
+
+
+struct WaveformInput
+{
+    WaveformSettings waveformSettings;
+    Size imageSize;
+    std::shared_ptr<DataMatrix> data;
+    std::shared_ptr<Highlights> highlights;
+
+    WaveformInput()
+        :
+        waveformSettings{},
+        imageSize{},
+        data{},
+        highlights{}
+    {
+
+    }
+
+    WaveformInput(
+        const WaveformSettings &waveformSettings_,
+        const Size &imageSize_,
+        const DataMatrix &data_,
+        const std::optional<Highlights> &highlights_ = {})
+        :
+        waveformSettings(waveformSettings_),
+        imageSize(imageSize_),
+        data(std::make_shared<DataMatrix>(data_)),
+        highlights()
+    {
+        if (highlights_)
+        {
+            this->highlights = std::make_shared<Highlights>(*highlights_);
+        }
+    }
+};
+
+
+/**
+ ** Renders waveform images from plain settings and data, without a GUI
+ ** model.
+ **
+ ** Every method may be called from any number of threads at once. The
+ ** colormap of the most recent WaveformColor is cached and shared by the
+ ** callers, so channels rendered with the same colors build it only once.
+ **/
+class WaveformEngine
+{
+public:
+    // @param threadCount The most channels that RenderBatch renders at once.
+    WaveformEngine(size_t threadCount = detail::GetThreadCount());
+
+    WaveformEngine(const WaveformEngine &) = delete;
+    WaveformEngine & operator=(const WaveformEngine &) = delete;
+
+    /**
+     ** @param output Resized to one row for each pixel of imageSize.
+     **/
+    void Render(
+        const WaveformSettings &waveformSettings,
+        const Size &imageSize,
+        const DataMatrix &data,
+        const Highlights *highlights, // may be NULL
+        PixelMatrix *output) const;
+
+    // @return nullptr when the image size is empty.
+    std::shared_ptr<Pixels> Render(const WaveformInput &input) const;
+
+    /**
+     ** Render many channels on the threads of detail::BandPool::GetDefault().
+     **
+     ** The first exception thrown by a channel is rethrown after every
+     ** channel in progress has finished.
+     **
+     ** @return One image for each input, in the same order.
+     **/
+    std::vector<std::shared_ptr<Pixels>> RenderBatch(
+        const std::vector<WaveformInput> &inputs) const;
+
+    std::shared_ptr<const WaveformColormap> GetColormap(
+        const WaveformColor &waveformColor) const;
+
+private:
+    size_t threadCount_;
+
+    mutable pex::Mutex mutex_;
+    mutable std::optional<WaveformColor> color_;
+    mutable std::shared_ptr<const WaveformColormap> colormap_;
+};
+
+
+} // end namespace draw
@@ -5,118 +5,6 @@ namespace draw
 {
 
 
-PixelMatrix MakeWaveformColorRange(
-    const WaveformColor &waveformColor,
-    const tau::Hsv<double> &hsv)
-{
-    auto first = hsv;
-    auto last = hsv;
-
-    first.value = waveformColor.range.low;
-    last.value = waveformColor.range.high;
-
-    auto gradient = tau::gradient::MakeColormap<uint8_t>(
-        waveformColor.count,
-        first.ToVector(),
-        last.ToVector());
-
-    // Zero will be black
-    gradient.row(0) = tau::RowVector<3, uint8_t>(0, 0, 0);
-
-    return gradient;
-}
-
-
-PixelMatrix MakeWaveformColors(const WaveformColor &waveformColor)
-{
-    PixelMatrix normalValues =
-        MakeWaveformColorRange(waveformColor, waveformColor.color);
-
-    PixelMatrix highlightValues =
-        MakeWaveformColorRange(waveformColor, waveformColor.highlightColor);
-
-    return tau::VerticalStack(normalValues, highlightValues);
-}
-
-
-WaveformColormap::WaveformColormap(const WaveformColor &waveformColor)
-    :
-    map_(MakeWaveformColors(waveformColor)),
-    rescale_(0, waveformColor.count - 1)
-{
-
-}
-
-
-void WaveformColormap::Filter(
-    const WaveformSettings &waveformSettings,
-    const Size &displayedSize,
-    const DataMatrix &data,
-    const Highlights *highlights,
-    PixelMatrix *output)
-{
-    Waveform levelMap = DoGenerateWaveform(
-        data,
-        waveformSettings.maximumValue,
-        waveformSettings.levelCount,
-        waveformSettings.columnCount);
-
-    Waveform rescaled = this->rescale_(levelMap);
-
-    if (!highlights)
-    {
-        auto resized = Resize(
-            rescaled,
-            displayedSize,
-            waveformSettings.verticalScale);
-
-        this->map_(resized, output);
-
-        return;
-    }
-
-    if (highlights->any())
-    {
-        auto highlightsPerColumn =
-            static_cast<float>(highlights->cols())
-            / static_cast<float>(waveformSettings.columnCount);
-
-        for (
-            Eigen::Index column = 0;
-            column < rescaled.cols();
-            ++column)
-        {
-            auto beginHighlight = FloatToIndex(
-                std::round(
-                    highlightsPerColumn
-                    * static_cast<float>(column)));
-
-            auto endHighlight = FloatToIndex(
-                std::round(
-                    highlightsPerColumn
-                    * static_cast<float>(column + 1)));
-
-            endHighlight = std::min(endHighlight, highlights->cols());
-            auto width = endHighlight - beginHighlight;
-
-            if (highlights->middleCols(beginHighlight, width).any())
-            {
-                // Change this column to the highlight color.
-                rescaled.col(column).array()
-                    += static_cast<uint16_t>(waveformSettings.color.count);
-            }
-        }
-    }
-
-    auto resized = Resize(
-        rescaled,
-        displayedSize,
-        waveformSettings.verticalScale);
-
-    this->map_(resized, output);
-}
-
-
 WaveformGenerator::WaveformGenerator(
     WaveformControl waveformControl,
     PixelViewControl pixelViewControl)
@@ -125,11 +13,6 @@ WaveformGenerator::WaveformGenerator(
     waveformControl_(waveformControl),
     pixelViewControl_(pixelViewControl),
 
-    colorEndpoint_(
-        this,
-        waveformControl.color,
-        &WaveformGenerator::OnColorMapChanged_),
-
     waveformSettingsEndpoint_(
         this,
         waveformControl,
@@ -145,7 +28,7 @@ WaveformGenerator::WaveformGenerator(
 
     isRunning_(true),
     inputs_(),
-    colorMap_(waveformControl.color.Get()),
+    engine_(1),
     hasFrameCondition_(),
     thread_(std::bind(&WaveformGenerator::Run_, this))
 {
@@ -209,13 +92,6 @@ bool WaveformGenerator::Enabled() const
 }
 
 
-void WaveformGenerator::OnColorMapChanged_(const WaveformColor &waveformColor)
-{
-    pex::WriteLock lock(this->mutex_);
-    this->colorMap_ = WaveformColormap(waveformColor);
-}
-
-
 void WaveformGenerator::OnWaveformSettings_(
     const WaveformSettings &waveformSettings)
 {
@@ -261,24 +137,11 @@ void WaveformGenerator::Run_()
             this->inputs_.pop();
         }
 
-        if (input.imageSize.width == 0 || input.imageSize.height == 0)
-        {
-            continue;
-        }
-
-        auto waveformPixels = Pixels::CreateShared(input.imageSize);
-
-        this->colorMap_.Filter(
-            input.waveformSettings,
-            input.imageSize,
-            *input.data,
-            input.highlights.get(),
-            &waveformPixels->data);
+        auto waveformPixels = this->engine_.Render(input);
 
-        if (waveformPixels->data.rows() == 0
-                || waveformPixels->data.cols() == 0)
+        if (!waveformPixels)
         {
-            throw std::logic_error("Must not be empty");
+            continue;
         }
 
         this->pixelViewControl_.asyncPixels.Set(waveformPixels);
@@ -293,11 +156,6 @@ WaveformGenerator::WaveformGenerator(
     waveformControl_(std::move(other.waveformControl_)),
     pixelViewControl_(std::move(other.pixelViewControl_)),
 
-    colorEndpoint_(
-        this,
-        this->waveformControl_.color,
-        &WaveformGenerator::OnColorMapChanged_),
-
     waveformSettingsEndpoint_(
         this,
         this->waveformControl_,
@@ -313,7 +171,7 @@ WaveformGenerator::WaveformGenerator(
 
     isRunning_(true),
     inputs_(),
-    colorMap_(std::move(other.colorMap_)),
+    engine_(1),
     hasFrameCondition_(),
     thread_(std::bind(&WaveformGenerator::Run_, this))
 {
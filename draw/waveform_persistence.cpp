@@ -0,0 +1,251 @@
+#include "draw/waveform_persistence.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "draw/detail/cpu.h"
+#include "draw/detail/parallel.h"
+#include "draw/trace.h"
+
+
+namespace draw
+{
+
+
+// Fewer rows than this are decayed on the calling thread.
+static constexpr Eigen::Index minimumDecayBand = 64;
+
+
+namespace detail
+{
+
+
+#ifdef DRAW_X86_TARGETS
+
+// Eight pixels at a time, returning the count done and their maximum.
+__attribute__((target("avx2")))
+Eigen::Index DecayAvx2(
+    float *intensity,
+    const uint16_t *histogram,
+    Eigen::Index count,
+    float decay,
+    float *maximum)
+{
+    auto decays = _mm256_set1_ps(decay);
+    auto maximums = _mm256_setzero_ps();
+
+    Eigen::Index i = 0;
+
+    for (; i + 8 <= count; i += 8)
+    {
+        auto counts = _mm256_cvtepi32_ps(
+            _mm256_cvtepu16_epi32(
+                _mm_loadu_si128(
+                    reinterpret_cast<const __m128i *>(histogram + i))));
+
+        auto decayed = _mm256_add_ps(
+            _mm256_mul_ps(_mm256_loadu_ps(intensity + i), decays),
+            counts);
+
+        _mm256_storeu_ps(intensity + i, decayed);
+        maximums = _mm256_max_ps(maximums, decayed);
+    }
+
+    alignas(32) float lanes[8];
+    _mm256_store_ps(lanes, maximums);
+    *maximum = *std::max_element(lanes, lanes + 8);
+
+    return i;
+}
+
+#endif
+
+
+// @return The largest intensity.
+float Decay(
+    float *intensity,
+    const uint16_t *histogram,
+    Eigen::Index count,
+    float decay)
+{
+    float maximum = 0.0f;
+    Eigen::Index i = 0;
+
+#ifdef DRAW_X86_TARGETS
+    if (HasAvx2())
+    {
+        i = DecayAvx2(intensity, histogram, count, decay, &maximum);
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        intensity[i] = intensity[i] * decay + static_cast<float>(histogram[i]);
+        maximum = std::max(maximum, intensity[i]);
+    }
+
+    return maximum;
+}
+
+
+} // end namespace detail
+
+
+WaveformPersistence::WaveformPersistence(float decay)
+    :
+    decay_(std::clamp(decay, 0.0f, 1.0f)),
+    intensity_(),
+    maximum_(0.0f),
+    rowMaximums_(),
+    indices_(),
+    color_(),
+    palette_()
+{
+
+}
+
+
+void WaveformPersistence::SetDecay(float decay)
+{
+    this->decay_ = std::clamp(decay, 0.0f, 1.0f);
+}
+
+
+float WaveformPersistence::GetDecay() const
+{
+    return this->decay_;
+}
+
+
+void WaveformPersistence::Reset()
+{
+    this->intensity_.setZero();
+    this->maximum_ = 0.0f;
+}
+
+
+void WaveformPersistence::Accumulate(
+    const WaveformSettings &waveformSettings,
+    const Size &imageSize,
+    const DataMatrix &data)
+{
+    Waveform levelMap = DoGenerateWaveform(
+        data,
+        waveformSettings.maximumValue,
+        waveformSettings.levelCount,
+        waveformSettings.columnCount);
+
+    this->Accumulate(
+        Resize(levelMap, imageSize, waveformSettings.verticalScale));
+}
+
+
+void WaveformPersistence::Accumulate(const Waveform &displayed)
+{
+    DRAW_TRACE_SCOPE("waveform.decay");
+
+    if (
+        this->intensity_.rows() != displayed.rows()
+        || this->intensity_.cols() != displayed.cols())
+    {
+        this->intensity_ =
+            Intensity::Zero(displayed.rows(), displayed.cols());
+    }
+
+    auto rowCount = displayed.rows();
+    auto width = displayed.cols();
+    auto decay = this->decay_;
+
+    this->rowMaximums_.resize(static_cast<size_t>(rowCount));
+
+    detail::ParallelBands(
+        rowCount,
+        minimumDecayBand,
+        [&](Eigen::Index beginRow, Eigen::Index endRow)
+        {
+            for (auto row = beginRow; row < endRow; ++row)
+            {
+                this->rowMaximums_[static_cast<size_t>(row)] =
+                    detail::Decay(
+                        this->intensity_.row(row).data(),
+                        displayed.row(row).data(),
+                        width,
+                        decay);
+            }
+        });
+
+    this->maximum_ = this->rowMaximums_.empty()
+        ? 0.0f
+        : *std::max_element(
+            this->rowMaximums_.begin(),
+            this->rowMaximums_.end());
+}
+
+
+const WaveformPersistence::Intensity &
+WaveformPersistence::GetIntensity() const
+{
+    return this->intensity_;
+}
+
+
+void WaveformPersistence::Render(
+    const WaveformColor &waveformColor,
+    PixelMatrix *output)
+{
+    DRAW_TRACE_SCOPE("waveform.persistence");
+
+    if (this->color_ != waveformColor)
+    {
+        this->palette_ = Palette(
+            MakeWaveformColorRange(waveformColor, waveformColor.color));
+
+        this->color_ = waveformColor;
+    }
+
+    auto lastIndex = static_cast<float>(this->palette_.GetSize() - 1);
+
+    auto scale = this->maximum_ > 0.0f
+        ? lastIndex / this->maximum_
+        : 0.0f;
+
+    this->indices_.resize(this->intensity_.rows(), this->intensity_.cols());
+
+    detail::ParallelBands(
+        this->intensity_.rows(),
+        minimumDecayBand,
+        [&](Eigen::Index beginRow, Eigen::Index endRow)
+        {
+            auto rowCount = endRow - beginRow;
+
+            this->indices_.middleRows(beginRow, rowCount) =
+                (this->intensity_.middleRows(beginRow, rowCount).array()
+                    * scale + 0.5f).template cast<uint16_t>();
+        });
+
+    this->palette_.Apply(this->indices_, output);
+}
+
+
+std::shared_ptr<Pixels> WaveformPersistence::Render(
+    const WaveformInput &input)
+{
+    if (input.imageSize.width == 0 || input.imageSize.height == 0)
+    {
+        return {};
+    }
+
+    this->Accumulate(
+        input.waveformSettings,
+        input.imageSize,
+        *input.data);
+
+    auto waveformPixels = Pixels::CreateShared(input.imageSize);
+
+    this->Render(input.waveformSettings.color, &waveformPixels->data);
+
+    return waveformPixels;
+}
+
+
+} // end namespace draw
@@ -0,0 +1,88 @@
+#pragma once
+
+
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "draw/gray.h"
+#include "draw/palette.h"
+#include "draw/waveform_engine.h"
+
+
+namespace draw
+{
+
+
+/**
+ ** Accumulates waveforms across frames, with exponential decay, like the
+ ** persistence of a phosphor display.
+ **
+ ** The intensity of each displayed pixel is kept as a float. Each frame, the
+ ** intensity is multiplied by the decay and the new histogram is added, in
+ ** one pass over bands of rows on separate threads, eight pixels at a time
+ ** with AVX2 when the processor supports it.
+ **
+ ** The result is scaled by the largest intensity and mapped through the
+ ** gradient of the WaveformColor.
+ **
+ ** Each channel keeps its own WaveformPersistence. It is not safe to use one
+ ** from more than one thread at a time.
+ **/
+class WaveformPersistence
+{
+public:
+    using Intensity = Gray<float>;
+
+    static constexpr float defaultDecay = 0.85f;
+
+    // @param decay The fraction of the intensity kept from one frame to the
+    // next, from 0 (no persistence) to 1 (accumulate forever).
+    WaveformPersistence(float decay = defaultDecay);
+
+    void SetDecay(float decay);
+
+    float GetDecay() const;
+
+    // Forget every frame.
+    void Reset();
+
+    /**
+     ** Decay the previous frames, and add the waveform of data at
+     ** imageSize.
+     **
+     ** A change in the image size starts again from zero.
+     **/
+    void Accumulate(
+        const WaveformSettings &waveformSettings,
+        const Size &imageSize,
+        const DataMatrix &data);
+
+    // Decay the previous frames, and add a histogram at the size of the
+    // display, as returned by Resize.
+    void Accumulate(const Waveform &displayed);
+
+    const Intensity & GetIntensity() const;
+
+    // @param output Resized to one row for each pixel of the display.
+    void Render(const WaveformColor &waveformColor, PixelMatrix *output);
+
+    // Accumulate and render one frame.
+    // @return nullptr when the image size is empty.
+    std::shared_ptr<Pixels> Render(const WaveformInput &input);
+
+private:
+    float decay_;
+    Intensity intensity_;
+    float maximum_;
+
+    // The largest intensity of each row, found while decaying.
+    std::vector<float> rowMaximums_;
+
+    Waveform indices_;
+    std::optional<WaveformColor> color_;
+    Palette palette_;
+};
+
+
+} // end namespace draw
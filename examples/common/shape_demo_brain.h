@@ -22,7 +22,8 @@
 #include <draw/polygon_brain.h>
 #include <draw/shapes.h>
 #include <draw/shape_list.h>
-#include <draw/views/shape_list_view.h>
+#include <draw/drag_preview.h>
+#include <draw/views/virtual_shape_list_view.h>
 
 #include "observer.h"
 
@@ -35,6 +36,7 @@ public:
         :
         Brain<Derived>(),
         shapesId_(),
+        dragPreview_(this->userControl_.pixelView.asyncShapes),
         observer_(this, UserControl(this->user_)),
         demoModel_(),
         demoControl_(this->demoModel_),
@@ -42,7 +44,17 @@ public:
         shapesEndpoint_(
             this,
             this->demoControl_.shapes,
-            &ShapeDemoBrain::OnShapes_)
+            &ShapeDemoBrain::OnShapes_),
+
+        isBatchingEndpoint_(
+            this,
+            this->demoControl_.isBatching,
+            &ShapeDemoBrain::OnIsBatching_),
+
+        draggedShapeEndpoint_(
+            this,
+            this->dragPreview_.GetDraggedShape(),
+            &ShapeDemoBrain::OnDraggedShape_)
     {
         PEX_NAME("ShapeDemoBrain");
         PEX_MEMBER(demoModel_);
@@ -54,29 +66,30 @@ public:
         this->userControl_.pixelView.canvas.viewSettings.imageSize.Set(
             draw::Size(1920, 1080));
 
-        auto scrolled = new wxpex::Scrolled(parent);
-
-        auto shapeListView =
-            new draw::ShapeListView(scrolled, this->demoControl_);
-
-        scrolled->ConfigureSizer(
-            wxpex::verticalScrolled,
-            wxpex::BorderSizer(shapeListView, 1));
-
-        return scrolled;
+        // The list scrolls itself, creating rows only as they come into view.
+        return new draw::VirtualShapeListView(parent, this->demoControl_);
     }
 
     void Display()
     {
         auto shapes = draw::Shapes(this->shapesId_.Get());
 
+        // The shape being dragged is drawn by the preview.
+        auto draggedShape = this->draggedShapeEndpoint_.Get();
+
         auto shapeControl = std::rbegin(this->demoControl_.shapes);
         auto rend = std::rend(this->demoControl_.shapes);
 
         while (shapeControl != rend)
         {
             const auto &shapeValue = shapeControl->Get();
-            shapes.Append(shapeValue.GetValueBase()->Copy());
+            auto shape = shapeValue.GetValueBase();
+
+            if (shape->GetId() != draggedShape)
+            {
+                shapes.Append(shape->Copy());
+            }
+
             ++shapeControl;
         }
 
@@ -86,15 +99,54 @@ public:
 protected:
     void OnShapes_(const typename draw::ShapesControl::Type &)
     {
+        if (this->demoControl_.isBatching.Get())
+        {
+            // Display once when the batch closes.
+            return;
+        }
+
+        this->Display();
+    }
+
+    void OnIsBatching_(bool isBatching)
+    {
+        if (!isBatching)
+        {
+            this->Display();
+        }
+    }
+
+    void OnDraggedShape_(int64_t)
+    {
+        if (this->demoControl_.isBatching.Get())
+        {
+            return;
+        }
+
+        // Hide the shape when a drag begins, and show it when it ends.
         this->Display();
     }
 
 protected:
     draw::ShapesId shapesId_;
+
+    // Created after shapesId_, so the preview is drawn above the shapes.
+    draw::DragPreview dragPreview_;
+
     Observer<ShapeDemoBrain> observer_;
     draw::ShapeListModel demoModel_;
     draw::ShapeListControl demoControl_;
 
     using ShapesEndpoint = draw::ShapesEndpoint<ShapeDemoBrain>;
     ShapesEndpoint shapesEndpoint_;
+
+    using IsBatchingEndpoint =
+        pex::Endpoint<ShapeDemoBrain, draw::IsBatchingControl>;
+
+    IsBatchingEndpoint isBatchingEndpoint_;
+
+    using DraggedShapeEndpoint =
+        pex::Endpoint<ShapeDemoBrain, draw::DraggedShapeControl>;
+
+    DraggedShapeEndpoint draggedShapeEndpoint_;
 };
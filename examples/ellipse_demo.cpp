@@ -9,9 +9,11 @@ public:
         :
         ShapeDemoBrain<DemoBrain>(),
         ellipseBrain_(
-            this->demoControl_.shapes,
+            this->demoControl_,
             this->userControl_.pixelView.canvas)
     {
+        this->ellipseBrain_.SetDragPreview(&this->dragPreview_);
+
         this->demoControl_.shapes.Append(
             draw::ShapeValueWrapper::Default<draw::EllipseShape>());
     }
@@ -24,6 +24,8 @@ public:
             this->demoControl_.shapes.count,
             &DemoBrain::OnShapeAdded_)
     {
+        this->shapeBrain_.SetDragPreview(&this->dragPreview_);
+
         this->demoControl_.shapes.Append(
             draw::ShapeValueWrapper::Default<draw::QuadShape>());
 
@@ -11,9 +11,11 @@ public:
         :
         ShapeDemoBrain<DemoBrain>(),
         polygonBrain_(
-            this->demoControl_.shapes,
+            this->demoControl_,
             this->userControl_.pixelView.canvas)
     {
+        this->polygonBrain_.SetDragPreview(&this->dragPreview_);
+
         this->demoControl_.shapes.Append(
             draw::ShapeValueWrapper::Default<draw::PolygonShape>());
     }
@@ -24,9 +24,11 @@ public:
         :
         ShapeDemoBrain<DemoBrain>(),
         quadBrain_(
-            this->demoControl_.shapes,
+            this->demoControl_,
             this->userControl_.pixelView.canvas)
     {
+        this->quadBrain_.SetDragPreview(&this->dragPreview_);
+
         this->demoControl_.shapes.Append(
             draw::ShapeValueWrapper::Default<draw::QuadShape>());
     }
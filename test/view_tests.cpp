@@ -1,9 +1,44 @@
 #include <catch2/catch.hpp>
 
+#include <cmath>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
 #include <jive/range.h>
 #include <tau/region.h>
 #include <tau/random.h>
+#include <tau/color_map.h>
+#include <tau/angles.h>
 #include <draw/view.h>
+#include <draw/raster.h>
+#include <draw/palette.h>
+#include <draw/packed_pixels.h>
+#include <draw/pixel_pyramid.h>
+#include <draw/polygon.h>
+#include <draw/field_serializer.h>
+#include <draw/shape_list.h>
+#include <draw/polygon_shape.h>
+#include <draw/drag_preview.h>
+#include <draw/shape_serializer.h>
+#include <draw/trace.h>
+#include <draw/warp.h>
+#include <draw/line_clipper.h>
+#include <draw/spline_tessellator.h>
+#include <draw/waveform_engine.h>
+#include <draw/label_renderer.h>
+#include <draw/streaming_waveform.h>
+#include <draw/waveform_persistence.h>
+#include <draw/parade.h>
+#include <draw/density.h>
+#include <draw/integral_image.h>
+#include <draw/scroll_predictor.h>
+#include <draw/views/view_link.h>
+#include <draw/tile_cache.h>
+#include <draw/tile_loader.h>
+#include <draw/oddeven.h>
 
 
 template<typename T, typename U>
@@ -184,3 +219,1815 @@ TEMPLATE_TEST_CASE(
     REQUIRE(view.source.GetBottomRight().y <= Approx(sourceSize.height));
     REQUIRE(view.source.size.GetArea() == Approx(view.target.size.GetArea()));
 }
+
+
+TEST_CASE("Aligned views of adjacent regions join", "[view]")
+{
+    auto sourceSize = tau::Size<int>(640, 480);
+    auto scale = tau::Scale<double>(3.5, 2.25);
+    auto viewPosition = tau::Point2d<int>(107, 43);
+
+    auto whole = draw::MakeAlignedView(
+        viewPosition,
+        tau::Region<int>{{tau::Point2d<int>(0, 0), tau::Size<int>(400, 300)}},
+        sourceSize,
+        scale);
+
+    // The strip exposed by scrolling 30 pixels to the right.
+    auto strip = draw::MakeAlignedView(
+        viewPosition,
+        tau::Region<int>{{tau::Point2d<int>(370, 0), tau::Size<int>(30, 300)}},
+        sourceSize,
+        scale);
+
+    REQUIRE(whole.HasArea());
+    REQUIRE(strip.HasArea());
+
+    // The target covers the clip region.
+    REQUIRE(whole.target.topLeft.x <= 0);
+    REQUIRE(whole.target.topLeft.y <= 0);
+    REQUIRE(whole.target.GetBottomRight().x >= 400);
+    REQUIRE(whole.target.GetBottomRight().y >= 300);
+    REQUIRE(strip.target.topLeft.x <= 370);
+    REQUIRE(strip.target.GetBottomRight().x >= 400);
+
+    // Both views place the strip's source pixels at the same target position.
+    REQUIRE(strip.source.GetBottomRight() == whole.source.GetBottomRight());
+    REQUIRE(strip.target.GetBottomRight() == whole.target.GetBottomRight());
+    REQUIRE(strip.target.topLeft.y == whole.target.topLeft.y);
+
+    auto expectedLeft = static_cast<int>(
+        std::round(strip.source.topLeft.x * scale.horizontal))
+            - viewPosition.x;
+
+    REQUIRE(strip.target.topLeft.x == expectedLeft);
+}
+
+
+TEST_CASE("Aligned view outside of the source is empty", "[view]")
+{
+    auto view = draw::MakeAlignedView(
+        tau::Point2d<int>(-500, -500),
+        tau::Region<int>{{tau::Point2d<int>(0, 0), tau::Size<int>(100, 100)}},
+        tau::Size<int>(64, 64),
+        tau::Scale<double>(1.0, 1.0));
+
+    REQUIRE(!view.HasArea());
+}
+
+
+TEST_CASE("Rasterized coverage matches the area of the polygons", "[raster]")
+{
+    draw::Rasterizer rasterizer(draw::Size(20, 20));
+
+    rasterizer.AddPolygon(
+        {{2.5, 2.5}, {12.5, 2.5}, {12.5, 12.5}, {2.5, 12.5}});
+
+    rasterizer.AddPolygon(
+        {{6.5, 6.5}, {16.5, 6.5}, {16.5, 16.5}, {6.5, 16.5}});
+
+    auto getCoverage = [&rasterizer](draw::FillRule fillRule)
+    {
+        double total = 0.0;
+        float maximum = 0.0f;
+
+        rasterizer.Render(
+            fillRule,
+            [&](int, int begin, int end, const float *coverage)
+            {
+                for (int column = begin; column < end; ++column)
+                {
+                    total += coverage[column];
+                    maximum = std::max(maximum, coverage[column]);
+                }
+            });
+
+        REQUIRE(maximum <= Approx(1.0f));
+
+        return total;
+    };
+
+    // Overlapping squares join under the nonzero rule, and the overlap is
+    // removed under the even-odd rule.
+    REQUIRE(getCoverage(draw::FillRule::nonzero) == Approx(164.0));
+    REQUIRE(getCoverage(draw::FillRule::evenOdd) == Approx(128.0));
+
+    rasterizer.SetAntialias(false);
+    REQUIRE(getCoverage(draw::FillRule::nonzero) == Approx(164.0));
+}
+
+
+TEST_CASE("Palette matches BasicColorMap", "[palette]")
+{
+    auto seed = GENERATE(
+        take(4, random(tau::SeedLimits::min(), tau::SeedLimits::max())));
+
+    tau::UniformRandom<int> uniformRandom{seed};
+    uniformRandom.SetRange(0, 255);
+
+    draw::PixelMatrix colors(128, 3);
+
+    for (Eigen::Index i = 0; i < colors.size(); ++i)
+    {
+        colors.data()[i] = static_cast<uint8_t>(uniformRandom());
+    }
+
+    // Sizes that leave a partial group of eight in every row.
+    auto rows = GENERATE(1, 7, 300);
+    auto columns = GENERATE(9, 17, 641);
+
+    draw::Waveform indices(rows, columns);
+    uniformRandom.SetRange(0, 127);
+
+    for (Eigen::Index i = 0; i < indices.size(); ++i)
+    {
+        indices.data()[i] = static_cast<uint16_t>(uniformRandom());
+    }
+
+    draw::PixelMatrix expected;
+    tau::BasicColorMap<draw::PixelMatrix>(colors)(indices, &expected);
+
+    draw::Palette palette(colors);
+    draw::PixelMatrix result;
+    palette.Apply(indices, &result);
+
+    REQUIRE(result == expected);
+
+    palette.SetUseSimd(false);
+    palette.Apply(indices, &result);
+
+    REQUIRE(result == expected);
+}
+
+
+TEST_CASE("Palette writes only its own pixels", "[palette]")
+{
+    draw::PixelMatrix colors(256, 3);
+
+    for (Eigen::Index i = 0; i < colors.size(); ++i)
+    {
+        colors.data()[i] = static_cast<uint8_t>(i % 251 + 1);
+    }
+
+    draw::Palette palette(colors);
+
+    // Counts that end one pixel past a group of eight.
+    auto count = static_cast<size_t>(GENERATE(9, 17, 81));
+    static constexpr uint8_t guard = 0xAB;
+
+    std::vector<uint16_t> indices(count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        indices[i] = static_cast<uint16_t>((i * 37) % 256);
+    }
+
+    std::vector<uint8_t> output(3 * count + 16, guard);
+    palette.Apply(indices.data(), count, output.data());
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto row = static_cast<Eigen::Index>(indices[i]);
+        REQUIRE(output[3 * i] == colors(row, 0));
+        REQUIRE(output[3 * i + 1] == colors(row, 1));
+        REQUIRE(output[3 * i + 2] == colors(row, 2));
+    }
+
+    for (size_t i = 3 * count; i < output.size(); ++i)
+    {
+        REQUIRE(output[i] == guard);
+    }
+}
+
+
+TEST_CASE("Packed pixels convert to and from RGB", "[packed]")
+{
+    auto seed = GENERATE(
+        take(4, random(tau::SeedLimits::min(), tau::SeedLimits::max())));
+
+    tau::UniformRandom<int> uniformRandom{seed};
+    uniformRandom.SetRange(0, 255);
+
+    auto pixels = draw::Pixels::CreateShared(
+        tau::Size<draw::Pixels::Index>(37, 11));
+
+    for (Eigen::Index i = 0; i < pixels->data.size(); ++i)
+    {
+        pixels->data.data()[i] = static_cast<uint8_t>(uniformRandom());
+    }
+
+    auto packed = draw::ToPacked(*pixels);
+
+    REQUIRE(packed->size.width == 37);
+    REQUIRE(packed->size.height == 11);
+
+    auto pixel = packed->data(3, 5);
+    auto index = 3 * (3 * 37 + 5);
+
+    REQUIRE(draw::PackedPixels::GetRed(pixel) == pixels->data.data()[index]);
+
+    REQUIRE(
+        draw::PackedPixels::GetBlue(pixel) == pixels->data.data()[index + 2]);
+
+    REQUIRE(draw::ToRgb(*packed)->data == pixels->data);
+}
+
+
+TEST_CASE("Downsample averages the pixels that exist", "[pyramid]")
+{
+    using Index = draw::Pixels::Index;
+
+    auto size = GENERATE(
+        tau::Size<Index>(1, 1),
+        tau::Size<Index>(2, 2),
+        tau::Size<Index>(7, 1),
+        tau::Size<Index>(1, 5),
+        tau::Size<Index>(9, 6),
+        tau::Size<Index>(8, 11),
+        tau::Size<Index>(131, 97));
+
+    auto seed = GENERATE(
+        take(1, random(tau::SeedLimits::min(), tau::SeedLimits::max())));
+
+    tau::UniformRandom<int> uniformRandom{seed};
+    uniformRandom.SetRange(0, 255);
+
+    auto pixels = draw::Pixels::CreateShared(size);
+
+    for (Eigen::Index i = 0; i < pixels->data.size(); ++i)
+    {
+        pixels->data.data()[i] = static_cast<uint8_t>(uniformRandom());
+    }
+
+    auto halved = draw::Downsample(*pixels);
+
+    REQUIRE(halved->size.width == (size.width + 1) / 2);
+    REQUIRE(halved->size.height == (size.height + 1) / 2);
+
+    auto get = [&pixels, &size](Index column, Index row, Index channel)
+    {
+        // Edges repeat the last column or row.
+        column = std::min(column, size.width - 1);
+        row = std::min(row, size.height - 1);
+
+        return static_cast<unsigned>(
+            pixels->data.data()[3 * (row * size.width + column) + channel]);
+    };
+
+    for (Index row = 0; row < halved->size.height; ++row)
+    {
+        for (Index column = 0; column < halved->size.width; ++column)
+        {
+            for (Index channel = 0; channel < 3; ++channel)
+            {
+                auto sum = get(2 * column, 2 * row, channel)
+                    + get(2 * column + 1, 2 * row, channel)
+                    + get(2 * column, 2 * row + 1, channel)
+                    + get(2 * column + 1, 2 * row + 1, channel);
+
+                auto index = 3 * (row * halved->size.width + column) + channel;
+
+                REQUIRE(halved->data.data()[index] == (sum + 2) / 4);
+            }
+        }
+    }
+}
+
+
+TEST_CASE("Pyramid level is never magnified", "[pyramid]")
+{
+    auto levelFor = [](double horizontal, double vertical)
+    {
+        return draw::SelectPyramidLevel(
+            tau::Scale<double>(horizontal, vertical),
+            5);
+    };
+
+    REQUIRE(levelFor(4.0, 4.0) == 0);
+    REQUIRE(levelFor(1.0, 1.0) == 0);
+    REQUIRE(levelFor(0.99, 0.99) == 0);
+    REQUIRE(levelFor(0.5, 0.5) == 1);
+    REQUIRE(levelFor(0.26, 0.26) == 1);
+    REQUIRE(levelFor(0.25, 0.25) == 2);
+    REQUIRE(levelFor(0.1, 0.1) == 3);
+
+    // The larger scale decides, so neither axis is magnified.
+    REQUIRE(levelFor(0.1, 0.6) == 0);
+    REQUIRE(levelFor(0.3, 0.1) == 1);
+
+    // Limited to the levels that exist.
+    REQUIRE(levelFor(0.001, 0.001) == 4);
+
+    REQUIRE(
+        draw::SelectPyramidLevel(tau::Scale<double>(0.1, 0.1), 1) == 0);
+
+    REQUIRE(levelFor(0.0, 0.0) == 0);
+
+    // The selected level is not magnified, and the next level would be.
+    auto scale = GENERATE(0.9, 0.7, 0.45, 0.3, 0.2, 0.12, 0.07);
+    auto level = static_cast<double>(levelFor(scale, scale));
+
+    REQUIRE(scale * std::pow(2.0, level) <= 1.0);
+    REQUIRE(scale * std::pow(2.0, level + 1.0) > 1.0);
+}
+
+
+TEST_CASE("Polygon survives JSON and binary round trips", "[serialize]")
+{
+    draw::Polygon polygon(
+        draw::PointsDouble{{0.0, 0.0}, {10.5, 0.25}, {3.0, -7.125}});
+
+    polygon.rotation = 12.5;
+
+    std::stringstream json;
+    draw::detail::JsonWriter jsonWriter(json);
+    draw::WriteJson(jsonWriter, polygon);
+
+    draw::Polygon fromJson{};
+    draw::detail::JsonReader jsonReader(json);
+    draw::ReadJson(jsonReader, fromJson);
+
+    REQUIRE(fromJson == polygon);
+
+    std::string bytes;
+    draw::detail::BinaryWriter binaryWriter(bytes);
+    draw::WriteBinary(binaryWriter, polygon);
+
+    draw::Polygon fromBinary{};
+    draw::detail::BinaryReader binaryReader(bytes.data(), bytes.size());
+    draw::ReadBinary(binaryReader, fromBinary);
+
+    REQUIRE(fromBinary == polygon);
+}
+
+
+TEST_CASE("Binary vectors reject counts past the end", "[serialize]")
+{
+    std::string bytes;
+    draw::detail::BinaryWriter binaryWriter(bytes);
+
+    // A count of four billion elements, followed by one element.
+    binaryWriter.Write(uint32_t{0xFFFFFFFF});
+    binaryWriter.Write(1.0);
+
+    std::vector<double> values;
+    draw::detail::BinaryReader valuesReader(bytes.data(), bytes.size());
+    REQUIRE_THROWS_AS(
+        draw::ReadBinary(valuesReader, values),
+        draw::DrawError);
+
+    draw::PointsDouble points;
+    draw::detail::BinaryReader pointsReader(bytes.data(), bytes.size());
+    REQUIRE_THROWS_AS(
+        draw::ReadBinary(pointsReader, points),
+        draw::DrawError);
+}
+
+
+TEST_CASE("Shape list batch updates displays when it closes", "[batch]")
+{
+    draw::ShapeListModel model;
+    draw::ShapeListControl control(model);
+
+    control.shapes.Append(
+        draw::ShapeValueWrapper::Default<draw::PolygonShape>());
+
+    {
+        draw::ShapeListBatch batch(control);
+
+        for (int i = 0; i < 20; ++i)
+        {
+            batch.Append(
+                draw::ShapeValueWrapper::Default<draw::PolygonShape>());
+        }
+
+        batch.Erase(0);
+
+        REQUIRE(control.isBatching.Get());
+        REQUIRE(control.shapes.count.Get() == 20);
+        REQUIRE(control.shapesDisplay.count.Get() == 1);
+    }
+
+    REQUIRE(!control.isBatching.Get());
+    REQUIRE(control.shapesDisplay.count.Get() == 20);
+
+    REQUIRE(
+        control.shapesDisplay.indices.Get() == control.shapes.indices.Get());
+}
+
+
+struct DisplayCountObserver
+{
+    using CountControl = decltype(draw::ShapeDisplayListControl::count);
+
+    DisplayCountObserver(const draw::ShapeListControl &control)
+        :
+        updateCount(0),
+        countEndpoint_(
+            this,
+            control.shapesDisplay.count,
+            &DisplayCountObserver::OnCount_)
+    {
+
+    }
+
+    size_t updateCount;
+
+private:
+    void OnCount_(size_t)
+    {
+        ++this->updateCount;
+    }
+
+    pex::Endpoint<DisplayCountObserver, CountControl> countEndpoint_;
+};
+
+
+TEST_CASE("Loading an archive updates displays once", "[serialize]")
+{
+    auto format = GENERATE(draw::ShapeFormat::json, draw::ShapeFormat::binary);
+
+    draw::ShapeListModel sourceModel;
+    draw::ShapeListControl source(sourceModel);
+
+    for (int i = 0; i < 12; ++i)
+    {
+        source.shapes.Append(
+            draw::ShapeValueWrapper::Default<draw::PolygonShape>());
+    }
+
+    std::stringstream stream;
+    draw::SaveShapes(source.shapes, stream, format);
+
+    draw::ShapeListModel model;
+    draw::ShapeListControl control(model);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        control.shapes.Append(
+            draw::ShapeValueWrapper::Default<draw::PolygonShape>());
+    }
+
+    DisplayCountObserver observer(control);
+
+    auto stats = draw::LoadShapes(control, stream);
+
+    REQUIRE(stats.shapeCount == 12);
+    REQUIRE(control.shapes.count.Get() == 12);
+    REQUIRE(control.shapesDisplay.count.Get() == 12);
+    REQUIRE(observer.updateCount == 1);
+    REQUIRE(!control.isBatching.Get());
+}
+
+
+class TestDragPreview: public draw::DragPreviewBase
+{
+public:
+    TestDragPreview(Clock::duration commitInterval)
+        :
+        draw::DragPreviewBase(commitInterval),
+        showCount(0),
+        flush()
+    {
+
+    }
+
+    void Show(const std::shared_ptr<draw::DrawnShape> &) override
+    {
+        ++this->showCount;
+    }
+
+    void StartFlushTimer(
+        Clock::duration,
+        std::function<void()> flush_) override
+    {
+        this->flush = flush_;
+    }
+
+    void StopFlushTimer() override
+    {
+        this->flush = nullptr;
+    }
+
+    // Fire the timer.
+    void Flush()
+    {
+        auto flush_ = std::move(this->flush);
+        this->flush = nullptr;
+        REQUIRE(!!flush_);
+        flush_();
+    }
+
+    size_t showCount;
+    std::function<void()> flush;
+
+protected:
+    void Hide_() override
+    {
+
+    }
+};
+
+
+TEST_CASE("Drag committer throttles and flushes shapes", "[drag]")
+{
+    draw::ShapeListModel model;
+    draw::ShapeListControl control(model);
+
+    control.shapes.Append(
+        draw::ShapeValueWrapper::Default<draw::PolygonShape>());
+
+    auto getShape = [&control]()
+    {
+        return dynamic_cast<const draw::PolygonShape &>(
+            *control.shapes.at(0).Get().GetValueBase());
+    };
+
+    auto makeShape = [&getShape](double x)
+    {
+        auto shape = getShape();
+        shape.shape.center = tau::Point2d<double>(x, 0.0);
+
+        return std::make_shared<draw::PolygonShape>(shape);
+    };
+
+    auto getX = [&getShape]()
+    {
+        return getShape().shape.center.x;
+    };
+
+    auto startingX = getX();
+    draw::DragCommitter committer(control.shapes.at(0).GetVirtual()->Copy());
+
+    SECTION("Every shape is sent without a preview")
+    {
+        committer.Update(makeShape(1.0));
+        REQUIRE(getX() == 1.0);
+        committer.Update(makeShape(2.0));
+        REQUIRE(getX() == 2.0);
+    }
+
+    SECTION("Every shape is sent when the interval has passed")
+    {
+        TestDragPreview preview(std::chrono::milliseconds(0));
+        committer.SetPreview(&preview, 7);
+        REQUIRE(preview.GetDraggedShape().Get() == 7);
+
+        committer.Update(makeShape(1.0));
+        REQUIRE(getX() == 1.0);
+        committer.Update(makeShape(2.0));
+        REQUIRE(getX() == 2.0);
+        REQUIRE(preview.showCount == 2);
+        REQUIRE(!preview.flush);
+
+        committer.Finish();
+    }
+
+    SECTION("Only the most recent shape is sent within the interval")
+    {
+        TestDragPreview preview(std::chrono::hours(1));
+        committer.SetPreview(&preview, 7);
+
+        committer.Update(makeShape(1.0));
+        committer.Update(makeShape(2.0));
+        committer.Update(makeShape(3.0));
+
+        // Every shape is previewed, but none are sent until the timer fires.
+        REQUIRE(preview.showCount == 3);
+        REQUIRE(getX() == startingX);
+        REQUIRE(!!preview.flush);
+
+        preview.Flush();
+        REQUIRE(getX() == 3.0);
+
+        // The interval restarts with each shape that is sent.
+        committer.Update(makeShape(4.0));
+        REQUIRE(getX() == 3.0);
+
+        SECTION("Finish sends the last shape")
+        {
+            committer.Finish();
+            REQUIRE(getX() == 4.0);
+        }
+
+        SECTION("The timer sends the last shape when the mouse stops")
+        {
+            preview.Flush();
+            REQUIRE(getX() == 4.0);
+            committer.Finish();
+        }
+
+        REQUIRE(!preview.flush);
+        REQUIRE(!committer.HasPreview());
+
+        REQUIRE(
+            preview.GetDraggedShape().Get() == draw::DragPreviewBase::noShape);
+    }
+}
+
+
+TEST_CASE("Tracer collects scopes and exports Chrome trace", "[trace]")
+{
+    auto &tracer = draw::Tracer::Get();
+    tracer.Collect();
+    tracer.Clear();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        draw::TraceScope scope("test.scope");
+        tracer.Count("test.counter", i);
+    }
+
+    tracer.Collect();
+    auto stats = tracer.GetStats();
+
+    REQUIRE(stats.size() == 2);
+    REQUIRE(stats[0].name == "test.counter");
+    REQUIRE(stats[0].count == 10);
+    REQUIRE(stats[0].last == 9.0);
+    REQUIRE(stats[1].name == "test.scope");
+    REQUIRE(stats[1].p50 <= stats[1].p99);
+
+    std::stringstream output;
+    tracer.WriteChromeTrace(output);
+
+    // The export is valid JSON.
+    draw::detail::JsonReader reader(output);
+    reader.SkipValue();
+    REQUIRE(reader.Peek() == 0);
+}
+
+
+TEST_CASE("Tracer reuses the rings of finished threads", "[trace]")
+{
+    auto &tracer = draw::Tracer::Get();
+
+    auto record = [&tracer]()
+    {
+        tracer.Count("test.thread", 1.0);
+    };
+
+    // Give this thread its ring, and let any earlier threads' rings drain.
+    record();
+    tracer.Collect();
+
+    std::thread(record).join();
+    tracer.Collect();
+    auto ringCount = tracer.GetRingCount();
+
+    for (int i = 0; i < 16; ++i)
+    {
+        std::thread(record).join();
+        tracer.Collect();
+    }
+
+    REQUIRE(tracer.GetRingCount() == ringCount);
+    tracer.Clear();
+}
+
+
+TEST_CASE("Waveform engine renders a batch like single channels", "[waveform]")
+{
+    tau::UniformRandom<int32_t> uniformRandom{42};
+    uniformRandom.SetRange(0, 255);
+
+    draw::WaveformSettings settings;
+    draw::Size imageSize(200, 100);
+
+    std::vector<draw::WaveformInput> inputs;
+
+    for (int channel = 0; channel < 6; ++channel)
+    {
+        draw::DataMatrix data(48, 640);
+
+        for (Eigen::Index i = 0; i < data.size(); ++i)
+        {
+            data.data()[i] = uniformRandom();
+        }
+
+        inputs.emplace_back(settings, imageSize, data);
+    }
+
+    // An empty image is skipped.
+    inputs.emplace_back(settings, draw::Size{}, draw::DataMatrix(48, 640));
+
+    draw::WaveformEngine engine(3);
+    auto batch = engine.RenderBatch(inputs);
+
+    REQUIRE(batch.size() == inputs.size());
+    REQUIRE(!batch.back());
+
+    for (size_t i = 0; i + 1 < inputs.size(); ++i)
+    {
+        auto single = engine.Render(inputs[i]);
+
+        REQUIRE(batch[i]);
+        REQUIRE(batch[i]->data == single->data);
+    }
+}
+
+
+TEST_CASE("Rectifying an unrotated quad crops the image", "[warp]")
+{
+    tau::UniformRandom<int> uniformRandom{42};
+    uniformRandom.SetRange(0, 255);
+
+    draw::Gray<uint8_t> image(1080, 1920);
+
+    for (Eigen::Index i = 0; i < image.size(); ++i)
+    {
+        image.data()[i] = static_cast<uint8_t>(uniformRandom());
+    }
+
+    // The default quad is 300 x 200, centered at (960, 540).
+    draw::Quad quad;
+    draw::Size outputSize(300, 200);
+    draw::Gray<uint8_t> expected = image.block(440, 810, 200, 300);
+
+    auto interpolation = GENERATE(
+        draw::Interpolation::nearest,
+        draw::Interpolation::bilinear);
+
+    auto rectified = draw::Rectify(image, quad, outputSize, interpolation);
+
+    REQUIRE(rectified == expected);
+}
+
+
+TEST_CASE("Line clipper matches clipping each line", "[clip]")
+{
+    using Line = draw::LineClipper::Line;
+
+    std::vector<Line> lines;
+
+    // A grid with lines outside of the region, and two diagonals.
+    for (int i = -2; i < 12; ++i)
+    {
+        auto position = 10.0 * i;
+        lines.emplace_back(
+            tau::Point2d<double>(0.0, position),
+            tau::Vector2d<double>(1.0, 0.0));
+
+        lines.emplace_back(
+            tau::Point2d<double>(position, 0.0),
+            tau::Vector2d<double>(0.0, -2.0));
+    }
+
+    lines.emplace_back(
+        tau::Point2d<double>(0.0, 0.0),
+        tau::Vector2d<double>(1.0, 1.0));
+
+    lines.emplace_back(
+        tau::Point2d<double>(100.0, 0.0),
+        tau::Vector2d<double>(-1.0, 1.0));
+
+    auto region = tau::Region<double>{
+        {tau::Point2d<double>(0.0, 0.0), tau::Size<double>(100.0, 100.0)}};
+
+    draw::LineClipper clipper(lines);
+    draw::ClippedLines clipped;
+    clipper.Clip(region, &clipped);
+
+    REQUIRE(clipper.GetFamilyCount() == 4);
+
+    // 11 rows, 11 columns, and the diagonals.
+    REQUIRE(clipped.GetCount() == 24);
+
+    for (size_t i = 0; i < clipped.GetCount(); ++i)
+    {
+        auto length = std::hypot(
+            clipped.endX[i] - clipped.startX[i],
+            clipped.endY[i] - clipped.startY[i]);
+
+        bool isDiagonal = length > 101.0;
+
+        REQUIRE(length == Approx(isDiagonal ? 100.0 * std::sqrt(2.0) : 100.0));
+    }
+}
+
+
+TEST_CASE("Tessellated spline passes through its points", "[spline]")
+{
+    draw::PointsDouble points;
+
+    for (int i = 0; i < 50; ++i)
+    {
+        points.emplace_back(10.0 * i, 40.0 * std::sin(0.5 * i));
+    }
+
+    draw::SplineTessellator tessellator;
+    tessellator.SetPoints(points);
+
+    auto &coarse = tessellator.Get(1.0);
+
+    REQUIRE(coarse.GetSegmentCount() == points.size() - 1);
+
+    for (size_t i = 0; i < coarse.GetSegmentCount(); ++i)
+    {
+        auto segment = coarse.GetSegment(i);
+
+        REQUIRE(segment.front().x == Approx(points[i].x));
+        REQUIRE(segment.front().y == Approx(points[i].y));
+        REQUIRE(segment.back().x == Approx(points[i + 1].x));
+        REQUIRE(segment.back().y == Approx(points[i + 1].y));
+    }
+
+    // Tolerances are rounded down to a power of two.
+    REQUIRE(coarse.tolerance == 0.25);
+    auto coarseCount = coarse.points.size();
+
+    auto &fine = tessellator.Get(1.5);
+    REQUIRE(fine.tolerance == 0.125);
+    REQUIRE(fine.points.size() > coarseCount);
+
+    // Within the same power of two, nothing changes.
+    REQUIRE(tessellator.Get(1.9).tolerance == 0.125);
+}
+
+
+TEST_CASE("Label renderer culls and separates labels", "[label]")
+{
+    // Every glyph is a solid block, four pixels wide and six tall.
+    auto glyphCount = static_cast<int>(
+        draw::GlyphAtlas::lastCharacter - draw::GlyphAtlas::firstCharacter + 1);
+
+    draw::GlyphAtlas::Coverage coverage(6, 5 * glyphCount);
+    coverage.setConstant(255);
+
+    std::vector<draw::Glyph> glyphs;
+
+    for (int i = 0; i < glyphCount; ++i)
+    {
+        glyphs.push_back({5 * i, 0, 4, 6, 5});
+    }
+
+    draw::LabelRenderer renderer(
+        std::make_shared<const draw::GlyphAtlas>(coverage, glyphs, 6));
+
+    auto layout = renderer.GetLayout("abc");
+    REQUIRE(layout == renderer.GetLayout("abc"));
+    REQUIRE(layout->width == 15);
+    REQUIRE(layout->quads.size() == 3);
+
+    std::vector<draw::Label> labels{
+        {"abc", {10.0, 10.0}},
+        {"overlaps", {12.0, 12.0}},
+        {"outside", {500.0, 10.0}},
+        {"ok", {40.0, 10.0}}};
+
+    auto placed = renderer.Place(
+        labels,
+        tau::Region<double>{{tau::Point2d<double>(0, 0), {100.0, 50.0}}});
+
+    REQUIRE(placed.size() == 2);
+    REQUIRE(placed[0].x == 10);
+    REQUIRE(placed[1].x == 40);
+
+    auto pixels = draw::Pixels::CreateShared(draw::Size(100, 50));
+    draw::PixelsRasterTarget target(*pixels);
+    target.Clear();
+    renderer.Render(target, placed, {255.0, 255.0, 255.0});
+
+    // Five glyphs of 24 pixels, in three channels.
+    REQUIRE(pixels->data.template cast<int>().sum() == 5 * 24 * 3 * 255);
+}
+
+
+TEST_CASE("Ring views join at the wrap point", "[view]")
+{
+    auto ringWidth = 100;
+    auto offset = 30;
+
+    auto view = draw::MakeAlignedView(
+        tau::Point2d<int>(0, 0),
+        tau::Region<int>{{tau::Point2d<int>(0, 0), tau::Size<int>(250, 40)}},
+        tau::Size<int>(ringWidth, 16),
+        tau::Scale<double>(2.5, 2.5));
+
+    auto parts = draw::SplitRingView(view, ringWidth, offset);
+    REQUIRE(parts.size() == 2);
+
+    // The oldest columns are stored from the offset to the end of the ring.
+    REQUIRE(parts[0].source.topLeft.x == offset);
+    REQUIRE(parts[0].source.size.width == ringWidth - offset);
+    REQUIRE(parts[1].source.topLeft.x == 0);
+    REQUIRE(parts[1].source.size.width == offset);
+
+    // The targets cover the view without a gap.
+    REQUIRE(parts[0].target.topLeft.x == view.target.topLeft.x);
+
+    REQUIRE(
+        parts[0].target.GetBottomRight().x == parts[1].target.topLeft.x);
+
+    REQUIRE(
+        parts[1].target.GetBottomRight().x == view.target.GetBottomRight().x);
+
+    REQUIRE(parts[1].target.topLeft.x == 175);
+
+    for (auto &part: parts)
+    {
+        REQUIRE(part.source.topLeft.y == view.source.topLeft.y);
+        REQUIRE(part.target.size.height == view.target.size.height);
+    }
+
+    // A view of the newest columns is a single part.
+    auto newest = draw::MakeAlignedView(
+        tau::Point2d<int>(200, 0),
+        tau::Region<int>{{tau::Point2d<int>(0, 0), tau::Size<int>(50, 40)}},
+        tau::Size<int>(ringWidth, 16),
+        tau::Scale<double>(2.5, 2.5));
+
+    auto newestParts = draw::SplitRingView(newest, ringWidth, offset);
+    REQUIRE(newestParts.size() == 1);
+    REQUIRE(newestParts[0].source.topLeft.x == 80 - (ringWidth - offset));
+    REQUIRE(newestParts[0].target.topLeft == newest.target.topLeft);
+    REQUIRE(newestParts[0].target.size == newest.target.size);
+
+    REQUIRE(draw::SplitRingView(view, ringWidth, 0).size() == 1);
+}
+
+
+TEST_CASE("Streaming waveform keeps the most recent columns", "[waveform]")
+{
+    tau::UniformRandom<int32_t> uniformRandom{42};
+    uniformRandom.SetRange(0, 255);
+
+    draw::DataMatrix data(64, 173);
+
+    for (Eigen::Index i = 0; i < data.size(); ++i)
+    {
+        data.data()[i] = uniformRandom();
+    }
+
+    draw::WaveformSettings settings;
+    settings.columnCount = 50;
+
+    // Two columns of pixels for each column of the histogram.
+    draw::Size imageSize(100, 80);
+
+    draw::StreamingWaveform streaming(settings, imageSize, 2);
+
+    // The adaptive color maximum depends on the counts that were retired.
+    streaming.SetColorMaximum(6);
+
+    for (Eigen::Index column = 0; column < data.cols(); column += 3)
+    {
+        auto count = std::min(Eigen::Index{3}, data.cols() - column);
+        streaming.Append(data.middleCols(column, count));
+    }
+
+    REQUIRE(streaming.GetColumnCount() == 50);
+
+    // 87 histogram columns have been started, and the oldest 37 retired.
+    REQUIRE(streaming.GetOffset() == 74);
+
+    draw::StreamingWaveform window(settings, imageSize, 2);
+    window.SetColorMaximum(6);
+    window.Append(data.middleCols(74, 99));
+
+    REQUIRE(window.GetOffset() == 0);
+
+    auto unrolled = streaming.Unroll();
+    REQUIRE(unrolled->data == window.Unroll()->data);
+
+    // Drawing the views of the ring matches the unrolled copy.
+    auto views = streaming.GetViews();
+    REQUIRE(views.size() == 2);
+    REQUIRE(window.GetViews().size() == 1);
+
+    auto drawn = draw::Pixels::CreateShared(imageSize);
+    auto &ring = streaming.GetPixels();
+
+    for (auto &view: views)
+    {
+        for (auto row = 0; row < view.source.size.height; ++row)
+        {
+            auto sourceRow = view.source.topLeft.y + row;
+            auto targetRow = view.target.topLeft.y + row;
+
+            std::memcpy(
+                drawn->data.data()
+                    + 3 * (targetRow * imageSize.width + view.target.topLeft.x),
+                ring.data.data()
+                    + 3 * (sourceRow * imageSize.width + view.source.topLeft.x),
+                static_cast<size_t>(3 * view.source.size.width));
+        }
+    }
+
+    REQUIRE(drawn->data == unrolled->data);
+}
+
+
+TEST_CASE("Streaming waveform does not draw published rings", "[waveform]")
+{
+    tau::UniformRandom<int32_t> uniformRandom{7};
+    uniformRandom.SetRange(0, 255);
+
+    draw::DataMatrix data(32, 240);
+
+    for (Eigen::Index i = 0; i < data.size(); ++i)
+    {
+        data.data()[i] = uniformRandom();
+    }
+
+    draw::WaveformSettings settings;
+    settings.columnCount = 36;
+    draw::Size imageSize(72, 32);
+
+    draw::StreamingWaveform streaming(settings, imageSize);
+    draw::StreamingWaveform unshared(settings, imageSize);
+
+    // Rings held by the display, with a copy of their pixels when published.
+    std::vector<std::shared_ptr<draw::PixelRing>> held;
+    std::vector<draw::PixelMatrix> published;
+
+    for (Eigen::Index column = 0; column < data.cols(); column += 4)
+    {
+        streaming.Append(data.middleCols(column, 4));
+        unshared.Append(data.middleCols(column, 4));
+
+        REQUIRE(streaming.GetPixels().data == unshared.GetPixels().data);
+
+        for (size_t i = 0; i < held.size(); ++i)
+        {
+            REQUIRE(held[i]->pixels->data == published[i]);
+        }
+
+        // Hold from one to four rings, more than the spares.
+        auto holdCount = static_cast<size_t>((column / 4) % 4);
+
+        while (held.size() > holdCount)
+        {
+            held.erase(held.begin());
+            published.erase(published.begin());
+        }
+
+        auto ring = streaming.GetRing();
+        REQUIRE(ring->offset == streaming.GetOffset());
+        REQUIRE(ring->pixels.get() == &streaming.GetPixels());
+
+        held.push_back(ring);
+        published.push_back(ring->pixels->data);
+    }
+
+    REQUIRE(streaming.GetOffset() == 48);
+    REQUIRE(streaming.Unroll()->data == unshared.Unroll()->data);
+}
+
+
+TEST_CASE("Streaming waveform colors adapt with hysteresis", "[waveform]")
+{
+    draw::WaveformSettings settings;
+    settings.columnCount = 4;
+
+    draw::StreamingWaveform streaming(settings, draw::Size(8, 16));
+    REQUIRE(streaming.GetColorMaximum() == 0);
+
+    // Each column counts its rows at one level.
+    auto append = [&streaming](Eigen::Index count)
+    {
+        streaming.Append(draw::DataMatrix::Constant(count, 1, 100));
+
+        return streaming.GetColorMaximum();
+    };
+
+    REQUIRE(append(3) == 4);
+    REQUIRE(append(4) == 4);
+    REQUIRE(append(5) == 8);
+    REQUIRE(append(2) == 8);
+
+    // The oldest columns are retired, but the window still holds 5.
+    REQUIRE(append(1) == 8);
+    REQUIRE(append(1) == 8);
+
+    // The largest count falls to a quarter of the maximum.
+    REQUIRE(append(1) == 2);
+
+    streaming.SetColorMaximum(100);
+    REQUIRE(append(500) == 100);
+
+    streaming.SetColorMaximum(draw::StreamingWaveform::adaptiveColors);
+    REQUIRE(streaming.GetColorMaximum() == 512);
+
+    streaming.Reset();
+    REQUIRE(streaming.GetColorMaximum() == 0);
+}
+
+
+TEST_CASE("Waveform persistence decays previous frames", "[waveform]")
+{
+    // An odd width leaves pixels past the last group of eight.
+    draw::Waveform frame = draw::Waveform::Zero(4, 37);
+    frame(1, 3) = 10;
+    frame(2, 36) = 4;
+
+    draw::WaveformPersistence persistence(0.5f);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        persistence.Accumulate(frame);
+    }
+
+    // 10 + 5 + 2.5
+    auto &intensity = persistence.GetIntensity();
+    REQUIRE(intensity(1, 3) == Approx(17.5f));
+    REQUIRE(intensity(2, 36) == Approx(7.0f));
+    REQUIRE(intensity(0, 0) == 0.0f);
+
+    persistence.Accumulate(draw::Waveform::Zero(4, 37));
+    REQUIRE(intensity(1, 3) == Approx(8.75f));
+
+    draw::PixelMatrix output;
+    persistence.Render(draw::WaveformColor{}, &output);
+
+    REQUIRE(output.rows() == 4 * 37);
+    REQUIRE(output.row(1 * 37 + 3).template cast<int>().sum() > 0);
+    REQUIRE(output.row(0).template cast<int>().sum() == 0);
+
+    // A new size starts again.
+    persistence.Accumulate(draw::Waveform::Zero(5, 8));
+    REQUIRE(persistence.GetIntensity().maxCoeff() == 0.0f);
+}
+
+
+TEST_CASE("Parade matches a waveform of each channel", "[waveform]")
+{
+    tau::UniformRandom<int> uniformRandom{7};
+    uniformRandom.SetRange(0, 255);
+
+    auto pixels = draw::Pixels::CreateShared(draw::Size(333, 201));
+
+    for (Eigen::Index i = 0; i < pixels->data.size(); ++i)
+    {
+        pixels->data.data()[i] = static_cast<uint8_t>(uniformRandom());
+    }
+
+    size_t levelCount = GENERATE(64, 256);
+    size_t columnCount = 100;
+
+    auto histograms =
+        draw::GenerateParade(*pixels, levelCount, columnCount, true);
+
+    REQUIRE(histograms[3].rows() == static_cast<Eigen::Index>(levelCount));
+
+    for (Eigen::Index channel = 0; channel < 3; ++channel)
+    {
+        draw::DataMatrix data(201, 333);
+
+        for (Eigen::Index i = 0; i < data.size(); ++i)
+        {
+            data.data()[i] = pixels->data(i, channel);
+        }
+
+        auto expected =
+            draw::DoGenerateWaveform(data, 255, levelCount, columnCount);
+
+        REQUIRE(histograms[static_cast<size_t>(channel)] == expected);
+    }
+
+    draw::ParadeSettings settings;
+    settings.levelCount = levelCount;
+    settings.columnCount = columnCount;
+
+    auto parade = draw::RenderParade(*pixels, settings, draw::Size(300, 100));
+
+    REQUIRE(parade->data.rows() == 300 * 100);
+}
+
+
+TEST_CASE("Density counts points and vectorscope hues", "[density]")
+{
+    Eigen::VectorXf x(1000);
+    Eigen::VectorXf y(1000);
+
+    for (Eigen::Index i = 0; i < x.size(); ++i)
+    {
+        x(i) = static_cast<float>(i % 100) / 100.0f;
+        y(i) = 0.25f;
+    }
+
+    // A point outside of the range is not counted.
+    x(0) = 2.0f;
+
+    auto counts = draw::GenerateDensity(x, y, {0.0, 1.0, 0.0, 1.0}, 10);
+
+    REQUIRE(counts.sum() == 999);
+
+    // The highest y is in row zero.
+    REQUIRE(counts.row(7).sum() == 999);
+    REQUIRE(counts(7, 1) == 100);
+
+    auto pixels = draw::Pixels::CreateShared(draw::Size(4, 1));
+    pixels->data << 255, 0, 0, 0, 255, 0, 0, 0, 255, 128, 128, 128;
+
+    auto hues = draw::GenerateVectorscope(
+        *pixels,
+        draw::VectorscopeMode::hueSaturation,
+        6);
+
+    // Saturated red, green and blue at the top, and gray at the bottom left.
+    REQUIRE(hues(0, 0) == 1);
+    REQUIRE(hues(0, 2) == 1);
+    REQUIRE(hues(0, 4) == 1);
+    REQUIRE(hues(5, 0) == 1);
+
+    draw::DensitySettings settings;
+
+    auto image =
+        draw::RenderDensity(counts, settings, draw::Size(40, 40));
+
+    REQUIRE(image->data.rows() == 40 * 40);
+    REQUIRE(image->data.maxCoeff() > 0);
+}
+
+
+TEST_CASE("Integral image matches summing pixels in shapes", "[statistics]")
+{
+    auto seed = GENERATE(
+        take(4, random(tau::SeedLimits::min(), tau::SeedLimits::max())));
+
+    tau::UniformRandom<int> uniformRandom{seed};
+    uniformRandom.SetRange(0, 255);
+
+    draw::Gray<uint8_t> gray(97, 131);
+
+    for (Eigen::Index i = 0; i < gray.size(); ++i)
+    {
+        gray.data()[i] = static_cast<uint8_t>(uniformRandom());
+    }
+
+    draw::IntegralImage integral(gray);
+
+    // Sum the pixels with centers inside the shape, one at a time.
+    auto sumPixels = [&gray](auto &&contains)
+    {
+        draw::RegionStatistics result{0.0, {0.0}, {0.0}};
+
+        for (Eigen::Index row = 0; row < gray.rows(); ++row)
+        {
+            for (Eigen::Index column = 0; column < gray.cols(); ++column)
+            {
+                auto x = static_cast<double>(column) + 0.5;
+                auto y = static_cast<double>(row) + 0.5;
+
+                if (contains(x, y))
+                {
+                    auto value = static_cast<double>(gray(row, column));
+                    result.count += 1.0;
+                    result.sums[0] += value;
+                    result.sumsOfSquares[0] += value * value;
+                }
+            }
+        }
+
+        return result;
+    };
+
+    auto requireEqual = [](
+        const draw::RegionStatistics &statistics,
+        const draw::RegionStatistics &expected)
+    {
+        REQUIRE(expected.count > 0.0);
+        REQUIRE(statistics.count == expected.count);
+        REQUIRE(statistics.sums.at(0) == Approx(expected.sums[0]));
+
+        REQUIRE(
+            statistics.sumsOfSquares.at(0)
+            == Approx(expected.sumsOfSquares[0]));
+    };
+
+    requireEqual(
+        integral.GetBox(10, 5, 40, 60),
+        sumPixels(
+            [](double x, double y)
+            {
+                return x > 10.0 && x < 40.0 && y > 5.0 && y < 60.0;
+            }));
+
+    draw::PointsDouble polygon{
+        {10.3, 4.7},
+        {120.2, 30.1},
+        {40.6, 90.4},
+        {60.1, 40.2}};
+
+    requireEqual(
+        integral.GetPolygon(polygon),
+        sumPixels(
+            [&polygon](double x, double y)
+            {
+                return draw::oddeven::Contains(polygon, {x, y});
+            }));
+
+    draw::EllipseRegion ellipse{{60.3, 45.2}, 50.1, 20.7, 30.0};
+    auto angle = ellipse.rotation * tau::Angles<double>::pi / 180.0;
+
+    requireEqual(
+        integral.GetEllipse(ellipse),
+        sumPixels(
+            [&](double x, double y)
+            {
+                auto dx = x - ellipse.center.x;
+                auto dy = y - ellipse.center.y;
+                auto u = (dx * std::cos(angle) + dy * std::sin(angle))
+                    / ellipse.semiMajor;
+                auto v = (dy * std::cos(angle) - dx * std::sin(angle))
+                    / ellipse.semiMinor;
+
+                return u * u + v * v <= 1.0;
+            }));
+
+    // The next frame is built in the same tables.
+    for (Eigen::Index i = 0; i < gray.size(); ++i)
+    {
+        gray.data()[i] = static_cast<uint8_t>(255 - gray.data()[i]);
+    }
+
+    integral.Assign(gray);
+
+    requireEqual(
+        integral.GetPolygon(polygon),
+        draw::IntegralImage(gray).GetPolygon(polygon));
+
+    // A frame with other channels replaces the tables.
+    auto pixels = draw::Pixels::CreateShared(
+        tau::Size<draw::Pixels::Index>(31, 17));
+
+    pixels->data.setConstant(255);
+    integral.Assign(*pixels);
+
+    REQUIRE(integral.GetChannelCount() == 3);
+    REQUIRE(integral.GetSize().width == 31);
+    REQUIRE(integral.GetSize().height == 17);
+
+    auto whole = integral.GetBox(0, 0, 31, 17);
+    REQUIRE(whole.count == 31.0 * 17.0);
+    REQUIRE(whole.GetMean(2) == 255.0);
+    REQUIRE(whole.GetVariance(1) == 0.0);
+}
+
+
+TEST_CASE("Tile cache evicts the least recently used tiles", "[tile]")
+{
+    draw::TileCache<int> cache(300);
+
+    auto key = [](draw::SizeType column)
+    {
+        return draw::TileKey{0, column, 0};
+    };
+
+    cache.Insert(key(0), 0, 100);
+    cache.Insert(key(1), 1, 100);
+    cache.Insert(key(2), 2, 100);
+    REQUIRE(cache.GetCount() == 3);
+    REQUIRE(cache.GetByteCount() == 300);
+
+    // Finding a tile makes it the most recently used.
+    REQUIRE(*cache.Find(key(0)) == 0);
+
+    cache.Insert(key(3), 3, 100);
+    REQUIRE(cache.GetByteCount() == 300);
+    REQUIRE(cache.Contains(key(0)));
+    REQUIRE(!cache.Contains(key(1)));
+    REQUIRE(cache.Contains(key(2)));
+    REQUIRE(cache.Contains(key(3)));
+    REQUIRE(cache.Find(key(1)) == nullptr);
+
+    // Replacing a tile updates its size.
+    cache.Insert(key(2), 20, 50);
+    REQUIRE(cache.GetByteCount() == 250);
+    REQUIRE(*cache.Find(key(2)) == 20);
+
+    // Evicts 0 and 3, the least recently used, to fit.
+    cache.Insert(key(4), 4, 200);
+    REQUIRE(cache.GetByteCount() == 250);
+    REQUIRE(cache.GetCount() == 2);
+    REQUIRE(cache.Contains(key(2)));
+    REQUIRE(cache.Contains(key(4)));
+
+    // The newest tile is kept, even when it is larger than the budget.
+    cache.Insert(key(5), 5, 500);
+    REQUIRE(cache.GetCount() == 1);
+    REQUIRE(cache.GetByteCount() == 500);
+    REQUIRE(cache.Contains(key(5)));
+
+    cache.Erase(key(5));
+    REQUIRE(cache.GetCount() == 0);
+    REQUIRE(cache.GetByteCount() == 0);
+}
+
+
+namespace
+{
+
+
+/**
+ ** Records the order that tiles are loaded, and holds the loader on the
+ ** first tile until Release is called, so that requests can be queued.
+ **/
+class RecordingTiles
+{
+public:
+    RecordingTiles()
+        :
+        mutex_(),
+        loads_(),
+        failures_(),
+        release_(),
+        released_(release_.get_future().share())
+    {
+
+    }
+
+    std::shared_ptr<draw::TileSource> MakeSource()
+    {
+        return std::make_shared<draw::CallbackTileSource>(
+            draw::Size(64, 64),
+            2,
+            8,
+            [this](
+                const draw::TileKey &key,
+                const tau::Region<draw::SizeType> &region)
+            {
+                return this->Read_(key, region);
+            });
+    }
+
+    void Release()
+    {
+        this->release_.set_value();
+    }
+
+    // The tile fails to load once for each call.
+    void Fail(const draw::TileKey &key)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->failures_.push_back(key);
+    }
+
+    std::vector<draw::TileKey> GetLoads()
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        return this->loads_;
+    }
+
+private:
+    std::shared_ptr<draw::Pixels> Read_(
+        const draw::TileKey &key,
+        const tau::Region<draw::SizeType> &region)
+    {
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+            this->loads_.push_back(key);
+        }
+
+        this->released_.wait();
+
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        auto failure =
+            std::find(this->failures_.begin(), this->failures_.end(), key);
+
+        if (failure != this->failures_.end())
+        {
+            this->failures_.erase(failure);
+
+            throw std::runtime_error("Expected failure");
+        }
+
+        return draw::Pixels::CreateShared(region.size);
+    }
+
+    std::mutex mutex_;
+    std::vector<draw::TileKey> loads_;
+    std::vector<draw::TileKey> failures_;
+    std::promise<void> release_;
+    std::shared_future<void> released_;
+};
+
+
+// Collect loaded tiles until key arrives.
+void WaitForTile(draw::TileLoader &loader, const draw::TileKey &key)
+{
+    auto deadline =
+        std::chrono::steady_clock::now() + std::chrono::seconds(10);
+
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+        for (auto &loaded: loader.TakeLoaded())
+        {
+            if (loaded.key == key)
+            {
+                return;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    FAIL("Timed out waiting for a tile");
+}
+
+
+} // end anonymous namespace
+
+
+TEST_CASE("Tile loader loads the most urgent tiles first", "[tile]")
+{
+    RecordingTiles tiles;
+    draw::TileLoader loader(tiles.MakeSource(), []() {}, 1);
+
+    auto key = [](draw::SizeType column, draw::SizeType row)
+    {
+        return draw::TileKey{0, column, row};
+    };
+
+    // The worker waits on the first tile while the others are queued.
+    loader.Request({{key(0, 0), 0.0}});
+
+    while (tiles.GetLoads().empty())
+    {
+        std::this_thread::yield();
+    }
+
+    loader.Prefetch({{key(1, 2), 2.0}, {key(0, 2), 1.0}});
+    loader.Request({{key(3, 1), 0.0}});
+
+    // Replaces the queued requests, so key(3, 1) is never loaded.
+    loader.Request(
+        {{key(2, 1), 3.0}, {key(1, 1), 1.0}, {key(3, 0), 0.5}});
+
+    tiles.Release();
+    WaitForTile(loader, key(1, 2));
+
+    std::vector<draw::TileKey> expected{
+        key(0, 0),
+        key(3, 0),
+        key(1, 1),
+        key(2, 1),
+        key(0, 2),
+        key(1, 2)};
+
+    REQUIRE(tiles.GetLoads() == expected);
+}
+
+
+TEST_CASE("Tile loader retries failed tiles", "[tile]")
+{
+    RecordingTiles tiles;
+    tiles.Release();
+
+    auto failing = draw::TileKey{0, 2, 2};
+    tiles.Fail(failing);
+
+    auto other = [](draw::SizeType column)
+    {
+        return draw::TileKey{0, column, 0};
+    };
+
+    auto countLoads = [&tiles, &failing]()
+    {
+        auto loads = tiles.GetLoads();
+
+        return std::count(loads.begin(), loads.end(), failing);
+    };
+
+    SECTION("after the retry delay")
+    {
+        draw::TileLoader loader(
+            tiles.MakeSource(),
+            []() {},
+            1,
+            std::chrono::milliseconds(0));
+
+        // One worker loads in order, so the failure is recorded before the
+        // other tile arrives.
+        loader.Request({{failing, 0.0}, {other(0), 1.0}});
+        WaitForTile(loader, other(0));
+        REQUIRE(countLoads() == 1);
+
+        loader.Request({{failing, 0.0}});
+        WaitForTile(loader, failing);
+        REQUIRE(countLoads() == 2);
+    }
+
+    SECTION("when they are cleared or the level changes")
+    {
+        draw::TileLoader loader(
+            tiles.MakeSource(),
+            []() {},
+            1,
+            std::chrono::hours(1));
+
+        loader.Request({{failing, 0.0}, {other(0), 1.0}});
+        WaitForTile(loader, other(0));
+
+        // Failed tiles are skipped until the retry delay.
+        loader.Request({{failing, 0.0}, {other(1), 1.0}});
+        WaitForTile(loader, other(1));
+        REQUIRE(countLoads() == 1);
+
+        SECTION("cleared")
+        {
+            loader.ClearFailures();
+        }
+
+        SECTION("level changes")
+        {
+            auto coarser = draw::TileKey{1, 0, 0};
+            loader.Request({{coarser, 0.0}});
+            WaitForTile(loader, coarser);
+        }
+
+        tiles.Fail(failing);
+        loader.Request({{failing, 0.0}, {other(2), 1.0}});
+        WaitForTile(loader, other(2));
+        REQUIRE(countLoads() == 2);
+
+        // It failed again, and is skipped again.
+        loader.Request({{failing, 0.0}, {other(3), 1.0}});
+        WaitForTile(loader, other(3));
+        REQUIRE(countLoads() == 2);
+    }
+}
+
+
+TEST_CASE("Scroll predictor follows steady motion", "[scroll]")
+{
+    using namespace std::chrono_literals;
+
+    draw::ScrollPredictor predictor;
+    auto now = draw::ScrollPredictor::Clock::time_point{};
+    auto position = tau::Point2d<int>(0, 0);
+
+    REQUIRE(!predictor.Report(position, now));
+    REQUIRE(!predictor.IsMoving(now));
+
+    // 100 pixels right and 50 up every 10 milliseconds.
+    for (int i = 0; i < 20; ++i)
+    {
+        now += 10ms;
+        position = position + tau::Point2d<int>(100, -50);
+        REQUIRE(!predictor.Report(position, now));
+    }
+
+    auto velocity = predictor.GetVelocity();
+    REQUIRE(velocity.x == Approx(10000.0));
+    REQUIRE(velocity.y == Approx(-5000.0));
+    REQUIRE(predictor.IsMoving(now + 10ms));
+
+    auto offset = predictor.PredictOffset(0.1);
+    REQUIRE(offset.x == 1000);
+    REQUIRE(offset.y == -500);
+
+    SECTION("Reversing restarts the average")
+    {
+        now += 10ms;
+        position = position + tau::Point2d<int>(-20, 10);
+        REQUIRE(predictor.Report(position, now));
+
+        velocity = predictor.GetVelocity();
+        REQUIRE(velocity.x == Approx(-2000.0));
+        REQUIRE(velocity.y == Approx(1000.0));
+        REQUIRE(predictor.PredictOffset(0.1).x == -200);
+    }
+
+    SECTION("Stopping ends the gesture")
+    {
+        REQUIRE(!predictor.IsMoving(now + 300ms));
+
+        // The next gesture does not inherit the old velocity.
+        now += 500ms;
+        position = position + tau::Point2d<int>(0, 30);
+        REQUIRE(!predictor.Report(position, now));
+
+        velocity = predictor.GetVelocity();
+        REQUIRE(velocity.x == Approx(0.0));
+        REQUIRE(velocity.y == Approx(30.0));
+    }
+
+    SECTION("Reset forgets the motion")
+    {
+        predictor.Reset();
+        REQUIRE(!predictor.IsMoving(now));
+        REQUIRE(predictor.PredictOffset(1.0).x == 0);
+        REQUIRE(!predictor.Report(position, now + 10ms));
+    }
+}
+
+
+struct ScaleCounter
+{
+    ScaleCounter(const draw::ViewSettingsControl &control)
+        :
+        count(0),
+        scaleEndpoint_(this, control.scale, &ScaleCounter::OnScale_)
+    {
+
+    }
+
+    size_t count;
+
+private:
+    void OnScale_(const draw::Scale &)
+    {
+        ++this->count;
+    }
+
+    draw::ScaleEndpoint<ScaleCounter> scaleEndpoint_;
+};
+
+
+TEST_CASE("View link group applies a change to each view once", "[link]")
+{
+    std::vector<std::unique_ptr<draw::ViewSettingsModel>> models;
+    std::vector<draw::ViewSettingsControl> controls;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        models.push_back(std::make_unique<draw::ViewSettingsModel>());
+        controls.emplace_back(*models.back());
+
+        // Allow each axis to change on its own.
+        controls.back().linkZoom.Set(false);
+    }
+
+    draw::ViewLinkGroup group(controls);
+    REQUIRE(group.GetCount() == 3);
+
+    std::vector<std::unique_ptr<ScaleCounter>> counters;
+
+    for (auto &control: controls)
+    {
+        counters.push_back(std::make_unique<ScaleCounter>(control));
+    }
+
+    auto source = GENERATE(size_t{0}, size_t{1}, size_t{2});
+    auto scale = draw::Scale(2.0, 3.0);
+
+    controls.at(source).scale.Set(scale);
+
+    for (size_t i = 0; i < controls.size(); ++i)
+    {
+        // The views that were changed by the group did not echo the change
+        // back to the others, or to the source.
+        REQUIRE(counters.at(i)->count == 1);
+        REQUIRE(controls.at(i).scale.horizontal.Get() == 2.0);
+        REQUIRE(controls.at(i).scale.vertical.Get() == 3.0);
+    }
+}
+
+
+// Limits the horizontal scale of a view, as a view with a smaller image may.
+struct ScaleClamp
+{
+    ScaleClamp(const draw::ViewSettingsControl &control, double maximum_)
+        :
+        maximum(maximum_),
+        control_(control),
+        scaleEndpoint_(this, control.scale, &ScaleClamp::OnScale_)
+    {
+
+    }
+
+    double maximum;
+
+private:
+    void OnScale_(const draw::Scale &scale)
+    {
+        if (scale.horizontal > this->maximum)
+        {
+            this->control_.scale.horizontal.Set(this->maximum);
+        }
+    }
+
+    draw::ViewSettingsControl control_;
+    draw::ScaleEndpoint<ScaleClamp> scaleEndpoint_;
+};
+
+
+TEST_CASE("View link group applies a clamped change to every view", "[link]")
+{
+    std::vector<std::unique_ptr<draw::ViewSettingsModel>> models;
+    std::vector<draw::ViewSettingsControl> controls;
+
+    for (int i = 0; i < 3; ++i)
+    {
+        models.push_back(std::make_unique<draw::ViewSettingsModel>());
+        controls.emplace_back(*models.back());
+        controls.back().linkZoom.Set(false);
+    }
+
+    draw::ViewLinkGroup group(controls);
+    ScaleClamp clamp(controls.at(2), 2.5);
+
+    auto source = GENERATE(size_t{0}, size_t{1});
+
+    controls.at(source).scale.Set(draw::Scale(3.0, 3.0));
+
+    for (auto &control: controls)
+    {
+        REQUIRE(control.scale.horizontal.Get() == 2.5);
+        REQUIRE(control.scale.vertical.Get() == 3.0);
+    }
+}